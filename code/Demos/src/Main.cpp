@@ -370,6 +370,7 @@ struct FontLogic {
 
         Renderer::FontBatchRenderer::BatchConfig config {
             .resource_manager = data.resource_manager,
+            .render_queue = renderer.render_queue,
             .screen_dimensions = glm::vec2 { renderer.window_width, renderer.window_height },
             .font_colour = { 0, 0, 0, 1 },
         };
@@ -399,6 +400,30 @@ struct FontLogic {
 };
 
 #else
+// The teapots behind the instanced pair, drawn by a ResidentBatchDrawer in one batch.
+constexpr static std::string_view RESIDENT_VERT =
+    RENDERER_BATCH_DRAW_INDEX_GLSL
+    "precision highp float;\n"
+    "layout(location = 0) in vec3 l_pos;\n"
+    "layout(location = 1) in vec3 l_norm;\n"
+    "layout(location = 2) in vec2 l_uv;\n"
+    "uniform highp sampler2D u_model_transforms;\n"
+    "out vec3 norm;\n"
+    CORE_TRANSFORM_TEXTURE_GLSL
+    RENDERER_CAMERA_BLOCK_GLSL
+    "void main() {\n"
+    "    mat4 m = fetch_transform(u_model_transforms, BATCH_DRAW_INDEX);\n"
+    "    gl_Position = u_view_proj * m * vec4(l_pos, 1);\n"
+    "    norm = mat3(m) * l_norm;\n"
+    "}";
+constexpr static std::string_view RESIDENT_FRAG =
+    "precision highp float;\n"
+    "in vec3 norm;\n"
+    "out vec4 FragColor;\n"
+    "void main() {\n"
+    "    FragColor = vec4(normalize(norm) * 0.5 + 0.5, 1);\n"
+    "}";
+
 struct IsoData {
     std::chrono::steady_clock::time_point start_time;
     glm::vec4 background_colour = { 1, 1, 0, 1 };
@@ -410,6 +435,12 @@ struct IsoData {
 
     Renderer::ResourceManager resource_manager;
     Renderer::InstanceRenderer instance_renderer;
+    Renderer::FrameUniforms frame_uniforms;
+
+    Renderer::ResidentBatchDrawer resident_drawer;
+    Renderer::ResidentBatchDrawer::MeshHandle resident_teapot;
+    Renderer::ResourceHandle<Core::Shader> resident_shader;
+    std::vector<Renderer::ResidentBatchDrawer::Draw> resident_draws;
 
     std::optional<Renderer::FontBatchRenderer> font_batch_renderer;
 
@@ -477,7 +508,14 @@ struct IsoLogic {
                                              .on_error_panic()
                                              .value_move());
 
+        data.frame_uniforms.init(data.resource_manager);
         data.instance_renderer.init(data.resource_manager, model, image);
+
+        data.resident_drawer.init(data.resource_manager);
+        data.resident_teapot = data.resident_drawer.add_mesh(model);
+        auto [resident_shader_handle, resident_shader] = data.resource_manager.create_and_init_resource<Core::Shader>(RESIDENT_VERT, RESIDENT_FRAG);
+        resident_shader.bind_uniform_block(Renderer::FrameUniforms::CAMERA_BLOCK, Renderer::FrameUniforms::CAMERA_BINDING).on_error(print_then_quit);
+        data.resident_shader = resident_shader_handle;
         data.source_handle = audio.play_sound(data.sound_buffer, { 5, 0, 0 }).on_error(print_then_quit).value();
 
         scheduler.wait_for_threads();
@@ -515,6 +553,13 @@ struct IsoLogic {
         t.position = glm::vec3(0, -1, 2);
         model = t.calc_transform_mat();
         data.instance_renderer.push_instance(model);
+
+        data.resident_draws.clear();
+        t.scale = glm::vec3(0.25f);
+        for (int i = -2; i <= 2; ++i) {
+            t.position = glm::vec3(i, -1, 3);
+            data.resident_draws.push_back({ .mesh = data.resident_teapot, .transform = t.calc_transform_mat() });
+        }
     }
 
     void draw(AppRenderer& renderer, IsoData& data) {
@@ -524,9 +569,16 @@ struct IsoLogic {
 
         auto v = data.camera.view_matrix();
         auto p = data.camera.projection_matrix(renderer.window_width, renderer.window_height);
-        data.instance_renderer.draw_instances(data.resource_manager, v, p);
+        data.frame_uniforms.set_camera(data.resource_manager, p, v, data.camera.position);
+        renderer.render_queue.set_view(v);
+        const auto frustum = Renderer::Frustum::from_view_projection(Cameras::get_mvp(p, v));
+        data.instance_renderer.draw_instances(data.resource_manager, renderer.render_queue, frustum);
+
+        auto& resident_shader = data.resource_manager.get_resource(data.resident_shader);
+        data.resident_drawer.draw(data.resource_manager, renderer.render_queue, resident_shader, data.resident_draws);
     }
     void stop(IsoData& data) {
+        data.resident_drawer.stop(data.resource_manager);
     }
 };
 
@@ -11,6 +11,8 @@
 
 #include "Cameras/Cameras.hpp"
 #include "Core/Core.hpp"
+#include "Profiler/EngineCounters.hpp"
+#include "Profiler/GpuProfiler.hpp"
 #include "Profiler/Profiler.hpp"
 
 #include "Core/Input.hpp"
@@ -67,16 +69,17 @@ private:
 public:
     auto init(std::string_view app_name, uint_fast16_t width, uint_fast16_t height) -> void {
         Profiler::instance().switch_to_process(Utily::Reflection::get_type_name<AppLogic>());
-        Profiler::Timer timer("App::init()", { "App" });
+        PROFILER_ZONE("App::init()", "App");
 
         _context.init(app_name, width, height).on_error(Utily::ErrorHandler::print_then_quit);
+        GpuProfiler::instance().init();
         _input.init(_context.unsafe_window_handle());
 
         _audio.init().on_error(panic);
         _ecs = entt::registry {};
 
         {
-            Profiler::Timer timer2("Logic::init()");
+            PROFILER_ZONE("Logic::init()");
             _logic.init(_renderer, _audio, _data);
         }
 
@@ -88,32 +91,41 @@ public:
             _logic.stop(_data);
             _renderer.stop();
             _audio.stop();
+            GpuProfiler::instance().stop();
             _context.stop();
         }
         _has_stopped = true;
     }
     auto update() -> void {
-        Profiler::Timer timer("App::update()", { "App" });
+        PROFILER_ZONE("App::update()", "App");
         double dt = std::chrono::duration<double> { std::chrono::high_resolution_clock::now() - _last_update }.count();
         {
-            Profiler::Timer timer2("Logic::update()");
+            PROFILER_ZONE("Logic::update()");
             _logic.update(dt, _input, _audio, _state, _data);
         }
+        EngineCounters::active_audio_sources().record(static_cast<int64_t>(_audio.num_active_sources()));
         _last_update = std::chrono::high_resolution_clock::now();
     }
     auto render() -> void {
-        Profiler::Timer timer("App::render()", { "App" });
+        PROFILER_ZONE("App::render()", "App");
         _renderer.window_width = _context.window_width;
         _renderer.window_height = _context.window_height;
 
+        // Uploads etc. queued by worker threads, before drawing so they're usable this frame.
+        Core::GlCommandQueue::instance().drain(std::chrono::microseconds(Config::GL_COMMAND_BUDGET_US));
+
         {
-            Profiler::Timer timer2("Logic::draw()");
+            PROFILER_ZONE("Logic::draw()");
+            PROFILER_GPU_ZONE("Logic::draw() (GPU)");
             _logic.draw(_renderer, _data);
+            _renderer.render_queue.submit();
         }
         _context.swap_buffers();
+        Core::StreamRing::end_frame();
+        GpuProfiler::instance().end_frame();
     }
     auto poll_events() -> void {
-        Profiler::Timer timer("App::poll_events()", { "App" });
+        PROFILER_ZONE("App::poll_events()", "App");
         this->_context.poll_events();
     }
     auto is_running() -> bool {
@@ -124,18 +136,54 @@ public:
     }
 };
 
+// Closes the profiler's frame, the flight recorder dumps the last few seconds if it was over budget.
+inline void mark_app_frame(std::chrono::steady_clock::time_point frame_start) {
+    const auto frame_time = std::chrono::steady_clock::now() - frame_start;
+    if (auto dump_path = Profiler::instance().mark_frame(frame_time); dump_path) {
+        std::cerr << std::format(
+            "Frame took {:.2f}ms, over the {}us budget. Flight recorder dumped to \"{}\"\n",
+            std::chrono::duration<double, std::milli>(frame_time).count(),
+            Config::FLIGHT_RECORDER_FRAME_BUDGET_US,
+            dump_path->string());
+    }
+}
+
 template <typename Data, typename Logic>
 void auto_run_app(std::string_view app_name = "Auto Running App", uint16_t width = 400, uint16_t height = 400) {
     static App<Data, Logic> app;
+
+    if constexpr (Config::ENABLE_FLIGHT_RECORDER) {
+        // Already on if an earlier app started it.
+        if (!Profiler::instance().is_flight_recording()) {
+            Profiler::instance()
+                .start_flight_recorder(Profiler::FlightRecorderSettings {
+                    .window = std::chrono::milliseconds(Config::FLIGHT_RECORDER_WINDOW_MS),
+                    .frame_budget = std::chrono::microseconds(Config::FLIGHT_RECORDER_FRAME_BUDGET_US),
+                    .dump_cooldown = std::chrono::milliseconds(Config::FLIGHT_RECORDER_WINDOW_MS),
+                    .max_events = Config::FLIGHT_RECORDER_MAX_EVENTS,
+                    .dump_directory = ".",
+                })
+                .on_error(Utily::ErrorHandler::print_then_quit);
+        }
+    }
+
+    if constexpr (Config::PROFILER_STATS_FRAMES > 0) {
+        Profiler::instance().start_zone_stats(Config::PROFILER_STATS_FRAMES);
+    }
+
     app.init(app_name, width, height);
 
 #if defined(CONFIG_TARGET_NATIVE)
     {
         while (app.is_running()) {
-            Profiler::Timer timer("App::main_loop()");
-            app.poll_events();
-            app.update();
-            app.render();
+            const auto frame_start = std::chrono::steady_clock::now();
+            {
+                PROFILER_ZONE("App::main_loop()");
+                app.poll_events();
+                app.update();
+                app.render();
+            }
+            mark_app_frame(frame_start);
         }
     }
     app.stop();
@@ -145,9 +193,11 @@ void auto_run_app(std::string_view app_name = "Auto Running App", uint16_t width
             if (!app.is_running()) {
                 emscripten_cancel_main_loop();
             }
+            const auto frame_start = std::chrono::steady_clock::now();
             app.poll_events();
             app.update();
             app.render();
+            mark_app_frame(frame_start);
         },
         0,
         0);
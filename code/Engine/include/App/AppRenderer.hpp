@@ -3,6 +3,7 @@
 #include <Utily/Utily.hpp>
 
 #include "Core/Core.hpp"
+#include "Renderer/RenderQueue.hpp"
 
 class AppRenderer
 {
@@ -31,6 +32,8 @@ public:
     Utily::StaticVector<Core::Texture, 100> textures;
 
     Core::ScreenFrameBuffer screen_frame_buffer;
+    // Submitted by the App after Logic::draw().
+    Renderer::RenderQueue render_queue;
 
     float window_width;
     float window_height;
@@ -10,10 +10,10 @@
 
 namespace Cameras {
     // Literally because i forget the order.
-    auto get_mvp(const glm::mat4& projection, const glm::mat4& view, const glm::mat4& model) -> glm::mat4 {
+    inline auto get_mvp(const glm::mat4& projection, const glm::mat4& view, const glm::mat4& model) -> glm::mat4 {
         return projection * view * model;
     }
-    auto get_mvp(const glm::mat4& projection, const glm::mat4& view) -> glm::mat4 {
+    inline auto get_mvp(const glm::mat4& projection, const glm::mat4& view) -> glm::mat4 {
         return projection * view;
     }
 
@@ -2,6 +2,13 @@
 
 #include <cstdint>
 
+// 1 == replace the global operator new/delete so every allocation is counted against the innermost profiler zone
+// on its thread, see Profiler::allocation_stats(). Every allocation in the process pays for it, so it's opt-in,
+// with cmake -DCONFIG_TRACK_ALLOCATIONS=ON
+#if !defined(CONFIG_TRACK_ALLOCATIONS)
+#define CONFIG_TRACK_ALLOCATIONS 0
+#endif
+
 namespace Config {
     enum class DebugInfo : uint_fast8_t {
         none,
@@ -29,9 +36,27 @@ namespace Config {
     // false == ensure the gpu texture is reading valid cpu image data. Enables fencing as default.
     constexpr static bool SKIP_IMAGE_TEXTURE_FENCING = false;
     
-    constexpr static bool SKIP_PROFILE = false;
+    // Whether the profiler records from the start. Can be toggled at runtime, globally or per category,
+    // with Profiler::instance().set_enabled() / set_category_enabled().
+    constexpr static bool PROFILE_ON_STARTUP = true;
 
     constexpr static bool ENABLE_VSYNC = false;
+
+    // How long App::render() spends per frame running GL commands queued by other threads (uploads etc).
+    constexpr static uint32_t GL_COMMAND_BUDGET_US = 2000;
+
+    // auto_run_app() keeps only the last FLIGHT_RECORDER_WINDOW_MS of profiling in a fixed size ring, and dumps it
+    // to flight_recorder_<n>.gtrace whenever a frame takes longer than FLIGHT_RECORDER_FRAME_BUDGET_US.
+    // false == record everything until exit.
+    constexpr static bool ENABLE_FLIGHT_RECORDER = false;
+    constexpr static uint32_t FLIGHT_RECORDER_WINDOW_MS = 5000;
+    constexpr static uint32_t FLIGHT_RECORDER_FRAME_BUDGET_US = 50'000;
+    constexpr static uint32_t FLIGHT_RECORDER_MAX_EVENTS = 1 << 18;
+
+    // auto_run_app() keeps per-zone histograms over this many frames, see Profiler::zone_stats(). 0 == off.
+    constexpr static uint32_t PROFILER_STATS_FRAMES = 120;
+
+    constexpr static bool TRACK_ALLOCATIONS = CONFIG_TRACK_ALLOCATIONS != 0;
 }
 
 
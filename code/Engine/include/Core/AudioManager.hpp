@@ -38,6 +38,9 @@ namespace Core {
         [[nodiscard]] auto set_source_motion(SourceHandle source_handle, glm::vec3 pos = { 0, 0, 0 }, glm::vec3 vel = { 0, 0, 0 }) -> Utily::Result<void, Utily::Error>;
         void set_listener_properties(const ListenerProperties& listener_properties);
 
+        // Sources that are still expected to be playing, going by the length of their sound.
+        [[nodiscard]] auto num_active_sources() const -> size_t;
+
     private:
         constexpr static size_t MAX_BUFFERS = 1024;
         constexpr static size_t MAX_SOURCES = 256;
@@ -6,12 +6,20 @@ namespace Core {
     class OpenglContext;
     class Shader;
     class Texture;
+    class TransformTexture;
     class VertexArray;
     class VertexBuffer;
+    class UniformBuffer;
+    class StreamRing;
     class FrameBuffer;
     class ScreenFrameBuffer;
     class AudioManager;
     class Scheduler;
+    class TaskGraph;
+    class GlCommandQueue;
+    class GlState;
+    template <typename T>
+    class Task;
 }
 
 #include "IndexBuffer.hpp"
@@ -19,9 +27,17 @@ namespace Core {
 #include "OpenglContext.hpp"
 #include "Shader.hpp"
 #include "Texture.hpp"
+#include "TransformTexture.hpp"
 #include "VertexArray.hpp"
 #include "VertexBuffer.hpp"
 #include "VertexBufferLayout.hpp"
+#include "Std140.hpp"
+#include "UniformBuffer.hpp"
+#include "StreamRing.hpp"
 #include "FrameBuffer.hpp"
 #include "AudioManager.hpp"
-#include "Scheduler.hpp"
\ No newline at end of file
+#include "GlCommandQueue.hpp"
+#include "GlState.hpp"
+#include "Scheduler.hpp"
+#include "TaskGraph.hpp"
+#include "Task.hpp"
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include "Core/InlineTask.hpp"
+
+namespace Core {
+
+    // GL calls have to happen on the thread that owns the OpenglContext. Workers push the GL half of their job
+    // here (texture upload, buffer creation, ...) and App::render() drains it with a time budget.
+    // Multi-producer single-consumer: pushing is a single atomic exchange, popping is only done by the GL thread.
+    class GlCommandQueue
+    {
+    public:
+        using Command = InlineTask;
+
+        static auto instance() -> GlCommandQueue& {
+            static GlCommandQueue queue {};
+            return queue;
+        }
+
+        // Can be called from any thread.
+        void push(Command command);
+
+        // GL thread only. Runs commands until the queue is empty or the budget is used up, the rest wait for the
+        // next call. Commands aren't interrupted, so the last one can run over. Returns how many were run.
+        auto drain(std::chrono::nanoseconds budget) -> size_t;
+        auto drain_all() -> size_t;
+
+        // GL thread only.
+        [[nodiscard]] auto is_empty() const noexcept -> bool {
+            return _tail->next.load(std::memory_order_acquire) == nullptr;
+        }
+
+        GlCommandQueue(const GlCommandQueue&) = delete;
+        GlCommandQueue(GlCommandQueue&&) = delete;
+        ~GlCommandQueue();
+
+    private:
+        GlCommandQueue();
+
+        // The tail is always a spent node, the next command lives in tail->next.
+        struct Node {
+            std::atomic<Node*> next = nullptr;
+            Command command;
+        };
+
+        alignas(64) std::atomic<Node*> _head;
+        alignas(64) Node* _tail;
+
+        auto try_run_one() -> bool;
+    };
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <Utily/Utily.hpp>
+
+#include "Core/TextureUnitLru.hpp"
+
+namespace Core {
+
+    // Shadows the GL state the engine changes, so setting what's already set is a compare rather than a driver call.
+    // Redundant calls are counted (and shown on the "Redundant GL calls" counter) to keep an eye on the savings.
+    // GL thread only. Everything that binds or enables goes through here, code that doesn't has to reset() after.
+    class GlState
+    {
+    public:
+        static auto instance() -> GlState& {
+            static GlState state {};
+            return state;
+        }
+
+        // Forgets everything, so the next call of each kind goes to the driver. Called once the context is made.
+        void reset() noexcept;
+
+        void use_program(uint32_t program) noexcept;
+        void bind_vertex_array(uint32_t vertex_array) noexcept;
+        // GL_ELEMENT_ARRAY_BUFFER is part of the vertex array's state, so it's shadowed per vertex array.
+        // Targets that aren't shadowed go straight through.
+        void bind_buffer(uint32_t target, uint32_t buffer) noexcept;
+        // glBindBufferBase, which also binds the buffer to `target` itself.
+        void bind_buffer_base(uint32_t target, uint32_t index, uint32_t buffer) noexcept;
+        void bind_framebuffer(uint32_t framebuffer) noexcept;
+        void active_texture(uint32_t unit) noexcept;
+        void set_enabled(uint32_t capability, bool is_enabled) noexcept; // GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST
+        void blend_func(uint32_t source, uint32_t destination) noexcept;
+        void depth_func(uint32_t func) noexcept;
+        void viewport(int32_t x, int32_t y, int32_t width, int32_t height) noexcept;
+
+        // Binds a 2D texture to a unit and makes that unit active. The unit it had last time (`hint`) is reused if
+        // it still has it, otherwise it gets the least recently used unlocked unit. `is_locked` adds a lock, and a
+        // locked unit isn't handed to anything else until each lock is unlocked or it's released. See TextureUnitLru.
+        auto acquire_texture_unit(uint32_t texture, std::optional<uint32_t> hint, bool is_locked) noexcept
+            -> Utily::Result<uint32_t, Utily::Error>;
+        // Drops one lock.
+        void unlock_texture_unit(uint32_t texture, uint32_t unit) noexcept;
+        void release_texture_unit(uint32_t texture, uint32_t unit) noexcept;
+
+        // For glDelete*, so a recycled name isn't mistaken for the one that's still bound.
+        void forget_program(uint32_t program) noexcept;
+        void forget_vertex_array(uint32_t vertex_array) noexcept;
+        void forget_buffer(uint32_t buffer) noexcept;
+        void forget_framebuffer(uint32_t framebuffer) noexcept;
+
+        struct Stats {
+            uint64_t num_calls;
+            uint64_t num_redundant_calls;
+        };
+        [[nodiscard]] auto stats() const noexcept -> Stats { return _stats; }
+
+        GlState(const GlState&) = delete;
+        GlState(GlState&&) = delete;
+
+    private:
+        GlState();
+
+        constexpr static uint32_t UNKNOWN = UINT32_MAX;
+        // GL guarantees at least 24 (ES 3.0) uniform buffer binding points, only the first few are shadowed.
+        constexpr static size_t NUM_UNIFORM_BINDINGS = 16;
+
+        enum class BufferSlot : uint8_t {
+            array,
+            uniform,
+            texture,
+            count,
+        };
+
+        uint32_t _program = UNKNOWN;
+        uint32_t _vertex_array = UNKNOWN;
+        std::vector<uint32_t> _element_buffers; // by vertex array name.
+        std::array<uint32_t, static_cast<size_t>(BufferSlot::count)> _buffers;
+        std::array<uint32_t, NUM_UNIFORM_BINDINGS> _uniform_bindings;
+        uint32_t _framebuffer = UNKNOWN;
+        uint32_t _active_texture = UNKNOWN;
+        std::array<uint8_t, 3> _capabilities; // 0/1, or 2 for unknown.
+        std::array<uint32_t, 2> _blend_func;
+        uint32_t _depth_func = UNKNOWN;
+        std::array<int32_t, 4> _viewport;
+
+        TextureUnitLru _texture_units; // sized on first use, needs the context.
+        int64_t _num_texture_units_in_use = 0;
+
+        Stats _stats = {};
+
+        // true if `value` differs from the shadow (which is then updated), and the call has to be made.
+        template <typename T>
+        auto is_change(T& shadow, const T& value) noexcept -> bool;
+        auto element_buffer_slot() noexcept -> uint32_t*;
+        auto buffer_slot(uint32_t target) noexcept -> uint32_t*;
+        void init_texture_units() noexcept;
+    };
+}
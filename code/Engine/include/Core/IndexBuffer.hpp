@@ -4,8 +4,13 @@
 
 #include "Config.hpp"
 #include "Model/Types.hpp"
+#include "Profiler/EngineCounters.hpp"
 #include "Profiler/Profiler.hpp"
 #include "Core/DebugOpRecorder.hpp"
+#include "Core/StreamRing.hpp"
+
+#include <optional>
+#include <span>
 
 
 namespace Core {
@@ -17,6 +22,8 @@ namespace Core {
         IndexBuffer(IndexBuffer&& other) noexcept;
 
         [[nodiscard]] auto init() noexcept -> Utily::Result<void, Utily::Error>;
+        // See VertexBuffer::init(Streaming). Draw from get_offset().
+        [[nodiscard]] auto init(Streaming streaming) noexcept -> Utily::Result<void, Utily::Error>;
         void stop() noexcept;
 
         void bind() noexcept;
@@ -29,18 +36,27 @@ namespace Core {
             && std::ranges::sized_range<Range>
         void load_indices(const Range& indices) noexcept {
             Core::DebugOpRecorder::instance().push("Core::IndexBuffer", "load_indices()");
-            Profiler::Timer timer("Core::IndexBuffer::load_indices", { "rendering" });
+            PROFILER_ZONE("Core::IndexBuffer::load_indices", "rendering");
             
             this->bind();
+            _count = indices.size();
+            if (_stream) {
+                _offset = _stream->write(GL_ELEMENT_ARRAY_BUFFER, std::as_bytes(std::span { std::ranges::data(indices), std::ranges::size(indices) }));
+                return;
+            }
             size_t size_in_bytes = indices.size() * sizeof(Model::Index);
+            EngineCounters::bytes_uploaded().add(static_cast<int64_t>(size_in_bytes));
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, size_in_bytes, &(*indices.begin()), GL_DYNAMIC_DRAW);
-            _count = indices.size();
         }
 
         size_t get_count() const noexcept { return _count; }
+        // In bytes, for the `indices` argument of glDrawElements. Always 0 unless streaming.
+        size_t get_offset() const noexcept { return _offset; }
 
     private:
         std::optional<uint32_t> _id = std::nullopt;
+        std::optional<StreamRing> _stream = std::nullopt;
         size_t _count;
+        size_t _offset = 0;
     };
 }
\ No newline at end of file
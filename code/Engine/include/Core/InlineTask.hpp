@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace Core {
+
+    // A move-only void() callable that stores its captures inline, never on the heap.
+    // Anything that doesn't fit is a compile error, capture a pointer to the data instead.
+    class InlineTask
+    {
+    public:
+        constexpr static size_t CAPACITY = 48;
+        constexpr static size_t ALIGNMENT = alignof(std::max_align_t);
+
+        InlineTask() = default;
+        InlineTask(const InlineTask&) = delete;
+
+        template <typename Fn>
+            requires(!std::same_as<std::remove_cvref_t<Fn>, InlineTask> && std::invocable<std::decay_t<Fn>&>)
+        InlineTask(Fn&& fn) noexcept(std::is_nothrow_constructible_v<std::decay_t<Fn>, Fn&&>) {
+            using Callable = std::decay_t<Fn>;
+            static_assert(sizeof(Callable) <= CAPACITY, "Captures too large for an InlineTask, capture by pointer instead.");
+            static_assert(alignof(Callable) <= ALIGNMENT, "Captures are over-aligned for an InlineTask.");
+            static_assert(std::is_nothrow_move_constructible_v<Callable>, "InlineTask captures must be nothrow movable.");
+
+            std::construct_at(reinterpret_cast<Callable*>(_storage.data()), std::forward<Fn>(fn));
+            _ops = &OPS<Callable>;
+        }
+
+        InlineTask(InlineTask&& other) noexcept
+            : _ops(std::exchange(other._ops, nullptr)) {
+            if (_ops) {
+                _ops->relocate(_storage.data(), other._storage.data());
+            }
+        }
+
+        auto operator=(InlineTask&& other) noexcept -> InlineTask& {
+            if (this != &other) {
+                reset();
+                _ops = std::exchange(other._ops, nullptr);
+                if (_ops) {
+                    _ops->relocate(_storage.data(), other._storage.data());
+                }
+            }
+            return *this;
+        }
+
+        void operator()() {
+            _ops->invoke(_storage.data());
+        }
+
+        explicit operator bool() const noexcept { return _ops != nullptr; }
+
+        void reset() noexcept {
+            if (_ops) {
+                _ops->destroy(_storage.data());
+                _ops = nullptr;
+            }
+        }
+
+        ~InlineTask() {
+            reset();
+        }
+
+    private:
+        struct Ops {
+            void (*invoke)(std::byte*);
+            void (*relocate)(std::byte* dst, std::byte* src) noexcept; // move construct into dst, destroy src.
+            void (*destroy)(std::byte*) noexcept;
+        };
+
+        template <typename Callable>
+        constexpr static Ops OPS = {
+            .invoke = [](std::byte* storage) {
+                (*std::launder(reinterpret_cast<Callable*>(storage)))();
+            },
+            .relocate = [](std::byte* dst, std::byte* src) noexcept {
+                auto* from = std::launder(reinterpret_cast<Callable*>(src));
+                std::construct_at(reinterpret_cast<Callable*>(dst), std::move(*from));
+                std::destroy_at(from);
+            },
+            .destroy = [](std::byte* storage) noexcept {
+                std::destroy_at(std::launder(reinterpret_cast<Callable*>(storage)));
+            },
+        };
+
+        alignas(ALIGNMENT) std::array<std::byte, CAPACITY> _storage;
+        const Ops* _ops = nullptr;
+    };
+
+    static_assert(sizeof(InlineTask) == 64, "InlineTask should be exactly one cache line.");
+}
@@ -1,135 +1,195 @@
-#include <algorithm>
+#pragma once
+
 #include <array>
-#include <bit>
-#include <functional>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
-#include <stdexcept>
+#include <ranges>
 #include <thread>
-#include <variant>
 #include <vector>
 
 #include "Config.hpp"
+#include "Core/InlineTask.hpp"
 
 namespace Core {
 
     class Scheduler
     {
     public:
-        using SimpleFunctionPtr = void (*)();
-        using Task = std::variant<SimpleFunctionPtr, std::function<void()>>;
-
-        static auto create(size_t num_threads = std::thread::hardware_concurrency())
-            -> std::optional<Scheduler> {
-            if (OptAtomicSize temp = 1; !temp.value().is_lock_free()) {
-                throw std::runtime_error(
-                    "This has lock, as such it cannot be moved. Therefore the move "
-                    "semantics workaround is invalidated.");
-            }
-            if constexpr (Config::PLATFORM == Config::TargetPlatform::web) {
-                num_threads = 0;
-            }
-
-            return Scheduler(M {
-                .tasks = {},
-                .threads = {},
-                .num_threads = num_threads,
-                .current_task_buffer = null_opt_atomic(),
+        using Task = InlineTask;
+
+        // Workers always drain the higher lanes first. Background tasks are only started before the frame
+        // deadline, so a long decode can't push the frame's critical path past its budget.
+        enum class Priority : uint8_t {
+            critical = 0,
+            normal,
+            background,
+        };
+        constexpr static size_t NUM_PRIORITIES = 3;
+
+        // The worker threads are started here and stay alive (parked between batches) until destruction.
+        static auto create(size_t num_threads = std::thread::hardware_concurrency()) -> std::optional<Scheduler>;
+
+        // Before launch_threads() tasks are spread across the workers' queues. Once launched, tasks can only be
+        // added by the running tasks (to spawn children) or by the thread that launched them.
+        void add_task(Task task, Priority priority = Priority::normal);
+
+        void launch_threads();
+
+        // Returns once the critical and normal lanes are drained. Background tasks keep being picked up until the
+        // frame deadline, whatever is still queued then waits for the next batch.
+        void wait_for_threads();
+
+        // Background tasks are only started while steady_clock::now() is before the deadline. Running tasks are
+        // never interrupted, they are preempted at task boundaries. Defaults to no deadline.
+        void set_frame_deadline(std::chrono::steady_clock::time_point deadline) noexcept;
+        void clear_frame_deadline() noexcept;
+
+        // Can be called from any thread. Held back until the next launch_threads(), i.e. the next frame's batch.
+        void add_next_frame_task(Task task, Priority priority = Priority::normal);
+
+        // Splits [0, count) in halves until a chunk is at most grain_size, idle workers steal the other halves so
+        // uneven work balances itself. Blocks until every chunk has run, the calling thread helps while it waits.
+        // Can be called from the main thread or from within a running task. If the scheduler isn't launched yet,
+        // this launches and waits, running any previously added tasks too.
+        template <typename ChunkFn>
+            requires std::invocable<ChunkFn&, size_t, size_t>
+        void parallel_for_chunks(size_t count, size_t grain_size, ChunkFn&& chunk_fn) {
+            parallel_for_erased(count, grain_size, ChunkFunction {
+                .context = &chunk_fn,
+                .invoke = [](void* context, size_t first, size_t last) {
+                    (*static_cast<std::remove_reference_t<ChunkFn>*>(context))(first, last);
+                },
             });
         }
 
-        void add_task(SimpleFunctionPtr task) {
-            if (get_current_task().has_value()) {
-                throw std::runtime_error("trying to add task when already lauched");
-            }
-            _m.tasks.emplace_back(task);
+        template <std::ranges::random_access_range Range, typename Fn>
+            requires std::ranges::sized_range<Range> && std::invocable<Fn&, std::ranges::range_reference_t<Range>>
+        void parallel_for(Range&& range, size_t grain_size, Fn&& fn) {
+            auto begin = std::ranges::begin(range);
+            parallel_for_chunks(static_cast<size_t>(std::ranges::size(range)), grain_size, [&](size_t first, size_t last) {
+                const auto chunk_end = begin + last;
+                for (auto iter = begin + first; iter != chunk_end; ++iter) {
+                    fn(*iter);
+                }
+            });
         }
 
-        void add_task(Task task) {
-            if (get_current_task().has_value()) {
-                throw std::runtime_error("trying to add task when already lauched");
-            }
-            _m.tasks.emplace_back(task);
+        template <std::ranges::random_access_range In, std::ranges::random_access_range Out, typename Fn>
+            requires std::ranges::sized_range<In>
+            && std::ranges::sized_range<Out>
+            && std::invocable<Fn&, std::ranges::range_reference_t<In>>
+        void parallel_transform(In&& input, Out&& output, size_t grain_size, Fn&& fn) {
+            assert(std::ranges::size(output) >= std::ranges::size(input));
+            auto in_begin = std::ranges::begin(input);
+            auto out_begin = std::ranges::begin(output);
+            parallel_for_chunks(static_cast<size_t>(std::ranges::size(input)), grain_size, [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    out_begin[i] = fn(in_begin[i]);
+                }
+            });
         }
 
-        void launch_threads() {
-            if (get_current_task().has_value()) {
-                return;
-            }
-
-            get_current_task().emplace(0);
+        Scheduler(Scheduler&&) = default;
+        ~Scheduler();
 
-            auto execute = [this]() {
-                for (;;) {
-                    auto task_id =
-                        get_current_task()->fetch_add(1, std::memory_order_seq_cst);
+    private:
+        constexpr static size_t CACHE_LINE_SIZE = 64;
+        constexpr static size_t INITIAL_QUEUE_CAPACITY = 256;
+        constexpr static size_t IDLE_SPINS_BEFORE_PARKING = 64;
+
+        // Owner pushes and pops the back (LIFO, cache warm), thieves take from the front (FIFO, oldest/biggest).
+        // Each queue is only contended when it is being stolen from, rather than every task hitting one counter.
+        // The ring buffer only grows, so once warmed up pushing a frame's tasks doesn't allocate.
+        class WorkerQueue
+        {
+        public:
+            WorkerQueue();
+
+            void push_back(Task&& task);
+            auto pop_back() -> std::optional<Task>;
+            auto steal_front() -> std::optional<Task>;
+            auto is_empty(std::memory_order order = std::memory_order_relaxed) const noexcept -> bool {
+                return _size.load(order) == 0;
+            }
 
-                    bool has_tasks_remaining = task_id < _m.tasks.size();
+        private:
+            void lock() noexcept;
+            void unlock() noexcept { _lock.clear(std::memory_order_release); }
+            void grow();
 
-                    if (has_tasks_remaining) {
-                        std::string timer_name = "Scheduler::Task(" + std::to_string(task_id) + ")";
-                        Profiler::Timer timer(timer_name);
-                        auto& task = _m.tasks.at(task_id);
-                        std::visit([](auto& task) { task(); }, task);
-                    } else {
-                        return;
-                    }
-                }
-            };
-            auto start_thread = [&]() { return std::thread(execute); };
+            std::atomic_flag _lock = ATOMIC_FLAG_INIT;
+            std::atomic<size_t> _size = 0;
+            std::vector<Task> _ring;
+            size_t _head = 0; // index of the front, the back is at (_head + _size - 1) & mask.
+        };
 
-            // start the other threads
-            std::generate_n(std::back_inserter(_m.threads), _m.num_threads, start_thread);
-        }
+        struct alignas(CACHE_LINE_SIZE) Worker {
+            std::array<WorkerQueue, NUM_PRIORITIES> queues; // indexed by Priority.
+            uint32_t rng_state;
+        };
+        struct FoundTask {
+            Task task;
+            Priority priority;
+        };
+        struct DeferredTask {
+            Task task;
+            Priority priority;
+        };
 
-        void wait_for_threads() {
-            // get the main thread going too.
-            [this]() {
-                for (;;) {
-                    auto task_id =
-                        get_current_task()->fetch_add(1, std::memory_order_seq_cst);
-
-                    bool has_tasks_remaining = task_id < _m.tasks.size();
-
-                    if (has_tasks_remaining) {
-                        auto& task = _m.tasks.at(task_id);
-                        std::visit([](auto& task) { task(); }, task);
-                    } else {
-                        return;
-                    }
-                }
-            }();
+        // Heap allocated so the running threads keep a stable address when the scheduler is moved.
+        struct Shared {
+            std::vector<std::unique_ptr<Worker>> workers; // workers[0] is the thread that launches & waits.
 
-            std::ranges::for_each(_m.threads, &std::thread::join);
+            alignas(CACHE_LINE_SIZE) std::atomic<size_t> idle_workers = 0;
+            std::atomic<size_t> finished_workers = 0;
+            std::atomic<size_t> sleeping_workers = 0;
 
-            _m.threads.resize(0);
-            _m.tasks.resize(0);
-            get_current_task() = std::nullopt;
-        }
+            alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> batch_epoch = 0; // bumped to wake parked threads for a batch.
+            std::atomic<uint32_t> work_epoch = 0; // bumped to wake idle workers when there's new work.
+            std::atomic<bool> is_launched = false;
+            std::atomic<bool> is_stopping = false;
+            std::atomic<std::chrono::steady_clock::rep> frame_deadline = std::chrono::steady_clock::time_point::max().time_since_epoch().count();
 
-        Scheduler(Scheduler&&) = default;
+            // Work that has to wait for the next frame, pushed from anywhere.
+            std::mutex deferred_mutex;
+            std::vector<DeferredTask> next_frame_tasks;
+        };
 
-    private:
-        using OptAtomicSize = std::optional<std::atomic<size_t>>;
-        using OptAtomicSizeBuffer = std::array<std::byte, sizeof(OptAtomicSize)>;
-
-        constexpr static auto null_opt_atomic = []() {
-            OptAtomicSize empty = std::nullopt;
-            OptAtomicSizeBuffer buffer =
-                *reinterpret_cast<OptAtomicSizeBuffer*>(&empty);
-            return buffer;
+        struct ChunkFunction {
+            void* context;
+            void (*invoke)(void* context, size_t first, size_t last);
+        };
+        struct ParallelFor {
+            ChunkFunction chunk_function;
+            size_t grain_size;
+            std::atomic<size_t> remaining;
         };
 
         struct M {
-            std::vector<Task> tasks;
+            std::unique_ptr<Shared> shared;
             std::vector<std::thread> threads;
-            size_t num_threads;
-            alignas(OptAtomicSize) OptAtomicSizeBuffer current_task_buffer;
+            size_t next_worker;
         } _m;
 
-        auto get_current_task() -> OptAtomicSize& {
-            return *reinterpret_cast<OptAtomicSize*>(_m.current_task_buffer.data());
-        }
+        static void worker_thread_main(Shared& shared, size_t worker_index);
+        static void run_until_idle(Shared& shared, size_t worker_index);
+        static auto find_task(Shared& shared, size_t worker_index) -> std::optional<FoundTask>;
+        static auto steal_task(Shared& shared, size_t worker_index, Priority priority) -> std::optional<Task>;
+        static auto has_queued_tasks(const Shared& shared) noexcept -> bool;
+        static auto is_background_allowed(const Shared& shared) noexcept -> bool;
+        static void notify_new_work(Shared& shared) noexcept;
+        static void run_task(Task& task, Priority priority);
+
+        void parallel_for_erased(size_t count, size_t grain_size, ChunkFunction chunk_function);
+        void split_and_run(ParallelFor& job, size_t first, size_t last);
+        void help_until_zero(const std::atomic<size_t>& counter);
 
         explicit Scheduler(M&& m)
             : _m(std::move(m)) { }
@@ -1,16 +1,62 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <optional>
+#include <span>
+#include <string>
 #include <string_view>
-#include <unordered_map>
+#include <vector>
 
 #include <Utily/Utily.hpp>
 #include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 
 #include "Config.hpp"
 
 namespace Core {
+    // FNV-1a, the same at compile time and run time.
+    constexpr auto uniform_name_hash(std::string_view name) noexcept -> uint64_t {
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : name) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // A uniform's name, hashed at compile time. Arrays are named without the brackets.
+    //  e.g. shader.uniform<glm::mat4>("u_model_transforms")
+    struct UniformName {
+        consteval UniformName(const char* name)
+            : hash(uniform_name_hash(name))
+            , name(name) { }
+
+        uint64_t hash;
+        std::string_view name;
+    };
+
+    // The GLSL types a C++ type can set. int32_t also sets samplers, to the texture unit.
+    template <typename T>
+    concept UniformValue = std::same_as<T, int32_t> || std::same_as<T, float> || std::same_as<T, glm::vec2>
+        || std::same_as<T, glm::vec3> || std::same_as<T, glm::vec4> || std::same_as<T, glm::mat4>;
+
+    // Index into the shader's uniform table, from Shader::uniform(). Only valid for the shader that made it.
+    template <UniformValue T>
+    class UniformHandle
+    {
+    public:
+        UniformHandle() = default;
+
+    private:
+        friend class Shader;
+        explicit UniformHandle(uint32_t index)
+            : _index(index) { }
+        uint32_t _index = UINT32_MAX;
+    };
+
     class Shader
     {
     public:
@@ -28,6 +74,53 @@ namespace Core {
         auto set_uniform(std::string_view uniform, const glm::vec4& value) noexcept -> Utily::Result<void, Utily::Error>;
         auto set_uniform(std::string_view uniform, const glm::mat4& value) noexcept -> Utily::Result<void, Utily::Error>;
 
+        // Looks the uniform up once, so setting it is an index into the table rather than hashing its name.
+        // Fails if there's no active uniform called `name` or its GLSL type doesn't match T.
+        template <UniformValue T>
+        [[nodiscard]] auto uniform(UniformName name) const noexcept -> Utily::Result<UniformHandle<T>, Utily::Error> {
+            auto iter = std::ranges::lower_bound(_uniforms, name.hash, {}, &UniformInfo::name_hash);
+            if (iter == _uniforms.end() || iter->name_hash != name.hash) {
+                return Utily::Error { std::string("Invalid Uniform key: ").append(name.name) };
+            }
+            if (!is_type_of<T>(iter->type)) {
+                return Utily::Error { std::string("Wrong type for uniform: ").append(name.name) };
+            }
+            return UniformHandle<T> { static_cast<uint32_t>(std::distance(_uniforms.begin(), iter)) };
+        }
+
+        // How many elements the uniform has, 1 if it's not an array.
+        template <UniformValue T>
+        [[nodiscard]] auto array_size(UniformHandle<T> handle) const noexcept -> uint32_t {
+            return info_of(handle).array_size;
+        }
+
+        // These bind the shader first.
+        template <UniformValue T>
+        void set(UniformHandle<T> handle, const T& value) noexcept {
+            const UniformInfo& info = info_of(handle);
+            bind();
+            upload(info.location, 1, &value);
+        }
+        // Element `i` of an array.
+        template <UniformValue T>
+        void set(UniformHandle<T> handle, uint32_t i, const T& value) noexcept {
+            const UniformInfo& info = info_of(handle);
+            assert(i < info.array_size);
+            bind();
+            upload(_element_locations[info.first_element + i], 1, &value);
+        }
+        // The first values.size() elements of an array, in one call.
+        template <UniformValue T>
+        void set(UniformHandle<T> handle, std::span<const T> values) noexcept {
+            const UniformInfo& info = info_of(handle);
+            assert(values.size() <= info.array_size);
+            bind();
+            upload(info.location, static_cast<int32_t>(values.size()), values.data());
+        }
+        // Points the `uniform <block>` at whatever UniformBuffer is bound to `binding_point`. Only needed once.
+        auto bind_uniform_block(std::string_view block, uint32_t binding_point) noexcept -> Utily::Result<void, Utily::Error>;
+
+        auto get_id() const noexcept { return _program_id; }
 
         ~Shader();
 
@@ -39,10 +132,52 @@ namespace Core {
             frag = GL_FRAGMENT_SHADER,
             vert = GL_VERTEX_SHADER
         };
+        // Every active uniform outside a uniform block, from glGetActiveUniform() after linking. Sorted by name_hash.
+        struct UniformInfo {
+            uint64_t name_hash;
+            uint32_t type; // GL_FLOAT_VEC3 etc.
+            int32_t location;
+            uint32_t array_size; // 1 if it's not an array.
+            uint32_t first_element; // into _element_locations.
+        };
+
         std::optional<int32_t> _program_id = std::nullopt;
-        std::unordered_map<size_t, Uniform> _cached_uniforms;
+        std::vector<UniformInfo> _uniforms;
+        std::vector<int32_t> _element_locations; // the location of each array element, GL doesn't promise they're consecutive.
+
+        template <UniformValue T>
+        [[nodiscard]] auto info_of(UniformHandle<T> handle) const noexcept -> const UniformInfo& {
+            assert(handle._index < _uniforms.size() && "A default UniformHandle, or one from another shader.");
+            return _uniforms[handle._index];
+        }
 
         [[nodiscard]] static auto compile_shader(Type type, const std::string_view& source) -> Utily::Result<uint32_t, Utily::Error>;
-        [[nodiscard]] auto get_uniform(const std::string_view uniform) noexcept -> Utily::Result<Uniform, Utily::Error>;
+        void load_uniforms();
+        // Resolves "name" or "name[i]" at run time, for set_uniform().
+        [[nodiscard]] auto get_uniform(std::string_view uniform) noexcept -> Utily::Result<Uniform, Utily::Error>;
+
+        template <UniformValue T>
+        static auto is_type_of(uint32_t gl_type) noexcept -> bool {
+            if constexpr (std::same_as<T, int32_t>) {
+                return gl_type == GL_INT || gl_type == GL_BOOL || gl_type == GL_SAMPLER_2D || gl_type == GL_SAMPLER_3D
+                    || gl_type == GL_SAMPLER_CUBE || gl_type == GL_SAMPLER_2D_ARRAY;
+            } else if constexpr (std::same_as<T, float>) {
+                return gl_type == GL_FLOAT;
+            } else if constexpr (std::same_as<T, glm::vec2>) {
+                return gl_type == GL_FLOAT_VEC2;
+            } else if constexpr (std::same_as<T, glm::vec3>) {
+                return gl_type == GL_FLOAT_VEC3;
+            } else if constexpr (std::same_as<T, glm::vec4>) {
+                return gl_type == GL_FLOAT_VEC4;
+            } else {
+                return gl_type == GL_FLOAT_MAT4;
+            }
+        }
+        static void upload(int32_t location, int32_t count, const int32_t* values) noexcept { glUniform1iv(location, count, values); }
+        static void upload(int32_t location, int32_t count, const float* values) noexcept { glUniform1fv(location, count, values); }
+        static void upload(int32_t location, int32_t count, const glm::vec2* values) noexcept { glUniform2fv(location, count, &values[0][0]); }
+        static void upload(int32_t location, int32_t count, const glm::vec3* values) noexcept { glUniform3fv(location, count, &values[0][0]); }
+        static void upload(int32_t location, int32_t count, const glm::vec4* values) noexcept { glUniform4fv(location, count, &values[0][0]); }
+        static void upload(int32_t location, int32_t count, const glm::mat4* values) noexcept { glUniformMatrix4fv(location, count, GL_FALSE, &values[0][0][0]); }
     };
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <tuple>
+
+// Where GLSL puts each member of a `layout(std140)` uniform block, worked out at compile time from the C++ types so
+// the two sides can't drift apart. Only the types uniform blocks in the engine need are supported.
+namespace Core::Std140 {
+    constexpr auto round_up(size_t value, size_t alignment) noexcept -> size_t {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    template <typename T>
+    concept Scalar = std::same_as<T, float> || std::same_as<T, int32_t> || std::same_as<T, uint32_t>;
+
+    // ALIGNMENT and SIZE as the std140 rules define them, and write() to copy a value into the block's bytes.
+    template <typename T>
+    struct Layout;
+
+    template <Scalar T>
+    struct Layout<T> {
+        constexpr static size_t ALIGNMENT = 4;
+        constexpr static size_t SIZE = 4;
+        static void write(std::byte* dst, const T& value) noexcept { std::memcpy(dst, &value, SIZE); }
+    };
+
+    // A vec3 is aligned like a vec4 but only 12 bytes, so a scalar can follow it in the last 4.
+    template <glm::length_t L, Scalar T, glm::qualifier Q>
+    struct Layout<glm::vec<L, T, Q>> {
+        constexpr static size_t ALIGNMENT = L == 2 ? 8 : 16;
+        constexpr static size_t SIZE = L * 4;
+        static void write(std::byte* dst, const glm::vec<L, T, Q>& value) noexcept {
+            for (glm::length_t i = 0; i < L; ++i) {
+                std::memcpy(dst + i * 4, &value[i], 4);
+            }
+        }
+    };
+
+    // Every element of an array is padded out to a vec4.
+    template <typename T, size_t N>
+    struct Layout<std::array<T, N>> {
+        constexpr static size_t STRIDE = round_up(Layout<T>::SIZE, 16);
+        constexpr static size_t ALIGNMENT = round_up(Layout<T>::ALIGNMENT, 16);
+        constexpr static size_t SIZE = STRIDE * N;
+        static void write(std::byte* dst, const std::array<T, N>& value) noexcept {
+            for (size_t i = 0; i < N; ++i) {
+                Layout<T>::write(dst + i * STRIDE, value[i]);
+            }
+        }
+    };
+
+    // Column major, laid out as an array of its columns. So a mat3 is 48 bytes, not 36.
+    template <glm::length_t C, glm::length_t R, Scalar T, glm::qualifier Q>
+    struct Layout<glm::mat<C, R, T, Q>> {
+        using Columns = Layout<std::array<glm::vec<R, T, Q>, C>>;
+        constexpr static size_t ALIGNMENT = Columns::ALIGNMENT;
+        constexpr static size_t SIZE = Columns::SIZE;
+        static void write(std::byte* dst, const glm::mat<C, R, T, Q>& value) noexcept {
+            for (glm::length_t c = 0; c < C; ++c) {
+                Layout<glm::vec<R, T, Q>>::write(dst + c * Columns::STRIDE, value[c]);
+            }
+        }
+    };
+
+    // The bytes of a uniform block (or a struct inside one), with its members' types listed in GLSL declaration order.
+    // Nothing ties a member to its GLSL name, so give the indices names where it's used.
+    //  e.g. `layout(std140) uniform Light { vec3 position; float radius; };` is Block<glm::vec3, float>,
+    //       where `block.set<1>(2.0f)` writes the radius at offset 12.
+    template <typename... Ts>
+    class Block
+    {
+        static consteval auto layout() {
+            std::array<size_t, sizeof...(Ts)> offsets {};
+            size_t offset = 0;
+            size_t i = 0;
+            ((offset = round_up(offset, Layout<Ts>::ALIGNMENT), offsets[i++] = offset, offset += Layout<Ts>::SIZE), ...);
+            return std::tuple { offsets, offset };
+        }
+
+    public:
+        template <size_t I>
+        using Member = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+        constexpr static std::array<size_t, sizeof...(Ts)> OFFSETS = std::get<0>(layout());
+        // Structs are rounded up to a vec4, which is also what GL_UNIFORM_BLOCK_DATA_SIZE reports for a block.
+        constexpr static size_t SIZE = round_up(std::get<1>(layout()), 16);
+
+        template <size_t I>
+        void set(const Member<I>& value) noexcept {
+            Layout<Member<I>>::write(_bytes.data() + OFFSETS[I], value);
+        }
+
+        [[nodiscard]] auto bytes() const noexcept -> std::span<const std::byte, SIZE> { return _bytes; }
+
+    private:
+        std::array<std::byte, SIZE> _bytes {};
+    };
+
+    template <typename... Ts>
+    struct Layout<Block<Ts...>> {
+        constexpr static size_t ALIGNMENT = 16;
+        constexpr static size_t SIZE = Block<Ts...>::SIZE;
+        static void write(std::byte* dst, const Block<Ts...>& value) noexcept {
+            std::memcpy(dst, value.bytes().data(), SIZE);
+        }
+    };
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Config.hpp"
+
+namespace Core {
+    // Passed to VertexBuffer::init() or IndexBuffer::init() to make it a streaming buffer, for data that's
+    // uploaded again every frame. `bytes_per_frame` is a starting point, it grows if a frame uploads more.
+    struct Streaming {
+        size_t bytes_per_frame;
+    };
+
+    // One buffer's storage split into NUM_REGIONS regions, each frame writes into the next one along. So the
+    // storage is only ever specified once and a write never touches data the GPU may still be reading. Each
+    // region gets a fence when the frame that wrote it is over, and it's waited on (usually already signalled)
+    // before that region is written again.
+    // Native writes with an unsynchronized glMapBufferRange, WebGL has no mapping so it uses glBufferSubData (and
+    // no fences, it can't wait on them and checks for hazards itself).
+    class StreamRing
+    {
+    public:
+        constexpr static size_t NUM_REGIONS = 3;
+
+        StreamRing() = default;
+        StreamRing(const StreamRing&) = delete;
+        StreamRing(StreamRing&& other) noexcept;
+        auto operator=(StreamRing&& other) noexcept -> StreamRing&;
+
+        // The buffer has to be bound to `target`, here and in write().
+        void init(uint32_t target, size_t region_size) noexcept;
+        void stop() noexcept;
+
+        // Copies `bytes` after the last write this frame, returns their byte offset into the buffer.
+        [[nodiscard]] auto write(uint32_t target, std::span<const std::byte> bytes) noexcept -> size_t;
+
+        // Once a frame, after the frame's draws. Every ring moves on to its next region on its next write.
+        static void end_frame() noexcept { ++s_frame; }
+
+        ~StreamRing();
+
+    private:
+        constexpr static size_t ALIGNMENT = 16;
+
+        inline static uint64_t s_frame = 0;
+
+        size_t _region_size = 0;
+        // Where each region starts. Consecutive until it grows mid-frame, see grow().
+        std::array<size_t, NUM_REGIONS> _region_bases {};
+        size_t _region = 0;
+        size_t _cursor = 0; // into the current region.
+        uint64_t _frame = 0;
+#if defined(CONFIG_TARGET_NATIVE)
+        std::array<GLsync, NUM_REGIONS> _fences {};
+#endif
+
+        void next_region() noexcept;
+        void grow(uint32_t target, size_t min_region_size) noexcept;
+        void allocate(uint32_t target, size_t first_base, size_t region_size) noexcept;
+        void delete_fences() noexcept;
+    };
+}
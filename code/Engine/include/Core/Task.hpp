@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "Core/GlCommandQueue.hpp"
+#include "Core/Scheduler.hpp"
+
+namespace Core {
+
+    template <typename T = void>
+    class Task;
+
+    namespace Detail {
+        struct TaskPromiseBase {
+            std::coroutine_handle<> continuation = nullptr;
+            std::exception_ptr exception = nullptr;
+            bool is_detached = false;
+
+            // Lazy, nothing runs until it is awaited or spawned.
+            auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+
+            struct FinalAwaiter {
+                auto await_ready() noexcept -> bool { return false; }
+
+                // Symmetric transfer into whoever awaited us, so long await chains don't grow the stack.
+                template <typename Promise>
+                auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> std::coroutine_handle<> {
+                    TaskPromiseBase& promise = handle.promise();
+                    if (promise.is_detached) {
+                        handle.destroy();
+                        return std::noop_coroutine();
+                    }
+                    if (promise.continuation) {
+                        return promise.continuation;
+                    }
+                    return std::noop_coroutine();
+                }
+                void await_resume() noexcept { }
+            };
+            auto final_suspend() noexcept -> FinalAwaiter { return {}; }
+
+            void unhandled_exception() noexcept {
+                if (is_detached) {
+                    // Nobody is left to rethrow to, same as an exception escaping a std::thread.
+                    std::terminate();
+                }
+                exception = std::current_exception();
+            }
+        };
+
+        template <typename T>
+        struct TaskPromise : TaskPromiseBase {
+            std::optional<T> value;
+
+            auto get_return_object() noexcept -> Task<T>;
+
+            template <typename U>
+                requires std::convertible_to<U&&, T>
+            void return_value(U&& result) noexcept(std::is_nothrow_constructible_v<T, U&&>) {
+                value.emplace(std::forward<U>(result));
+            }
+            auto take_result() -> T {
+                if (exception) {
+                    std::rethrow_exception(exception);
+                }
+                return std::move(*value);
+            }
+        };
+
+        template <>
+        struct TaskPromise<void> : TaskPromiseBase {
+            auto get_return_object() noexcept -> Task<void>;
+
+            void return_void() noexcept { }
+            void take_result() {
+                if (exception) {
+                    std::rethrow_exception(exception);
+                }
+            }
+        };
+    }
+
+    // A coroutine that runs on the Scheduler's pool. Instead of blocking a thread, `co_await` another Task,
+    // `next_frame(scheduler)`, `resume_on_main_thread()` or `resume_on_workers(scheduler)` to suspend.
+    //  e.g.
+    //      auto load_texture(Core::Scheduler& scheduler, std::filesystem::path path) -> Core::Task<Core::Texture> {
+    //          auto image = co_await decode_image(path);     // on a worker
+    //          co_await Core::resume_on_main_thread();
+    //          ...                                           // GL upload on the main thread
+    //          co_return texture;
+    //      }
+    // Tasks are lazy, they only start when awaited or handed to spawn().
+    template <typename T>
+    class [[nodiscard]] Task
+    {
+    public:
+        using promise_type = Detail::TaskPromise<T>;
+
+        Task() = default;
+        Task(const Task&) = delete;
+        Task(Task&& other) noexcept
+            : _handle(std::exchange(other._handle, nullptr)) { }
+
+        auto operator=(Task&& other) noexcept -> Task& {
+            if (this != &other) {
+                destroy();
+                _handle = std::exchange(other._handle, nullptr);
+            }
+            return *this;
+        }
+
+        ~Task() {
+            destroy();
+        }
+
+        // Starts the task on the awaiting thread, the awaiter resumes wherever the task finishes.
+        auto operator co_await() && noexcept {
+            struct Awaiter {
+                std::coroutine_handle<promise_type> handle;
+
+                auto await_ready() const noexcept -> bool {
+                    assert(handle && "awaiting an empty or moved-from Task");
+                    return handle.done();
+                }
+                auto await_suspend(std::coroutine_handle<> awaiting) noexcept -> std::coroutine_handle<> {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                }
+                auto await_resume() -> T { return handle.promise().take_result(); }
+            };
+            return Awaiter { _handle };
+        }
+
+        [[nodiscard]] auto is_done() const noexcept -> bool { return _handle && _handle.done(); }
+
+        // Hands over ownership of the coroutine frame, used by spawn().
+        [[nodiscard]] auto release() noexcept -> std::coroutine_handle<promise_type> {
+            return std::exchange(_handle, nullptr);
+        }
+
+    private:
+        friend promise_type;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+            : _handle(handle) { }
+
+        void destroy() noexcept {
+            if (_handle) {
+                _handle.destroy();
+                _handle = nullptr;
+            }
+        }
+
+        std::coroutine_handle<promise_type> _handle = nullptr;
+    };
+
+    namespace Detail {
+        template <typename T>
+        inline auto TaskPromise<T>::get_return_object() noexcept -> Task<T> {
+            return Task<T> { std::coroutine_handle<TaskPromise<T>>::from_promise(*this) };
+        }
+        inline auto TaskPromise<void>::get_return_object() noexcept -> Task<void> {
+            return Task<void> { std::coroutine_handle<TaskPromise<void>>::from_promise(*this) };
+        }
+
+        // After handing the handle over another thread can resume it, so nothing may touch the awaiter afterwards.
+        struct NextFrameAwaiter {
+            Scheduler& scheduler;
+            Scheduler::Priority priority;
+
+            auto await_ready() const noexcept -> bool { return false; }
+            void await_suspend(std::coroutine_handle<> handle) {
+                scheduler.add_next_frame_task([handle]() { handle.resume(); }, priority);
+            }
+            void await_resume() const noexcept { }
+        };
+
+        struct MainThreadAwaiter {
+            auto await_ready() const noexcept -> bool { return false; }
+            void await_suspend(std::coroutine_handle<> handle) {
+                GlCommandQueue::instance().push([handle]() { handle.resume(); });
+            }
+            void await_resume() const noexcept { }
+        };
+
+        struct WorkerAwaiter {
+            Scheduler& scheduler;
+            Scheduler::Priority priority;
+
+            auto await_ready() const noexcept -> bool { return false; }
+            void await_suspend(std::coroutine_handle<> handle) {
+                scheduler.add_task([handle]() { handle.resume(); }, priority);
+            }
+            void await_resume() const noexcept { }
+        };
+    }
+
+    // Resumes on a worker during the next launch_threads() batch.
+    [[nodiscard]] inline auto next_frame(Scheduler& scheduler, Scheduler::Priority priority = Scheduler::Priority::normal) -> Detail::NextFrameAwaiter {
+        return { scheduler, priority };
+    }
+
+    // Resumes on the GL thread when App::render() drains the GlCommandQueue.
+    [[nodiscard]] inline auto resume_on_main_thread() -> Detail::MainThreadAwaiter {
+        return {};
+    }
+
+    // Resumes as a regular scheduler task, e.g. to get back off the main thread or to drop into the background lane.
+    [[nodiscard]] inline auto resume_on_workers(Scheduler& scheduler, Scheduler::Priority priority = Scheduler::Priority::normal) -> Detail::WorkerAwaiter {
+        return { scheduler, priority };
+    }
+
+    // Fire and forget. The task is started as a scheduler task and frees itself once it finishes.
+    inline void spawn(Scheduler& scheduler, Task<void> task, Scheduler::Priority priority = Scheduler::Priority::normal) {
+        auto handle = task.release();
+        if (!handle) {
+            return;
+        }
+        handle.promise().is_detached = true;
+        scheduler.add_task([handle]() { handle.resume(); }, priority);
+    }
+}
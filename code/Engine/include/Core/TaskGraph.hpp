@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Utily/Utily.hpp>
+
+#include "Core/Scheduler.hpp"
+#include "Profiler/Profiler.hpp"
+
+namespace Core {
+
+    // Declare the nodes & edges once, then execute() every frame. A node is released onto the scheduler as soon
+    // as all of its predecessors have finished, rather than waiting on a full barrier between stages.
+    class TaskGraph
+    {
+    public:
+        struct NodeId {
+            size_t id;
+        };
+        struct NodeTiming {
+            std::string_view name;
+            std::chrono::nanoseconds duration;
+        };
+
+        // The task is invoked once per execute(), so it must be safe to call repeatedly.
+        auto add_node(std::string_view name, Scheduler::Task task, Scheduler::Priority priority = Scheduler::Priority::normal) -> NodeId;
+
+        // `before` must finish before `after` is released.
+        void add_edge(NodeId before, NodeId after);
+
+        // Validates the graph is acyclic and builds the flat successor lists.
+        [[nodiscard]] auto compile() -> Utily::Result<void, Utily::Error>;
+
+        // Runs the whole graph on the scheduler and waits for every node to finish. Compiles it first if it's changed
+        // since the last compile(), and runs nothing if that fails.
+        [[nodiscard]] auto execute(Scheduler& scheduler) -> Utily::Result<void, Utily::Error>;
+
+        // How long each node took during the last execute().
+        [[nodiscard]] auto node_timings() const -> std::vector<NodeTiming>;
+
+        [[nodiscard]] auto size() const noexcept -> size_t { return _nodes.size(); }
+
+    private:
+        struct Node {
+            std::string name;
+            Profiler::Zone zone; // interned once here rather than per execute().
+            Scheduler::Task task;
+            Scheduler::Priority priority = Scheduler::Priority::normal;
+            uint32_t num_predecessors = 0;
+            std::chrono::nanoseconds last_duration { 0 };
+        };
+
+        std::vector<Node> _nodes;
+        std::vector<std::pair<size_t, size_t>> _edges;
+
+        // Built by compile().
+        bool _is_compiled = false;
+        std::vector<size_t> _roots;
+        std::vector<size_t> _successor_offsets; // _successors[_successor_offsets[n] .. _successor_offsets[n + 1]]
+        std::vector<size_t> _successors;
+        std::unique_ptr<std::atomic<uint32_t>[]> _remaining_predecessors;
+
+        void run_node(Scheduler& scheduler, size_t node_index);
+        [[nodiscard]] auto successors_of(size_t node_index) const noexcept -> std::span<const size_t>;
+    };
+}
@@ -22,11 +22,14 @@ namespace Core {
         [[nodiscard]] auto init() noexcept -> Utily::Result<void, Utily::Error>;
         auto upload_image(const Media::Image& image, Filter filter = Filter::smooth) noexcept -> Utily::Result<void, Utily::Error>;
 
-        // Once texture unit is aquired, it cannot be taken away unless unbinded() or just bind(false).
+        // bind(true) locks the unit to the texture until a matching unlock(), so it can't be taken away in between.
+        // Locks are counted, bind(false) never takes one away.
         [[nodiscard]] auto bind(bool locked = false) noexcept -> Utily::Result<uint32_t, Utily::Error>;
+        void unlock() noexcept;
         void unbind() noexcept;
         void stop() noexcept;
         inline auto unit() const noexcept { return _texture_unit_index; }
+        inline auto get_id() const noexcept { return _id; }
 
         ~Texture();
 
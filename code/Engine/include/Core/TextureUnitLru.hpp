@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <Utily/Utily.hpp>
+
+namespace Core {
+
+    // Which texture is on which unit, for GlState. Only the bookkeeping, GlState makes the GL calls.
+    // Units form a doubly linked list from least to most recently used, locked and empty units excluded.
+    // Empty units are kept at the front so they're used first.
+    // Locks are counted, a unit goes back in the list once every lock on it has been unlocked. So draws queued with
+    // the same texture can each hold it until they're drawn, whatever else binds it in between.
+    class TextureUnitLru
+    {
+    public:
+        struct Acquired {
+            uint32_t unit;
+            bool is_bind_needed; // the unit had another texture, or none.
+            bool was_empty;
+        };
+
+        // Empties every unit.
+        void reset(size_t num_units);
+        [[nodiscard]] auto size() const noexcept -> size_t { return _units.size(); }
+
+        // The unit `texture` had last time (`hint`) if it still has it, otherwise the least recently used unlocked
+        // unit. `is_locked` adds a lock, without it the unit keeps any locks it has.
+        [[nodiscard]] auto acquire(uint32_t texture, std::optional<uint32_t> hint, bool is_locked) noexcept
+            -> Utily::Result<Acquired, Utily::Error>;
+        // Drops one lock. Nothing happens if `unit` doesn't have `texture` or isn't locked.
+        void unlock(uint32_t texture, uint32_t unit) noexcept;
+        // Empties the unit whatever its locks, false if it didn't have `texture`.
+        auto release(uint32_t texture, uint32_t unit) noexcept -> bool;
+
+        [[nodiscard]] auto texture(uint32_t unit) const noexcept -> uint32_t { return _units[unit].texture; }
+        [[nodiscard]] auto num_locks(uint32_t unit) const noexcept -> uint32_t { return _units[unit].num_locks; }
+        // Least recently used first, the order units are handed out in.
+        [[nodiscard]] auto lru_order() const -> std::vector<uint32_t>;
+
+    private:
+        constexpr static uint16_t NO_UNIT = UINT16_MAX;
+
+        struct Unit {
+            uint32_t texture = 0;
+            uint16_t num_locks = 0;
+            uint16_t prev = NO_UNIT;
+            uint16_t next = NO_UNIT;
+        };
+
+        std::vector<Unit> _units;
+        uint16_t _front = NO_UNIT;
+        uint16_t _back = NO_UNIT;
+
+        void unlink(uint16_t unit) noexcept;
+        void push_front(uint16_t unit) noexcept;
+        void push_back(uint16_t unit) noexcept;
+    };
+}
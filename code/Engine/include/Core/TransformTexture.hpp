@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include <glm/glm.hpp>
+#include <Utily/Utily.hpp>
+
+#include "Config.hpp"
+
+// Reads matrix `index` from a Core::TransformTexture bound to `sampler`, for pasting into vertex shader sources.
+// Has to match TransformTexture::texel().
+#define CORE_TRANSFORM_TEXTURE_GLSL                                           \
+    "mat4 fetch_transform(highp sampler2D sampler, uint index) {\n"           \
+    "    ivec2 texel = ivec2(int(index % 256u) * 4, int(index / 256u));\n"   \
+    "    return mat4(\n"                                                      \
+    "        texelFetch(sampler, texel, 0),\n"                                \
+    "        texelFetch(sampler, texel + ivec2(1, 0), 0),\n"                  \
+    "        texelFetch(sampler, texel + ivec2(2, 0), 0),\n"                  \
+    "        texelFetch(sampler, texel + ivec2(3, 0), 0));\n"                 \
+    "}\n"
+
+namespace Core {
+    // Matrices in an RGBA32F texture, a column per texel and MATRICES_PER_ROW to a row, for shaders to fetch by index.
+    // Holds far more than a uniform array or block can (a 16KB block is 256 matrices) and is uploaded in one call.
+    // A plain 2D texture since WebGL2 has no texture buffers.
+    class TransformTexture
+    {
+    public:
+        constexpr static int32_t MATRICES_PER_ROW = 256;
+        constexpr static int32_t WIDTH = MATRICES_PER_ROW * 4;
+
+        // The first of the matrix's four texels.
+        constexpr static auto texel(uint32_t index) noexcept -> std::array<int32_t, 2> {
+            return { static_cast<int32_t>(index % MATRICES_PER_ROW) * 4, static_cast<int32_t>(index / MATRICES_PER_ROW) };
+        }
+
+        TransformTexture() = default;
+        TransformTexture(const TransformTexture&) = delete;
+        TransformTexture(TransformTexture&& other) noexcept;
+
+        [[nodiscard]] auto init() noexcept -> Utily::Result<void, Utily::Error>;
+        void stop() noexcept;
+
+        // Replaces the contents, growing the texture if they don't fit. Binds it.
+        void load(std::span<const glm::mat4> transforms) noexcept;
+        // Like Texture::bind(), returns the unit to set the sampler to.
+        [[nodiscard]] auto bind(bool locked = false) noexcept -> Utily::Result<uint32_t, Utily::Error>;
+
+        ~TransformTexture();
+
+    private:
+        std::optional<uint32_t> _id = std::nullopt;
+        std::optional<uint32_t> _texture_unit_index = std::nullopt;
+        int32_t _num_rows = 0;
+    };
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include <Utily/Utily.hpp>
+
+#include "Core/Std140.hpp"
+
+#include "Config.hpp"
+
+namespace Core {
+    // Data for `layout(std140) uniform` blocks, shared by every shader whose block is bound to the same binding point
+    // (see Shader::bind_uniform_block()). So data used by many shaders is uploaded once instead of once per shader.
+    class UniformBuffer
+    {
+    public:
+        UniformBuffer() = default;
+        UniformBuffer(const UniformBuffer&) = delete;
+        UniformBuffer(UniformBuffer&&) noexcept;
+
+        [[nodiscard]] auto init() noexcept -> Utily::Result<void, Utily::Error>;
+        void stop() noexcept;
+
+        void bind() noexcept;
+        void unbind() noexcept;
+        void bind_to(uint32_t binding_point) noexcept;
+
+        template <typename... Ts>
+        void load(const Std140::Block<Ts...>& block) noexcept {
+            load_bytes(block.bytes());
+        }
+        void load_bytes(std::span<const std::byte> bytes) noexcept;
+
+        ~UniformBuffer() noexcept;
+
+    private:
+        std::optional<uint32_t> _id = std::nullopt;
+    };
+}
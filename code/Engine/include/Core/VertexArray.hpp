@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 #include "Config.hpp"
 #include "Core/DebugOpRecorder.hpp"
@@ -46,10 +47,11 @@ namespace Core {
             constexpr static auto layout = vbl.get_layout();
             constexpr static auto stride = vbl.get_stride();
 
+            _attributes.clear();
             uint32_t offset = 0;
             for (size_t i = 0; i < layout.size(); i++) {
                 const auto& element = layout[i];
-                glVertexAttribPointer(i, element.count, element.type, element.normalised, stride, reinterpret_cast<const void*>(offset));
+                add_attribute(vb, static_cast<uint32_t>(i), element.count, element.type, element.normalised, stride, offset);
                 glEnableVertexAttribArray(i);
                 offset += element.type_size;
             }
@@ -78,6 +80,7 @@ namespace Core {
             this->bind();
             ib.bind();
 
+            _attributes.clear();
             size_t layout_index = 0;
             { // set the VA attribs for the mesh VB
                 vb_mesh.bind();
@@ -86,7 +89,7 @@ namespace Core {
                 constexpr static auto stride = vbl.get_stride();
                 for (uint32_t offset = 0; layout_index < layout.size(); ++layout_index) {
                     const auto& element = layout[layout_index];
-                    glVertexAttribPointer(layout_index, element.count, element.type, element.normalised, stride, reinterpret_cast<const void*>(offset));
+                    add_attribute(vb_mesh, static_cast<uint32_t>(layout_index), element.count, element.type, element.normalised, stride, offset);
                     glEnableVertexAttribArray(layout_index);
                     glVertexAttribDivisor(layout_index, 0);
                     offset += element.type_size;
@@ -103,7 +106,7 @@ namespace Core {
 
                 for (uint32_t i = 0, offset = 0; layout_index < max_layout_index; ++i, ++layout_index) {
                     const auto& element = layout[i];
-                    glVertexAttribPointer(layout_index, element.count, element.type, element.normalised, stride, reinterpret_cast<const void*>(offset));
+                    add_attribute(vb_transforms, static_cast<uint32_t>(layout_index), element.count, element.type, element.normalised, stride, offset);
                     glEnableVertexAttribArray(layout_index);
                     glVertexAttribDivisor(layout_index, 1);
                     offset += element.type_size;
@@ -117,9 +120,31 @@ namespace Core {
         void bind() noexcept;
         void unbind() noexcept;
 
+        // Points the attributes read from `vb` at its latest data, for streaming vertex buffers whose data moves
+        // every upload. Changing the pointers works on ES too, unlike glDrawElementsBaseVertex. Binds the array.
+        void rebase(VertexBuffer& vb) noexcept;
+        // At `base` rather than the latest data, for draws recorded before the buffer was uploaded to again.
+        void rebase(VertexBuffer& vb, size_t base) noexcept;
+
         auto get_id() const noexcept { return _id; }
 
     private:
+        struct Attribute {
+            uint32_t index;
+            uint32_t count;
+            uint32_t type;
+            uint32_t normalised;
+            uint32_t stride;
+            uint32_t offset; // within a vertex.
+            uint32_t buffer;
+            size_t base; // the vertex buffer's offset it's pointing at.
+        };
+
         std::optional<uint32_t> _id;
+        std::vector<Attribute> _attributes;
+
+        // The vertex buffer has to be bound.
+        static void set_attribute_pointer(const Attribute& attribute) noexcept;
+        void add_attribute(VertexBuffer& vb, uint32_t index, uint32_t count, uint32_t type, uint32_t normalised, uint32_t stride, uint32_t offset) noexcept;
     };
 }
\ No newline at end of file
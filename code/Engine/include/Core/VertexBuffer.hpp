@@ -3,12 +3,15 @@
 #include <cstdint>
 #include <optional>
 #include <ranges>
+#include <span>
 #include <type_traits>
 
 #include <Utily/Utily.hpp>
 
+#include "Profiler/EngineCounters.hpp"
 #include "Profiler/Profiler.hpp"
 #include "Core/DebugOpRecorder.hpp"
+#include "Core/StreamRing.hpp"
 
 #include "Config.hpp"
 
@@ -21,6 +24,9 @@ namespace Core {
         VertexBuffer(VertexBuffer&&) noexcept;
 
         [[nodiscard]] auto init() noexcept -> Utily::Result<void, Utily::Error>;
+        // Each load_vertices() goes into a new part of one buffer instead of replacing its storage, see StreamRing.
+        // Draws have to start at get_offset(), VertexArray::rebase() does that for the vertex attributes.
+        [[nodiscard]] auto init(Streaming streaming) noexcept -> Utily::Result<void, Utily::Error>;
         void stop() noexcept;
 
         void bind() noexcept;
@@ -33,12 +39,17 @@ namespace Core {
             && std::contiguous_iterator<std::ranges::iterator_t<Range>>
             && std::ranges::sized_range<Range>
         void load_vertices(const Range& vertices) noexcept {
-            Profiler::Timer timer("Core::VertexBuffer::load_vertices", {"rendering"});
+            PROFILER_ZONE("Core::VertexBuffer::load_vertices", "rendering");
             Core::DebugOpRecorder::instance().push("Core::VertexBuffer", "load_vertices()");
 
             this->bind();
+            if (_stream) {
+                _offset = _stream->write(GL_ARRAY_BUFFER, std::as_bytes(std::span { std::ranges::data(vertices), std::ranges::size(vertices) }));
+                return;
+            }
             using Underlying = std::ranges::range_value_t<Range>;
             size_t size_in_bytes = vertices.size() * sizeof(Underlying);
+            EngineCounters::bytes_uploaded().add(static_cast<int64_t>(size_in_bytes));
 
 #if defined(CONFIG_TARGET_NATIVE)
             glBufferData(GL_ARRAY_BUFFER, size_in_bytes, &(*vertices.begin()), GL_DYNAMIC_DRAW);
@@ -47,7 +58,13 @@ namespace Core {
 #endif
         }
 
+        auto get_id() const noexcept { return _id; }
+        // Where the last load_vertices() put its data, in bytes. Always 0 unless streaming.
+        size_t get_offset() const noexcept { return _offset; }
+
     private:
         std::optional<uint32_t> _id = std::nullopt;
+        std::optional<StreamRing> _stream = std::nullopt;
+        size_t _offset = 0;
     };
 }
\ No newline at end of file
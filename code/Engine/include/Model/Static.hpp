@@ -3,6 +3,10 @@
 #include "Model/Types.hpp"
 #include "Utily/Utily.hpp"
 
+namespace Core {
+    class Scheduler;
+}
+
 namespace Model {
     // Contiguous vertices and indices.
     struct Static {
@@ -17,6 +21,13 @@ namespace Model {
         std::string_view file_extension)
         -> Utily::Result<Static, Utily::Error>;
 
+    // Same as above, but the vertex and index extraction is split across the scheduler.
+    auto decode_as_static_model(
+        std::span<uint8_t> file_data,
+        std::string_view file_extension,
+        Core::Scheduler& scheduler)
+        -> Utily::Result<Static, Utily::Error>;
+
     auto join(Static&& lhs, Static&& rhs) -> Model::Static;
 
     auto generate_plane(glm::vec3 a, glm::vec3 b, glm::vec3 c, glm::vec3 d) -> Model::Static;
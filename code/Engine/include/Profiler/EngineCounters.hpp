@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Profiler/Profiler.hpp"
+
+// The counter tracks the engine records itself, shared by every call site that feeds them.
+namespace EngineCounters {
+    inline auto draw_calls() -> const Profiler::Counter& {
+        static const Profiler::Counter counter { "Draw calls", "rendering", Profiler::Counter::Kind::per_frame };
+        return counter;
+    }
+    // Vertex and index data handed to glBufferData.
+    inline auto bytes_uploaded() -> const Profiler::Counter& {
+        static const Profiler::Counter counter { "Bytes uploaded", "rendering", Profiler::Counter::Kind::per_frame };
+        return counter;
+    }
+    // Binds and enables that reached the driver, and the ones GlState skipped because nothing would change.
+    inline auto gl_state_changes() -> const Profiler::Counter& {
+        static const Profiler::Counter counter { "GL state changes", "rendering", Profiler::Counter::Kind::per_frame };
+        return counter;
+    }
+    inline auto redundant_gl_calls() -> const Profiler::Counter& {
+        static const Profiler::Counter counter { "Redundant GL calls", "rendering", Profiler::Counter::Kind::per_frame };
+        return counter;
+    }
+    // Times a streaming buffer had to wait for the GPU before reusing a region, see Core::StreamRing.
+    inline auto stream_buffer_waits() -> const Profiler::Counter& {
+        static const Profiler::Counter counter { "Stream buffer waits", "rendering", Profiler::Counter::Kind::per_frame };
+        return counter;
+    }
+    inline auto texture_units_in_use() -> const Profiler::Counter& {
+        static const Profiler::Counter counter { "Texture units in use", "rendering" };
+        return counter;
+    }
+    // See GpuProfiler::last_frame_gpu_time().
+    inline auto gpu_frame_time_us() -> const Profiler::Counter& {
+        static const Profiler::Counter counter { "GPU frame time (us)", "rendering" };
+        return counter;
+    }
+    inline auto active_audio_sources() -> const Profiler::Counter& {
+        static const Profiler::Counter counter { "Active audio sources", "audio" };
+        return counter;
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Profiler/GpuSpanFrames.hpp"
+#include "Profiler/Profiler.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Times the GPU side of the rest of the scope. A CPU zone around a draw call only measures how long the driver
+// takes to queue it, this measures when the GPU actually ran it. Shown on the trace's "GPU" track.
+// Name it differently to the CPU zone next to it, zone_stats() merges zones with the same name.
+//  e.g. PROFILER_GPU_ZONE("glDrawElements() (GPU)", "rendering");
+#define PROFILER_GPU_ZONE(...)                                                                   \
+    static const Profiler::Zone PROFILER_CONCAT(profiler_gpu_zone_, __LINE__) { __VA_ARGS__ }; \
+    const GpuProfiler::Timer PROFILER_CONCAT(profiler_gpu_timer_, __LINE__) { PROFILER_CONCAT(profiler_gpu_zone_, __LINE__) }
+
+// GL_TIMESTAMP queries around GPU zones. The queries of the last FRAMES_IN_FLIGHT frames are kept in a pool and
+// read back once the GPU has got to them, so nothing waits on the GPU. See GpuSpanFrames for the bookkeeping. Their times are mapped onto now_ticks()
+// and submitted to the Profiler like any other zone, so they line up with the CPU zones (to within the driver's
+// queueing latency). Needs ARB_timer_query, which llvmpipe has too. Without it (or on web) GPU zones do nothing.
+// GL thread only.
+class GpuProfiler
+{
+public:
+    class Timer
+    {
+    public:
+        Timer() = delete;
+        Timer(const Timer&) = delete;
+        Timer(Timer&&) = delete;
+
+        explicit Timer(const Profiler::Zone& zone);
+        ~Timer();
+
+    private:
+        GpuSpanFrames::SpanRef _span;
+        bool _is_recording;
+    };
+
+    constexpr static size_t FRAMES_IN_FLIGHT = GpuSpanFrames::FRAMES_IN_FLIGHT;
+    // glGetInteger64v(GL_TIMESTAMP) can wait on the GPU, so the clocks are only matched up again this often. They
+    // drift apart by far less than a zone's length in between.
+    constexpr static uint32_t CALIBRATION_INTERVAL_FRAMES = 600;
+
+    static auto instance() -> GpuProfiler&;
+
+    // Once the context is current. Checks the driver supports timer queries.
+    void init();
+    // Before the context is destroyed.
+    void stop();
+    [[nodiscard]] auto is_active() const noexcept -> bool { return _is_active; }
+
+    // Once a frame, after its GL calls. Submits the spans of every frame the GPU has finished since the last call.
+    void end_frame();
+
+    // From the first GPU zone's start to the last one's end in the latest frame that's been read back.
+    // Compare it with the CPU frame time to tell whether a frame is GPU bound.
+    [[nodiscard]] auto last_frame_gpu_time() const noexcept -> std::optional<std::chrono::nanoseconds> { return _last_frame_gpu_time; }
+    // Frames whose queries still weren't finished FRAMES_IN_FLIGHT frames later, so were thrown away.
+    [[nodiscard]] auto num_dropped_frames() const noexcept -> uint64_t { return _span_frames.num_dropped_frames(); }
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler(GpuProfiler&&) = delete;
+
+private:
+    GpuSpanFrames _span_frames;
+    // GL query objects for each frame's slots, grown on demand.
+    std::array<std::vector<uint32_t>, FRAMES_IN_FLIGHT> _queries;
+    std::vector<uint64_t> _timestamps; // reused by try_read_back().
+    bool _is_active = false;
+
+    // GL_TIMESTAMP and now_ticks() read back to back, to map GPU nanoseconds onto the CPU timeline.
+    int64_t _gpu_reference_ns = 0;
+    int64_t _cpu_reference_ticks = 0;
+    uint32_t _frames_since_calibration = 0;
+
+    std::optional<std::chrono::nanoseconds> _last_frame_gpu_time;
+
+    auto begin_span(uint32_t zone_id) -> GpuSpanFrames::SpanRef;
+    void end_span(GpuSpanFrames::SpanRef span);
+    void issue_timestamp(GpuSpanFrames::Slot slot);
+    auto try_read_back(size_t frame_index, const GpuSpanFrames::Frame& frame) -> bool;
+    void calibrate();
+
+    GpuProfiler() = default;
+};
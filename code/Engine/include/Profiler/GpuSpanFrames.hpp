@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Which GPU zones were timed by which query slots in which frame, for GpuProfiler. Only the bookkeeping, GpuProfiler
+// maps the slots onto GL query objects and reads them back. Each frame's slots are handed out from 0 again once it's
+// been read back or dropped, so GpuProfiler's query pools stop growing after the first few frames.
+class GpuSpanFrames
+{
+public:
+    constexpr static size_t FRAMES_IN_FLIGHT = 4;
+    constexpr static uint32_t NOT_ENDED = UINT32_MAX;
+
+    struct Span {
+        uint32_t zone_id;
+        uint16_t process_id;
+        uint32_t begin_query; // slots in the frame.
+        uint32_t end_query;
+    };
+    struct Frame {
+        uint64_t number = 0;
+        uint32_t num_queries_used = 0;
+        std::vector<Span> spans;
+    };
+
+    // Where a span was begun, so it's ended in that frame even when end_frame() has been called since.
+    struct SpanRef {
+        uint64_t frame_number;
+        uint32_t span_index;
+    };
+    // Issue a timestamp into query `query` of frame `frame` (an index into frames()).
+    struct Slot {
+        size_t frame;
+        uint32_t query;
+    };
+
+    [[nodiscard]] auto begin_span(uint32_t zone_id, uint16_t process_id) -> std::pair<SpanRef, Slot>;
+    // Nothing to issue if the span's frame has already been read back or dropped.
+    [[nodiscard]] auto end_span(SpanRef span) -> std::optional<Slot>;
+
+    // Moves on to the next frame. `read_back(frame_index, frame)` is given each frame with queries, oldest first,
+    // and returns false if the GPU hasn't finished it yet, which stops the later ones being tried as well.
+    // The frame about to be reused is dropped if it still hasn't been read back.
+    template <typename ReadBack>
+    void end_frame(ReadBack&& read_back) {
+        _current_frame = (_current_frame + 1) % FRAMES_IN_FLIGHT;
+        for (size_t i = 0; i < FRAMES_IN_FLIGHT; ++i) {
+            const size_t index = (_current_frame + i) % FRAMES_IN_FLIGHT;
+            Frame& frame = _frames[index];
+            if (frame.num_queries_used == 0) {
+                continue;
+            }
+            if (!read_back(index, std::as_const(frame))) {
+                break;
+            }
+            clear(frame);
+        }
+
+        Frame& next = _frames[_current_frame];
+        if (next.num_queries_used) {
+            ++_num_dropped_frames;
+            clear(next);
+        }
+        next.number = ++_frame_number;
+    }
+
+    [[nodiscard]] auto frames() const noexcept -> const std::array<Frame, FRAMES_IN_FLIGHT>& { return _frames; }
+    [[nodiscard]] auto current_frame() const noexcept -> size_t { return _current_frame; }
+    [[nodiscard]] auto num_dropped_frames() const noexcept -> uint64_t { return _num_dropped_frames; }
+
+    // Forgets every frame, e.g. once the queries are deleted.
+    void reset();
+
+private:
+    std::array<Frame, FRAMES_IN_FLIGHT> _frames;
+    size_t _current_frame = 0;
+    uint64_t _frame_number = 0;
+    uint64_t _num_dropped_frames = 0;
+
+    static void clear(Frame& frame) noexcept;
+};
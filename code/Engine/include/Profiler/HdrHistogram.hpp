@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+// Log-linear buckets in the style of HdrHistogram. Values below LINEAR_BUCKETS get their own bucket, above that
+// every power of two is split into SUB_BUCKETS, so any recorded value is within 1/SUB_BUCKETS (~1.6%) of its
+// bucket. Fixed size and allocation free, recording and removing are a few instructions.
+class HdrHistogram
+{
+public:
+    constexpr static uint32_t SUB_BUCKET_BITS = 6;
+    constexpr static uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    constexpr static uint32_t LINEAR_BUCKETS = SUB_BUCKETS * 2;
+    constexpr static uint32_t MAX_VALUE_BITS = 41; // ~36 minutes of nanoseconds, larger values are clamped.
+    constexpr static uint64_t MAX_VALUE = (uint64_t { 1 } << MAX_VALUE_BITS) - 1;
+    constexpr static uint32_t NUM_BUCKETS = LINEAR_BUCKETS + (MAX_VALUE_BITS - SUB_BUCKET_BITS - 1) * SUB_BUCKETS;
+
+    constexpr static auto bucket_index(uint64_t value) noexcept -> uint32_t {
+        value = std::min(value, MAX_VALUE);
+        if (value < LINEAR_BUCKETS) {
+            return static_cast<uint32_t>(value);
+        }
+        const auto shift = static_cast<uint32_t>(std::bit_width(value)) - SUB_BUCKET_BITS - 1;
+        const auto sub_bucket = static_cast<uint32_t>(value >> shift); // in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+        return LINEAR_BUCKETS + (shift - 1) * SUB_BUCKETS + (sub_bucket - SUB_BUCKETS);
+    }
+
+    // The middle of the bucket's range.
+    constexpr static auto bucket_value(uint32_t index) noexcept -> uint64_t {
+        if (index < LINEAR_BUCKETS) {
+            return index;
+        }
+        const uint32_t shift = (index - LINEAR_BUCKETS) / SUB_BUCKETS + 1;
+        const uint64_t sub_bucket = (index - LINEAR_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+        return (sub_bucket << shift) + ((uint64_t { 1 } << shift) >> 1);
+    }
+
+    void record(uint64_t value) noexcept {
+        ++_buckets[bucket_index(value)];
+        ++_count;
+        _total += value;
+    }
+
+    // Takes back a value that was recorded earlier, used to slide the window along.
+    void remove(uint64_t value) noexcept {
+        auto& bucket = _buckets[bucket_index(value)];
+        assert(bucket > 0 && _count > 0);
+        --bucket;
+        --_count;
+        _total -= value;
+    }
+
+    void merge(const HdrHistogram& other) noexcept {
+        for (uint32_t i = 0; i < NUM_BUCKETS; ++i) {
+            _buckets[i] += other._buckets[i];
+        }
+        _count += other._count;
+        _total += other._total;
+    }
+
+    [[nodiscard]] auto count() const noexcept -> uint64_t { return _count; }
+    [[nodiscard]] auto total() const noexcept -> uint64_t { return _total; }
+    [[nodiscard]] auto mean() const noexcept -> double {
+        return _count ? static_cast<double>(_total) / static_cast<double>(_count) : 0.0;
+    }
+
+    // e.g. percentile(99.0) is the p99. 0 when empty.
+    [[nodiscard]] auto percentile(double percent) const noexcept -> uint64_t {
+        if (_count == 0) {
+            return 0;
+        }
+        const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(_count))));
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < NUM_BUCKETS; ++i) {
+            seen += _buckets[i];
+            if (seen >= rank) {
+                return bucket_value(i);
+            }
+        }
+        return bucket_value(NUM_BUCKETS - 1);
+    }
+
+    [[nodiscard]] auto max() const noexcept -> uint64_t {
+        for (uint32_t i = NUM_BUCKETS; i-- > 0;) {
+            if (_buckets[i]) {
+                return bucket_value(i);
+            }
+        }
+        return 0;
+    }
+
+private:
+    std::array<uint32_t, NUM_BUCKETS> _buckets = {};
+    uint64_t _count = 0;
+    uint64_t _total = 0;
+};
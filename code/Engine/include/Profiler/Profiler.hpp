@@ -1,63 +1,383 @@
 #pragma once
 
+#include "Config.hpp"
+#include "Profiler/HdrHistogram.hpp"
+#include "Profiler/TraceFormat.hpp"
+
 #include <Utily/Utily.hpp>
-#include <map>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <source_location>
+#include <span>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b)       PROFILER_CONCAT_INNER(a, b)
+
+// Times the rest of the scope. The zone is interned once per call site, so entering it doesn't allocate or lock.
+// While the zone's category (or the whole profiler) is switched off it costs a single branch.
+//  e.g. PROFILER_ZONE("Core::Shader::init()", "rendering");
+#define PROFILER_ZONE(...)                                                                   \
+    static const Profiler::Zone PROFILER_CONCAT(profiler_zone_, __LINE__) { __VA_ARGS__ }; \
+    const Profiler::Timer PROFILER_CONCAT(profiler_timer_, __LINE__) { PROFILER_CONCAT(profiler_zone_, __LINE__) }
+
 class Profiler
 {
-private:
-    struct Recording {
-        std::string name;
-        std::chrono::time_point<std::chrono::high_resolution_clock> start_time;
-        std::chrono::time_point<std::chrono::high_resolution_clock> end_time;
-        std::thread::id thread_id;
-        std::vector<std::string_view> categories;
+public:
+    // A handle to an interned name & category. Usually made by PROFILER_ZONE, but can be made at runtime for
+    // dynamic names (e.g. TaskGraph nodes) as long as it's kept around rather than made per use.
+    class Zone
+    {
+    public:
+        Zone(std::string_view name, std::string_view category = {}, std::source_location location = std::source_location::current());
+
+        [[nodiscard]] auto id() const noexcept -> uint32_t { return _id; }
+        [[nodiscard]] auto is_recording() const noexcept -> bool { return _is_recording->load(std::memory_order_relaxed); }
+
+    private:
+        friend class Profiler;
+
+        uint32_t _id = 0;
+        const std::atomic<bool>* _is_recording = nullptr; // the category's flag, already and-ed with the global one.
     };
-    std::mutex _profiler_mutex;
-    std::string_view _current_process;
-    std::chrono::time_point<std::chrono::high_resolution_clock> _profiler_start_time;
-    std::unordered_map<std::string_view, std::vector<Recording>> _processes_recordings;
 
-public:
     class Timer
     {
     public:
-        std::string name;
-        std::chrono::time_point<std::chrono::high_resolution_clock> start_time;
-        std::chrono::time_point<std::chrono::high_resolution_clock> end_time;
-        std::thread::id thread_id;
-        std::vector<std::string_view> categories;
-
         Timer() = delete;
         Timer(const Timer&) = delete;
         Timer(Timer&&) = delete;
 
-        Timer(std::string function_name, std::vector<std::string_view> cats = {});
+        explicit Timer(const Zone& zone);
         ~Timer();
+
+        // Called by the operator new hook (CONFIG_TRACK_ALLOCATIONS), charges the thread's innermost recording timer.
+        static void count_allocation(size_t bytes) noexcept;
+
+    private:
+        int64_t _start_ticks;
+        uint32_t _zone_id;
+        bool _is_recording;
+        uint32_t _allocations;
+        uint64_t _allocated_bytes;
+        Timer* _parent; // the timer it's nested in on this thread, only kept while tracking allocations.
+    };
+
+    // A value-over-time track shown next to the zones, e.g. draw calls or bytes uploaded.
+    // Like a Zone, it's interned once and switched on/off with its category.
+    class Counter
+    {
+    public:
+        enum class Kind : uint8_t {
+            sample, // record() the current value whenever it changes.
+            per_frame, // add() to it during the frame, the total is recorded (and reset) by mark_frame().
+        };
+
+        Counter(std::string_view name, std::string_view category = {}, Kind kind = Kind::sample);
+
+        void record(int64_t value) const noexcept;
+        void add(int64_t amount) const noexcept {
+            if (is_recording()) {
+                _per_frame_total->fetch_add(amount, std::memory_order_relaxed);
+            }
+        }
+
+        [[nodiscard]] auto id() const noexcept -> uint32_t { return _id; }
+        [[nodiscard]] auto is_recording() const noexcept -> bool { return _is_recording->load(std::memory_order_relaxed); }
+
+    private:
+        friend class Profiler;
+
+        uint32_t _id = 0;
+        const std::atomic<bool>* _is_recording = nullptr;
+        std::atomic<int64_t>* _per_frame_total = nullptr; // only for Kind::per_frame.
     };
 
+    // What every thread writes into its ring buffer, names are looked up from the ids when exporting.
+    // Times are raw now_ticks(), only converted to nanoseconds on the way out.
+    // Counter samples share the rings, they're marked by COUNTER_BIT in the id and keep their value in end_ticks.
+    // GPU spans keep their TraceFormat::GPU_THREAD_INDEX through submit_event(), everything else gets the thread's.
+    struct Event {
+        constexpr static uint32_t COUNTER_BIT = 0x8000'0000;
+
+        int64_t start_ticks;
+        int64_t end_ticks;
+        uint32_t zone_id;
+        uint16_t process_id;
+        uint16_t thread_index;
+#if CONFIG_TRACK_ALLOCATIONS
+        // Only with CONFIG_TRACK_ALLOCATIONS, every other build keeps the rings 24 bytes an event.
+        uint32_t allocations = 0;
+        uint32_t allocated_bytes = 0; // saturates at 4GiB.
+#endif
+
+        [[nodiscard]] auto is_counter() const noexcept -> bool { return (zone_id & COUNTER_BIT) != 0; }
+        [[nodiscard]] auto is_gpu() const noexcept -> bool { return thread_index == TraceFormat::GPU_THREAD_INDEX; }
+        // When it finished, or for a counter when it was sampled.
+        [[nodiscard]] auto finish_ticks() const noexcept -> int64_t { return is_counter() ? start_ticks : end_ticks; }
+    };
+    static_assert(std::is_trivially_copyable_v<Event> && sizeof(Event) == (Config::TRACK_ALLOCATIONS ? 32 : 24));
+
     static auto instance() -> Profiler&;
 
+    // The invariant TSC where the CPU has one (x86), otherwise steady_clock nanoseconds. The TSC is calibrated
+    // against steady_clock, at startup and again whenever something is exported.
+    [[nodiscard]] static auto now_ticks() noexcept -> int64_t;
+    [[nodiscard]] auto ns_per_tick() const noexcept -> double;
+
+    // Can be flipped at any time from any thread, e.g. to look into a live instance. A zone that's already
+    // running when profiling is switched off still gets recorded. Zones without a category are under "".
+    void set_enabled(bool is_enabled);
+    [[nodiscard]] auto is_enabled() const noexcept -> bool { return _is_enabled.load(std::memory_order_relaxed); }
+    void set_category_enabled(std::string_view category, bool is_enabled);
+    [[nodiscard]] auto is_category_enabled(std::string_view category) -> bool;
+
     void switch_to_process(std::string_view process);
-    void submit_timer(const Timer& timer);
+    [[nodiscard]] auto current_process_id() const noexcept -> uint16_t { return _current_process_id.load(std::memory_order_relaxed); }
+    void submit_event(const Event& event);
+
+    // Moves every thread's buffered events into the recording.
+    void collect();
+
     auto format_as_trace_event_json() -> std::string;
     auto save_as_trace_event_json(std::filesystem::path path) -> Utily::Result<void, Utily::Error>;
 
+    // The compact format from TraceFormat.hpp, roughly 10 bytes an event rather than 150.
+    // Use the TraceConverter tool to turn it into Chrome JSON or a Perfetto trace.
+    auto format_as_binary_trace() -> std::string;
+    auto save_as_binary_trace(std::filesystem::path path) -> Utily::Result<void, Utily::Error>;
+
+    enum class TraceFileFormat : uint8_t {
+        json,
+        binary,
+    };
+
+    // Instead of keeping every event until the trace is saved, a background thread drains the thread buffers
+    // every flush_interval and appends them to the file, so memory stays flat on long runs.
+    // The file is closed off by stop_streaming() (or the destructor). Needs threads, so not on web.
+    auto start_streaming(
+        std::filesystem::path path,
+        std::chrono::milliseconds flush_interval = std::chrono::milliseconds(100),
+        TraceFileFormat format = TraceFileFormat::json)
+        -> Utily::Result<void, Utily::Error>;
+    void stop_streaming();
+    [[nodiscard]] auto is_streaming() -> bool;
+
+    // Always-on capture with fixed memory. Only the last `window` of events is kept (at most max_events), and
+    // whenever mark_frame() sees a frame over frame_budget the window is dumped as a binary trace, so the lead up
+    // to a rare hitch is on disk without recording the whole run. Can't be used while streaming.
+    struct FlightRecorderSettings {
+        std::chrono::milliseconds window;
+        std::chrono::microseconds frame_budget;
+        std::chrono::milliseconds dump_cooldown; // a hitch tends to come with more, and the dump itself is one.
+        size_t max_events;
+        std::filesystem::path dump_directory;
+    };
+    auto start_flight_recorder(FlightRecorderSettings settings) -> Utily::Result<void, Utily::Error>;
+    void stop_flight_recorder();
+    [[nodiscard]] auto is_flight_recording() -> bool;
+    auto dump_flight_recorder(std::filesystem::path path) -> Utily::Result<void, Utily::Error>;
+
+    // Rolling per-zone statistics over the last num_frames frames, cheap enough to poll every frame.
+    // Times are in nanoseconds, per_frame_ns is the average time spent in the zone each frame.
+    //  e.g. if (auto stats = profiler.zone_stats("FontBatchRenderer::end_batch()"); stats) { stats->p99_ns ... }
+    struct ZoneStats {
+        std::string name;
+        std::string category;
+        uint64_t count;
+        double mean_ns;
+        double p50_ns;
+        double p95_ns;
+        double p99_ns;
+        double max_ns;
+        double per_frame_ns;
+    };
+    void start_zone_stats(size_t num_frames);
+    void stop_zone_stats();
+    // Zones with the same name (e.g. one per TaskGraph node) are merged.
+    [[nodiscard]] auto zone_stats(std::string_view name) -> std::optional<ZoneStats>;
+    // Every zone seen in the window, most time per frame first.
+    [[nodiscard]] auto all_zone_stats() -> std::vector<ZoneStats>;
+
+    // Allocations made directly inside each zone (not in the zones nested in it), totalled since startup or the
+    // last reset. Only collected when built with CONFIG_TRACK_ALLOCATIONS, see Config.hpp.
+    //  e.g. EXPECT_EQ(profiler.allocation_stats("FontBatchRenderer::end_batch()")->allocations, 0);
+    struct AllocationStats {
+        std::string name;
+        std::string category;
+        uint64_t count; // times the zone was entered.
+        uint64_t allocations;
+        uint64_t allocated_bytes;
+    };
+    // Zones with the same name are merged, like zone_stats().
+    [[nodiscard]] auto allocation_stats(std::string_view name) -> std::optional<AllocationStats>;
+    // Every zone that allocated, most bytes first.
+    [[nodiscard]] auto all_allocation_stats() -> std::vector<AllocationStats>;
+    void reset_allocation_stats();
+
+    // Called once a frame by auto_run_app(), closes off the zone stats' frame. If the frame was over budget
+    // (and the flight recorder isn't cooling down) the flight recorder's window is dumped, returning where to.
+    auto mark_frame(std::chrono::nanoseconds frame_time) -> std::optional<std::filesystem::path>;
+
     constexpr static std::string_view TRACE_FILE_NAME = "app_trace.json";
 
 private:
-    Profiler()
-        : _profiler_mutex()
-        , _current_process("default")
-        , _profiler_start_time(std::chrono::high_resolution_clock::now())
-        , _processes_recordings({}) { }
+    // Single producer (the owning thread), single consumer (whoever holds _profiler_mutex).
+    // Handed to the next new thread once its owner exits, so short-lived threads don't keep adding buffers.
+    struct ThreadBuffer {
+        constexpr static size_t CAPACITY = 8192;
+
+        std::array<Event, CAPACITY> events;
+        alignas(64) std::atomic<uint64_t> write_index = 0;
+        alignas(64) std::atomic<uint64_t> read_index = 0;
+        uint16_t thread_index = 0;
+        bool is_owned = false; // guarded by _profiler_mutex.
+    };
+
+    // Heap allocated so zones can keep pointing at the flags.
+    struct Category {
+        std::string name;
+        std::atomic<bool> is_enabled = true;
+        std::atomic<bool> is_recording = true;
+    };
+
+    std::mutex _profiler_mutex;
+    std::atomic<bool> _is_enabled;
+    std::vector<std::unique_ptr<Category>> _categories; // guarded by _profiler_mutex.
+    std::atomic<uint16_t> _current_process_id;
+    struct ClockSample {
+        int64_t ticks;
+        int64_t ns;
+    };
+    constexpr static auto CALIBRATION_TIME = std::chrono::milliseconds(2);
+    ClockSample _clock_origin; // exported times are relative to this.
+    double _startup_ns_per_tick;
+    std::vector<std::string> _processes;
+    std::vector<TraceFormat::Zone> _zones;
+    std::vector<std::source_location> _zone_locations;
+    std::vector<TraceFormat::Zone> _counters;
+
+    struct PerFrameCounter {
+        uint32_t counter_id;
+        const std::atomic<bool>* is_recording;
+        std::atomic<int64_t> total = 0;
+    };
+    std::vector<std::unique_ptr<PerFrameCounter>> _per_frame_counters; // heap allocated so the handles can point in.
+    std::vector<Event> _per_frame_counter_events; // reused by mark_frame().
+    std::vector<std::unique_ptr<ThreadBuffer>> _thread_buffers; // index is the Event::thread_index.
+    std::vector<Event> _recorded_events;
+
+    struct Stream {
+        TraceFileFormat format;
+        std::ofstream file;
+        std::chrono::milliseconds flush_interval;
+        std::vector<Event> pending_events; // guarded by _profiler_mutex.
+
+        // Only touched by the writer thread, then by stop_streaming() once it's joined. Copies of the zone/process
+        // tables so it can format without the lock.
+        std::vector<TraceFormat::Zone> zones;
+        std::vector<TraceFormat::Zone> counters;
+        std::vector<std::string> processes;
+        size_t num_zones_written = 0;
+        size_t num_counters_written = 0;
+        size_t num_processes_written = 0;
+        TraceFormat::Writer binary_writer;
+        bool has_written_event = false;
+        // Swapped with the pending events, so both keep their capacity and the steady state doesn't allocate.
+        std::vector<Event> writing_events;
+        std::string writing;
+
+        std::mutex wake_mutex;
+        std::condition_variable wake;
+        bool is_stopping = false;
+        std::thread writer;
+    };
+    std::unique_ptr<Stream> _stream;
+
+    // Replaces _recorded_events while active, all guarded by _profiler_mutex.
+    struct FlightRecorder {
+        FlightRecorderSettings settings;
+        std::vector<Event> ring; // sized to settings.max_events up front.
+        int64_t window_ticks = 0;
+        size_t head = 0; // the oldest event.
+        size_t size = 0;
+        int64_t latest_end_ticks = 0;
+        std::optional<std::chrono::steady_clock::time_point> last_dump;
+        uint32_t num_dumps = 0;
+    };
+    std::unique_ptr<FlightRecorder> _flight_recorder;
+
+    // Each frame's durations are kept so they can be taken back out of the histograms once the frame is too old.
+    struct ZoneSample {
+        uint32_t zone_id;
+        uint64_t duration;
+    };
+    struct ZoneStatsWindow {
+        std::vector<std::vector<ZoneSample>> frames; // ring of frames, current_frame is still being recorded.
+        size_t current_frame = 0;
+        size_t num_frames_finished = 0;
+        std::vector<std::unique_ptr<HdrHistogram>> histograms; // by zone id, made on first use.
+    };
+    std::unique_ptr<ZoneStatsWindow> _zone_stats; // guarded by _profiler_mutex.
+
+    struct AllocationTotals {
+        uint64_t count = 0;
+        uint64_t allocations = 0;
+        uint64_t allocated_bytes = 0;
+    };
+    std::vector<AllocationTotals> _allocation_totals; // by zone id, guarded by _profiler_mutex.
+
+    void record_zone_stats_locked(const Event& event);
+    void advance_zone_stats_frame_locked();
+    auto make_zone_stats_locked(const HdrHistogram& histogram, uint32_t zone_id, double ns_per_tick) const -> ZoneStats;
+
+    void record_allocations_locked(const Event& event);
+
+    void record_flight_event_locked(const Event& event);
+    // What the exports write out, either _recorded_events or the flight recorder's window copied into `scratch`.
+    auto recorded_events_locked(std::vector<Event>& scratch) -> std::span<const Event>;
+    auto format_as_binary_trace_locked(std::span<const Event> events) -> std::string;
+
+    [[nodiscard]] auto to_trace_event(const Event& event, double ns_per_tick) const noexcept -> TraceFormat::Event;
+    [[nodiscard]] auto to_trace_counter_event(const Event& event, double ns_per_tick) const noexcept -> TraceFormat::CounterEvent;
+
+    // The name tables to format against, the profiler's own or the stream writer's copies.
+    struct TraceTables {
+        const std::vector<TraceFormat::Zone>& zones;
+        const std::vector<TraceFormat::Zone>& counters;
+        const std::vector<std::string>& processes;
+    };
+    void append_json_events(std::string& out, std::span<const Event> recorded_events, const TraceTables& tables, double ns_per_tick) const;
+    void append_binary_events(TraceFormat::Writer& writer, std::string& out, std::span<const Event> recorded_events, double ns_per_tick) const;
+    void stream_writer_main(Stream& stream);
+    // Writes out the pending events and any zones, counters or processes that are new since the last chunk.
+    void write_stream_chunk(Stream& stream);
+
+    void register_zone(Zone& zone, std::string_view name, std::string_view category, std::source_location location);
+    void register_counter(Counter& counter, std::string_view name, std::string_view category, Counter::Kind kind);
+    auto find_or_add_category_locked(std::string_view category) -> Category&;
+    struct ThreadBufferRelease;
+    auto register_thread() -> ThreadBuffer&;
+    void drain_locked(ThreadBuffer& buffer);
+    static auto sample_clocks() noexcept -> ClockSample;
+    void collect_locked();
 
+    Profiler();
     Profiler(const Profiler&) = delete;
     Profiler(Profiler&&) = delete;
 
 public:
     ~Profiler();
-};
\ No newline at end of file
+};
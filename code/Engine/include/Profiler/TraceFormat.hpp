@@ -0,0 +1,404 @@
+#pragma once
+
+#include <Utily/Utily.hpp>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// The profiler's compact binary trace, shared with the TraceConverter tool so keep it free of engine includes.
+//
+//  file    := MAGIC VERSION chunk* END
+//  chunk   := STRING         id:varint length:varint bytes
+//           | ZONE           id:varint name:string_id category:(string_id + 1, 0 if none)
+//           | PROCESS        id:varint name:string_id
+//           | EVENTS         count:varint event*
+//           | COUNTER        id:varint name:string_id category:(string_id + 1, 0 if none)     (version 2)
+//           | COUNTER_EVENTS count:varint counter_event*                                     (version 2)
+//  event          := zone:varint process:varint thread:varint start:zigzag(start - previous start) duration:varint
+//                    allocations:varint bytes:varint (version 3, bytes only when allocations != 0)
+//  counter_event  := counter:varint process:varint time:zigzag(time - previous time) value:zigzag
+//
+// Times are nanoseconds since the trace started. Strings/zones/processes are defined once before first use,
+// so a trace can be streamed out a chunk at a time.
+namespace TraceFormat {
+    constexpr static std::array<uint8_t, 4> MAGIC = { 'G', 'T', 'R', 'C' };
+    constexpr static uint8_t VERSION = 3;
+    constexpr static std::string_view FILE_EXTENSION = ".gtrace";
+    // Events timed on the GPU (GpuProfiler) go on a track of their own rather than the thread that read them back.
+    constexpr static uint16_t GPU_THREAD_INDEX = 0xFFFF;
+
+    enum class Tag : uint8_t {
+        string = 1,
+        zone,
+        process,
+        events,
+        end,
+        counter,
+        counter_events,
+    };
+
+    struct Event {
+        int64_t start_ns;
+        int64_t end_ns;
+        uint32_t zone_id;
+        uint16_t process_id;
+        uint16_t thread_index;
+        // Made directly inside the zone, only tracked with CONFIG_TRACK_ALLOCATIONS.
+        uint32_t allocations = 0;
+        uint64_t allocated_bytes = 0;
+    };
+
+    // A sample of a value-over-time track, e.g. draw calls in a frame.
+    struct CounterEvent {
+        int64_t time_ns;
+        int64_t value;
+        uint32_t counter_id;
+        uint16_t process_id;
+    };
+
+    // Also used for counters.
+    struct Zone {
+        std::string name;
+        std::string category;
+    };
+
+    struct Trace {
+        std::vector<Zone> zones;
+        std::vector<std::string> processes;
+        std::vector<Event> events;
+        std::vector<Zone> counters;
+        std::vector<CounterEvent> counter_events;
+    };
+
+    inline auto thread_name(uint16_t thread_index) -> std::string {
+        return thread_index == GPU_THREAD_INDEX ? std::string("GPU") : "Thread " + std::to_string(thread_index + 1);
+    }
+
+    inline void write_varint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    constexpr auto zigzag_encode(int64_t value) noexcept -> uint64_t {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+    constexpr auto zigzag_decode(uint64_t value) noexcept -> int64_t {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // Appends encoded chunks to `out`, deduplicating the strings it has already written.
+    class Writer
+    {
+    public:
+        void write_header(std::string& out) {
+            out.append(MAGIC.begin(), MAGIC.end());
+            out.push_back(static_cast<char>(VERSION));
+        }
+
+        void write_zone(std::string& out, uint32_t zone_id, std::string_view name, std::string_view category) {
+            const uint32_t name_id = intern(out, name);
+            const uint32_t category_id = category.empty() ? 0 : intern(out, category) + 1;
+            out.push_back(static_cast<char>(Tag::zone));
+            write_varint(out, zone_id);
+            write_varint(out, name_id);
+            write_varint(out, category_id);
+        }
+
+        void write_counter(std::string& out, uint32_t counter_id, std::string_view name, std::string_view category) {
+            const uint32_t name_id = intern(out, name);
+            const uint32_t category_id = category.empty() ? 0 : intern(out, category) + 1;
+            out.push_back(static_cast<char>(Tag::counter));
+            write_varint(out, counter_id);
+            write_varint(out, name_id);
+            write_varint(out, category_id);
+        }
+
+        void write_process(std::string& out, uint16_t process_id, std::string_view name) {
+            const uint32_t name_id = intern(out, name);
+            out.push_back(static_cast<char>(Tag::process));
+            write_varint(out, process_id);
+            write_varint(out, name_id);
+        }
+
+        void write_events(std::string& out, std::span<const Event> events) {
+            if (events.empty()) {
+                return;
+            }
+            out.push_back(static_cast<char>(Tag::events));
+            write_varint(out, events.size());
+            int64_t previous_start = 0;
+            for (const Event& event : events) {
+                write_varint(out, event.zone_id);
+                write_varint(out, event.process_id);
+                write_varint(out, event.thread_index);
+                write_varint(out, zigzag_encode(event.start_ns - previous_start));
+                write_varint(out, static_cast<uint64_t>(event.end_ns - event.start_ns));
+                write_varint(out, event.allocations);
+                if (event.allocations) {
+                    write_varint(out, event.allocated_bytes);
+                }
+                previous_start = event.start_ns;
+            }
+        }
+
+        void write_counter_events(std::string& out, std::span<const CounterEvent> events) {
+            if (events.empty()) {
+                return;
+            }
+            out.push_back(static_cast<char>(Tag::counter_events));
+            write_varint(out, events.size());
+            int64_t previous_time = 0;
+            for (const CounterEvent& event : events) {
+                write_varint(out, event.counter_id);
+                write_varint(out, event.process_id);
+                write_varint(out, zigzag_encode(event.time_ns - previous_time));
+                write_varint(out, zigzag_encode(event.value));
+                previous_time = event.time_ns;
+            }
+        }
+
+        void write_end(std::string& out) {
+            out.push_back(static_cast<char>(Tag::end));
+        }
+
+    private:
+        auto intern(std::string& out, std::string_view text) -> uint32_t {
+            auto [iter, is_new] = _string_ids.try_emplace(std::string(text), static_cast<uint32_t>(_string_ids.size()));
+            if (is_new) {
+                out.push_back(static_cast<char>(Tag::string));
+                write_varint(out, iter->second);
+                write_varint(out, text.size());
+                out.append(text);
+            }
+            return iter->second;
+        }
+
+        std::unordered_map<std::string, uint32_t> _string_ids;
+    };
+
+    // A stream that was cut short (no END chunk) still decodes everything up to the last complete chunk.
+    inline auto decode(std::span<const uint8_t> bytes) -> Utily::Result<Trace, Utily::Error> {
+        size_t pos = 0;
+        bool is_truncated = false;
+
+        auto read_varint = [&]() -> uint64_t {
+            uint64_t value = 0;
+            for (int shift = 0; pos < bytes.size() && shift < 64; shift += 7) {
+                const uint8_t byte = bytes[pos++];
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+            is_truncated = true;
+            return 0;
+        };
+
+        if (bytes.size() < MAGIC.size() + 1 || !std::equal(MAGIC.begin(), MAGIC.end(), bytes.begin())) {
+            return Utily::Error("Not a binary trace, the magic number doesn't match.");
+        }
+        // Newer versions only add chunks and fields, so older traces still decode.
+        const uint8_t version = bytes[MAGIC.size()];
+        if (version == 0 || version > VERSION) {
+            return Utily::Error("Unsupported binary trace version " + std::to_string(version) + ".");
+        }
+        pos = MAGIC.size() + 1;
+
+        Trace trace;
+        std::vector<std::string> strings;
+        // Everything is defined before it's used, so an id that isn't yet can only be corruption.
+        bool is_id_corrupt = false;
+        auto string_at = [&](uint64_t id) -> std::string {
+            if (id >= strings.size()) {
+                is_id_corrupt = true;
+                return {};
+            }
+            return strings[id];
+        };
+        auto check_id = [&](uint64_t id, size_t table_size) {
+            is_id_corrupt |= !is_truncated && id >= table_size;
+        };
+        // Ids are handed out densely, anything past the end of the file can only be corruption.
+        auto ensure_size = [&](auto& table, uint64_t id) -> bool {
+            if (id > bytes.size()) {
+                return false;
+            }
+            if (table.size() <= id) {
+                table.resize(id + 1);
+            }
+            return true;
+        };
+        const auto corrupt_id_error = Utily::Error("Corrupt binary trace, an id is out of range or used before it's defined.");
+
+        while (pos < bytes.size() && !is_truncated) {
+            const auto tag = static_cast<Tag>(bytes[pos++]);
+            switch (tag) {
+            case Tag::string: {
+                const uint64_t id = read_varint();
+                const uint64_t length = read_varint();
+                if (is_truncated || pos + length > bytes.size()) {
+                    is_truncated = true;
+                    break;
+                }
+                if (!ensure_size(strings, id)) {
+                    return corrupt_id_error;
+                }
+                strings[id].assign(reinterpret_cast<const char*>(bytes.data() + pos), length);
+                pos += length;
+                break;
+            }
+            case Tag::zone: {
+                const uint64_t id = read_varint();
+                const uint64_t name_id = read_varint();
+                const uint64_t category_id = read_varint();
+                if (!ensure_size(trace.zones, id)) {
+                    return corrupt_id_error;
+                }
+                trace.zones[id] = Zone { .name = string_at(name_id), .category = category_id ? string_at(category_id - 1) : std::string {} };
+                break;
+            }
+            case Tag::counter: {
+                const uint64_t id = read_varint();
+                const uint64_t name_id = read_varint();
+                const uint64_t category_id = read_varint();
+                if (!ensure_size(trace.counters, id)) {
+                    return corrupt_id_error;
+                }
+                trace.counters[id] = Zone { .name = string_at(name_id), .category = category_id ? string_at(category_id - 1) : std::string {} };
+                break;
+            }
+            case Tag::counter_events: {
+                const uint64_t count = read_varint();
+                int64_t previous_time = 0;
+                const size_t chunk_begin = trace.counter_events.size();
+                for (uint64_t i = 0; i < count && !is_truncated; ++i) {
+                    CounterEvent event {};
+                    const uint64_t counter_id = read_varint();
+                    const uint64_t process_id = read_varint();
+                    check_id(counter_id, trace.counters.size());
+                    check_id(process_id, trace.processes.size());
+                    event.counter_id = static_cast<uint32_t>(counter_id);
+                    event.process_id = static_cast<uint16_t>(process_id);
+                    event.time_ns = previous_time + zigzag_decode(read_varint());
+                    event.value = zigzag_decode(read_varint());
+                    previous_time = event.time_ns;
+                    trace.counter_events.push_back(event);
+                }
+                if (is_truncated) {
+                    trace.counter_events.resize(chunk_begin);
+                }
+                break;
+            }
+            case Tag::process: {
+                const uint64_t id = read_varint();
+                const uint64_t name_id = read_varint();
+                if (!ensure_size(trace.processes, id)) {
+                    return corrupt_id_error;
+                }
+                trace.processes[id] = string_at(name_id);
+                break;
+            }
+            case Tag::events: {
+                const uint64_t count = read_varint();
+                int64_t previous_start = 0;
+                const size_t chunk_begin = trace.events.size();
+                for (uint64_t i = 0; i < count && !is_truncated; ++i) {
+                    Event event {};
+                    const uint64_t zone_id = read_varint();
+                    const uint64_t process_id = read_varint();
+                    check_id(zone_id, trace.zones.size());
+                    check_id(process_id, trace.processes.size());
+                    event.zone_id = static_cast<uint32_t>(zone_id);
+                    event.process_id = static_cast<uint16_t>(process_id);
+                    event.thread_index = static_cast<uint16_t>(read_varint());
+                    event.start_ns = previous_start + zigzag_decode(read_varint());
+                    event.end_ns = event.start_ns + static_cast<int64_t>(read_varint());
+                    if (version >= 3) {
+                        event.allocations = static_cast<uint32_t>(read_varint());
+                        event.allocated_bytes = event.allocations ? read_varint() : 0;
+                    }
+                    previous_start = event.start_ns;
+                    trace.events.push_back(event);
+                }
+                if (is_truncated) {
+                    trace.events.resize(chunk_begin);
+                }
+                break;
+            }
+            case Tag::end:
+                return trace;
+            default:
+                return Utily::Error("Corrupt binary trace, unknown chunk tag " + std::to_string(static_cast<int>(tag)) + ".");
+            }
+            if (is_id_corrupt) {
+                return corrupt_id_error;
+            }
+        }
+        return trace;
+    }
+
+    // One Chrome trace-event "complete" event, followed by `,\n`. Allocations go in its args.
+    inline void append_chrome_json_event(std::string& out, const Event& event, const Zone& zone, std::string_view process) {
+        auto append_micros = [&out](int64_t nanoseconds) {
+            std::array<char, 32> chars;
+            auto [end, ec] = std::to_chars(chars.data(), chars.data() + chars.size(), static_cast<double>(nanoseconds) / 1000.0, std::chars_format::fixed, 3);
+            out.append(chars.data(), end);
+        };
+
+        if (event.allocations) {
+            out += "\t\t{ \"args\":{ \"allocations\":";
+            out += std::to_string(event.allocations);
+            out += ", \"allocated_bytes\":";
+            out += std::to_string(event.allocated_bytes);
+            out += " }, \"name\":\"";
+        } else {
+            out += "\t\t{ \"args\":{}, \"name\":\"";
+        }
+        out += zone.name;
+        if (zone.category.size()) {
+            out += "\", \"cat\":\"";
+            out += zone.category;
+        }
+        out += "\", \"ph\":\"X\", \"ts\":";
+        append_micros(event.start_ns);
+        out += ", \"dur\":";
+        append_micros(event.end_ns - event.start_ns);
+        out += ", \"pid\": \"";
+        out += process;
+        out += "\", \"tid\":\"";
+        out += thread_name(event.thread_index);
+        out += "\" },\n";
+    }
+
+    // A Chrome trace-event counter ("C") sample, followed by `,\n`. Counters are a track per name in each process.
+    inline void append_chrome_json_counter(std::string& out, const CounterEvent& event, const Zone& counter, std::string_view process) {
+        std::array<char, 32> chars;
+        out += "\t\t{ \"name\":\"";
+        out += counter.name;
+        if (counter.category.size()) {
+            out += "\", \"cat\":\"";
+            out += counter.category;
+        }
+        out += "\", \"ph\":\"C\", \"ts\":";
+        auto [ts_end, ts_ec] = std::to_chars(chars.data(), chars.data() + chars.size(), static_cast<double>(event.time_ns) / 1000.0, std::chars_format::fixed, 3);
+        out.append(chars.data(), ts_end);
+        out += ", \"pid\": \"";
+        out += process;
+        out += "\", \"args\":{ \"value\":";
+        auto [value_end, value_ec] = std::to_chars(chars.data(), chars.data() + chars.size(), event.value);
+        out.append(chars.data(), value_end);
+        out += " } },\n";
+    }
+
+    constexpr static std::string_view CHROME_JSON_BEGIN = "{ \n\t\"traceEvents\": [ \n";
+    constexpr static std::string_view CHROME_JSON_END = "\n\t]\n}";
+}
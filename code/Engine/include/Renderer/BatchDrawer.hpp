@@ -3,100 +3,253 @@
 #include "EntityComponents/EntityComponents.hpp"
 #include "Model/Static.hpp"
 #include "Core/IndexBuffer.hpp"
+#include "Core/Scheduler.hpp"
 #include "Core/Shader.hpp"
 #include "Core/Texture.hpp"
+#include "Core/TransformTexture.hpp"
 #include "Core/VertexArray.hpp"
 #include "Core/VertexBuffer.hpp"
+#include "Renderer/FrustumCuller.hpp"
+#include "Renderer/RenderQueue.hpp"
 
 #include <algorithm>
 #include <array>
-#include <cassert>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <tuple>
+#include <vector>
 
 namespace Renderer {
+    // The shader reads each model's transform with `fetch_transform(u_model_transforms, model_transform_index)`,
+    // see CORE_TRANSFORM_TEXTURE_GLSL. They're uploaded to a texture in one go, so a batch isn't capped by uniform space.
+    // BatchingVertex's indices are integer attributes, so declare them `in uint`.
     class BatchDrawer
     {
     public:
-        static auto to_3_digit(uint32_t num) noexcept -> std::array<char, 3> {
-            assert(num < 1000);
-            // via stack overflow: https://stackoverflow.com/a/1861020
-            std::array<char, 3> result = { '0', '0', '0' };
-            for (int i = result.size() - 1; i >= 0; i--) {
-                result[i] = static_cast<char>(num % 10) + '0';
-                num /= 10;
-            }
-            // could use std::from_chars but that requires a rotate so no thanks.
-            return result;
-        }
         using TexturedStaticModel = std::tuple<Model::Static&, Components::Transform&, Core::Texture&>;
+        // vb and ib are uploaded to on every call and drawn from when `render_queue` is submitted, so they have to be
+        // made with Core::Streaming to batch more than once a frame. The textures stay locked to their units until then.
+        // For meshes that don't change ResidentBatchDrawer only uploads the transforms.
+        // A batch reuses the transform texture from the last one, so there's one per BatchDrawer rather than per call.
 #if 1
         template <size_t N>
-        void batch(Core::VertexBuffer& vb, Core::IndexBuffer& ib, Core::VertexArray& va, Core::Shader& shader, std::array<TexturedStaticModel, N>& textured_models) {
+        void batch(RenderQueue& render_queue, Core::VertexBuffer& vb, Core::IndexBuffer& ib, Core::VertexArray& va, Core::Shader& shader, std::array<TexturedStaticModel, N>& textured_models) {
+            batch_models(render_queue, vb, ib, va, shader, std::span<TexturedStaticModel> { textured_models }, std::views::iota(size_t { 0 }, N));
+        }
+        // Only the models whose AABB is at least partly in `frustum` are copied, uploaded and drawn.
+        template <size_t N>
+        void batch(RenderQueue& render_queue, const Frustum& frustum, Core::VertexBuffer& vb, Core::IndexBuffer& ib, Core::VertexArray& va, Core::Shader& shader, std::array<TexturedStaticModel, N>& textured_models) {
+            batch_models(render_queue, vb, ib, va, shader, std::span<TexturedStaticModel> { textured_models }, cull(frustum, textured_models));
+        }
+
+        // Same as above, but the transforms and the per-vertex/index copies are split across the scheduler.
+        template <size_t N>
+        void batch(RenderQueue& render_queue, Core::Scheduler& scheduler, Core::VertexBuffer& vb, Core::IndexBuffer& ib, Core::VertexArray& va, Core::Shader& shader, std::array<TexturedStaticModel, N>& textured_models) {
+            batch_models(render_queue, scheduler, vb, ib, va, shader, std::span<TexturedStaticModel> { textured_models }, std::views::iota(size_t { 0 }, N));
+        }
+        template <size_t N>
+        void batch(RenderQueue& render_queue, Core::Scheduler& scheduler, const Frustum& frustum, Core::VertexBuffer& vb, Core::IndexBuffer& ib, Core::VertexArray& va, Core::Shader& shader, std::array<TexturedStaticModel, N>& textured_models) {
+            batch_models(render_queue, scheduler, vb, ib, va, shader, std::span<TexturedStaticModel> { textured_models }, cull(frustum, textured_models));
+        }
+#endif
+
+        void stop() noexcept {
+            _transforms.stop();
+            _is_transforms_init = false;
+            _model_transforms_shader = nullptr;
+        }
+
+    private:
+        constexpr static size_t COPY_GRAIN_SIZE = 4096;
+        constexpr static size_t TRANSFORM_GRAIN_SIZE = 256;
+
+        // The shader's `uniform highp sampler2D u_model_transforms`, indexed by BatchingVertex's model transform index.
+        constexpr static Core::UniformName MODEL_TRANSFORMS_UNIFORM = "u_model_transforms";
+
+        Core::TransformTexture _transforms;
+        bool _is_transforms_init = false;
+
+        // The shader the handle was looked up in, it's only looked up again when batching with another one.
+        Core::Shader* _model_transforms_shader = nullptr;
+        std::optional<int32_t> _model_transforms_program;
+        Core::UniformHandle<int32_t> _u_model_transforms;
+
+        FrustumCuller _culler;
+
+        auto cull(const Frustum& frustum, std::span<TexturedStaticModel> textured_models) -> std::span<const uint32_t> {
+            _culler.clear();
+            _culler.reserve(textured_models.size());
+            for (auto& [model, transform, texture] : textured_models) {
+                _culler.push(model.axis_align_bounding_box, transform.calc_transform_mat());
+            }
+            return _culler.cull(frustum);
+        }
+
+        // `model_indices` are the indices into textured_models of the ones in the batch, in the order they're batched.
+        template <typename Indices>
+            requires std::ranges::random_access_range<Indices> && std::ranges::sized_range<Indices>
+        void batch_models(RenderQueue& render_queue, Core::VertexBuffer& vb, Core::IndexBuffer& ib, Core::VertexArray& va, Core::Shader& shader, std::span<TexturedStaticModel> textured_models, const Indices& model_indices) {
             static std::vector<Model::BatchingVertex> vertices_buffer;
             static std::vector<Model::Index> indices_buffer;
 
+            const size_t num_models = std::ranges::size(model_indices);
+            if (num_models == 0) {
+                return;
+            }
+
             // Predetermine size for only one alloc.
-            const size_t total_vertex_count = std::reduce(
-                textured_models.begin(),
-                textured_models.end(),
-                size_t(0),
-                [](const size_t& agg, const auto& tm) { return agg + std::get<0>(tm).vertices.size(); });
-            const size_t total_index_count = std::reduce(
-                textured_models.begin(),
-                textured_models.end(),
-                size_t(0),
-                [](const size_t& agg, const auto& tm) { return agg + std::get<0>(tm).indices.size(); });
+            size_t total_vertex_count = 0;
+            size_t total_index_count = 0;
+            for (size_t m : model_indices) {
+                total_vertex_count += std::get<0>(textured_models[m]).vertices.size();
+                total_index_count += std::get<0>(textured_models[m]).indices.size();
+            }
             vertices_buffer.resize(total_vertex_count);
             indices_buffer.resize(total_index_count);
+            const auto transforms = render_queue.allocate<glm::mat4>(num_models);
 
-            shader.bind();
             va.bind();
             vb.bind();
             ib.bind();
 
-            // Move replacement info to compile time.
-            constexpr static std::string_view mm_uniform_string = "u_model_transfrom[$$$]";
-            constexpr static size_t mm_unifrom_string_size = mm_uniform_string.size();
-            constexpr static std::ptrdiff_t mm_uniform_replacement_offset = std::distance(mm_uniform_string.begin(), std::ranges::find(mm_uniform_string, '$'));
-
-            // Copy and ensure null ended string.
-            std::array<char, mm_unifrom_string_size + 1> mm_uniform { '\0' };
-            std::ranges::copy(mm_uniform_string, mm_uniform.begin());
-
             uint32_t i = 0;
             auto vert_iter = vertices_buffer.begin();
             auto indi_iter = indices_buffer.begin();
-            for (auto& [model, transform, texture] : textured_models) {
+            for (size_t m : model_indices) {
+                auto& [model, transform, texture] = textured_models[m];
                 const auto tex_unit = texture.bind(true).on_error(Utily::ErrorHandler::print_then_quit).value();
                 const auto index_offset = static_cast<Model::Index>(std::distance(vertices_buffer.begin(), vert_iter));
 
-                // Pass model transform as uniform.
-                auto i_chars = BatchDrawer::to_3_digit(i);
-                std::ranges::copy(i_chars, mm_uniform.data() + mm_uniform_replacement_offset);
-                shader.set_uniform(std::string_view { mm_uniform.data() }, transform.calc_transform_mat());
+                transforms[i] = transform.calc_transform_mat();
 
                 // Account for index offset
                 auto add_index_offset = [&](Model::Index index) { return index + index_offset; };
-                indi_iter = std::ranges::copy(model.indices | add_index_offset, indi_iter);
+                indi_iter = std::ranges::copy(model.indices | std::views::transform(add_index_offset), indi_iter).out;
 
                 // Add texture index and model transform index
                 auto add_tex_unit = [&](const Model::Vertex& v) { return Model::BatchingVertex { v.position, v.normal, v.uv_coord, tex_unit, i }; };
-                vert_iter = std::ranges::copy(model.vertices | add_tex_unit, vert_iter);
+                vert_iter = std::ranges::copy(model.vertices | std::views::transform(add_tex_unit), vert_iter).out;
 
                 ++i;
             }
 
-            // upload and draw.
+            // upload and queue.
+            ib.load_indices(indices_buffer);
+            vb.load_vertices(vertices_buffer);
+            push(render_queue, vb, ib, va, shader, transforms, textured_models, model_indices);
+        }
+
+        template <typename Indices>
+            requires std::ranges::random_access_range<Indices> && std::ranges::sized_range<Indices>
+        void batch_models(RenderQueue& render_queue, Core::Scheduler& scheduler, Core::VertexBuffer& vb, Core::IndexBuffer& ib, Core::VertexArray& va, Core::Shader& shader, std::span<TexturedStaticModel> textured_models, const Indices& model_indices) {
+            static std::vector<Model::BatchingVertex> vertices_buffer;
+            static std::vector<Model::Index> indices_buffer;
+
+            struct ModelOffsets {
+                size_t vertex;
+                size_t index;
+                uint32_t texture_unit;
+            };
+
+            const size_t num_models = std::ranges::size(model_indices);
+            if (num_models == 0) {
+                return;
+            }
+            const auto model_offsets = render_queue.allocate<ModelOffsets>(num_models);
+
+            va.bind();
+            vb.bind();
+            ib.bind();
+
+            // Offsets and texture units first, the GL calls have to stay on this thread.
+            size_t total_vertex_count = 0;
+            size_t total_index_count = 0;
+            for (size_t i = 0; i < num_models; ++i) {
+                auto& [model, transform, texture] = textured_models[model_indices[i]];
+                model_offsets[i] = ModelOffsets {
+                    .vertex = total_vertex_count,
+                    .index = total_index_count,
+                    .texture_unit = texture.bind(true).on_error(Utily::ErrorHandler::print_then_quit).value(),
+                };
+                total_vertex_count += model.vertices.size();
+                total_index_count += model.indices.size();
+            }
+            vertices_buffer.resize(total_vertex_count);
+            indices_buffer.resize(total_index_count);
+            const auto transforms = render_queue.allocate<glm::mat4>(num_models);
+
+            scheduler.parallel_transform(model_indices, transforms, TRANSFORM_GRAIN_SIZE, [&](size_t m) {
+                return std::get<1>(textured_models[m]).calc_transform_mat();
+            });
+
+            // Big models are split again by the inner parallel_for, small ones just run as one chunk.
+            scheduler.parallel_for(std::views::iota(size_t { 0 }, num_models), 1, [&](size_t i) {
+                const Model::Static& model = std::get<0>(textured_models[model_indices[i]]);
+                const ModelOffsets offsets = model_offsets[i];
+                const auto model_transform_index = static_cast<uint32_t>(i);
+
+                scheduler.parallel_for_chunks(model.vertices.size(), COPY_GRAIN_SIZE, [&](size_t first, size_t last) {
+                    for (size_t v = first; v < last; ++v) {
+                        const Model::Vertex& vertex = model.vertices[v];
+                        vertices_buffer[offsets.vertex + v] = Model::BatchingVertex {
+                            vertex.position, vertex.normal, vertex.uv_coord, offsets.texture_unit, model_transform_index
+                        };
+                    }
+                });
+                scheduler.parallel_for_chunks(model.indices.size(), COPY_GRAIN_SIZE, [&](size_t first, size_t last) {
+                    const auto index_offset = static_cast<Model::Index>(offsets.vertex);
+                    for (size_t n = first; n < last; ++n) {
+                        indices_buffer[offsets.index + n] = model.indices[n] + index_offset;
+                    }
+                });
+            });
+
+            // upload and queue.
             ib.load_indices(indices_buffer);
             vb.load_vertices(vertices_buffer);
-            glDrawElements(GL_TRIANGLES, ib.get_count(), GL_UNSIGNED_INT, (void*)0);
+            push(render_queue, vb, ib, va, shader, transforms, textured_models, model_indices);
+        }
 
-            // unlock the locked-bound textures.
-            for (auto& [model, texture] : textured_models) {
-                auto tex_unit = texture.bind(false).on_error(Utily::ErrorHandler::print_then_quit).value();
+        template <typename Indices>
+            requires std::ranges::random_access_range<Indices> && std::ranges::sized_range<Indices>
+        void push(RenderQueue& render_queue, Core::VertexBuffer& vb, Core::IndexBuffer& ib, Core::VertexArray& va, Core::Shader& shader, std::span<glm::mat4> transforms, std::span<TexturedStaticModel> textured_models, const Indices& model_indices) {
+            if (!_is_transforms_init) {
+                _transforms.init().on_error(Utily::ErrorHandler::print_then_quit);
+                _is_transforms_init = true;
             }
+            if (_model_transforms_shader != &shader || _model_transforms_program != shader.get_id()) {
+                _u_model_transforms = shader.uniform<int32_t>(MODEL_TRANSFORMS_UNIFORM).on_error(Utily::ErrorHandler::print_then_quit).value();
+                _model_transforms_shader = &shader;
+                _model_transforms_program = shader.get_id();
+            }
+            const auto textures = render_queue.allocate<Core::Texture*>(std::ranges::size(model_indices));
+            std::ranges::transform(model_indices, textures.begin(), [&](size_t m) { return &std::get<2>(textured_models[m]); });
+
+            render_queue.push(RenderQueue::DrawPacket {
+                .depth = render_queue.nearest_depth(transforms),
+                .shader = &shader,
+                .vertex_array = &va,
+                .vertex_buffer = &vb,
+                .vertex_offset = vb.get_offset(),
+                .index_count = static_cast<uint32_t>(ib.get_count()),
+                .index_offset = ib.get_offset(),
+                // textures is one per model like transforms, so only its pointer is captured to fit in the InlineTask.
+                .set_uniforms = [shader = &shader, model_transforms = &_transforms, u_model_transforms = _u_model_transforms, transforms, textures = textures.data()] {
+                    set_model_transforms(*shader, *model_transforms, u_model_transforms, transforms);
+                    // the units are baked into the vertices, so they're only unlocked once nothing else can bind.
+                    for (Core::Texture* texture : std::span { textures, transforms.size() }) {
+                        texture->unlock();
+                    }
+                },
+            });
+        }
+
+        static void set_model_transforms(Core::Shader& shader, Core::TransformTexture& model_transforms, Core::UniformHandle<int32_t> u_model_transforms, std::span<const glm::mat4> transforms) {
+            // One texture upload and one sampler uniform however many models there are.
+            model_transforms.load(transforms);
+            const auto unit = model_transforms.bind().on_error(Utily::ErrorHandler::print_then_quit).value();
+            shader.set(u_model_transforms, static_cast<int32_t>(unit));
         }
-#endif
     };
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 
 #include "Core/Core.hpp"
 #include "Media/Media.hpp"
+#include "Renderer/RenderQueue.hpp"
 #include "Renderer/ResourceManager.hpp"
 
 namespace Renderer {
@@ -9,6 +10,7 @@ namespace Renderer {
     public:
         struct BatchConfig {
             ResourceManager& resource_manager;
+            RenderQueue& render_queue; // drawn when it's submitted, over the world.
             glm::vec2 screen_dimensions;
             glm::vec4 font_colour;
         };
@@ -42,6 +44,9 @@ namespace Renderer {
             Renderer::ResourceHandle<Core::VertexBuffer> vb;
             Renderer::ResourceHandle<Core::IndexBuffer> ib;
             Renderer::ResourceHandle<Core::VertexArray> va;
+
+            Core::UniformHandle<int32_t> u_texture;
+            Core::UniformHandle<glm::vec4> u_colour;
         } _m;
 
         explicit FontBatchRenderer(M&& m)
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Core/Core.hpp"
+#include "Renderer/ResourceManager.hpp"
+
+#include <glm/glm.hpp>
+
+// The camera's uniform block, for pasting into shader sources next to the other string literals. Shaders using it
+// call `bind_uniform_block(FrameUniforms::CAMERA_BLOCK, FrameUniforms::CAMERA_BINDING)` once after init().
+#define RENDERER_CAMERA_BLOCK_GLSL      \
+    "layout(std140) uniform Camera {\n" \
+    "    mat4 u_view;\n"                \
+    "    mat4 u_proj;\n"                \
+    "    mat4 u_view_proj;\n"           \
+    "    vec3 u_camera_pos;\n"          \
+    "};\n"
+
+namespace Renderer {
+    // Per frame data every shader can read from a uniform buffer, uploaded once a frame instead of with
+    // set_uniform() on every shader that uses it.
+    class FrameUniforms
+    {
+    public:
+        constexpr static uint32_t CAMERA_BINDING = 0;
+        constexpr static std::string_view CAMERA_BLOCK = "Camera";
+
+        void init(ResourceManager& resource_manager);
+        void stop(ResourceManager& resource_manager);
+
+        // Before the draws that use it.
+        void set_camera(ResourceManager& resource_manager, const glm::mat4& projection, const glm::mat4& view, const glm::vec3& position);
+
+    private:
+        // Matches RENDERER_CAMERA_BLOCK_GLSL.
+        using CameraBlock = Core::Std140::Block<glm::mat4, glm::mat4, glm::mat4, glm::vec3>;
+        enum CameraMember : size_t {
+            view,
+            projection,
+            view_projection,
+            position,
+        };
+
+        Renderer::ResourceHandle<Core::UniformBuffer> _camera_ub;
+        CameraBlock _camera;
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Cameras/Cameras.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Renderer {
+    // Six planes facing inwards, normalised, a point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0.
+    struct Frustum {
+        // Left, right, bottom, top, near, far.
+        std::array<glm::vec4, 6> planes;
+
+        // Of GL's clip space, -w to w on every axis.
+        [[nodiscard]] static auto from_view_projection(const glm::mat4& view_projection) noexcept -> Frustum;
+
+        template <Cameras::IsCamera Camera>
+        [[nodiscard]] static auto from_camera(const Camera& camera, float width, float height) noexcept -> Frustum {
+            return from_view_projection(Cameras::get_mvp(camera.projection_matrix(width, height), camera.view_matrix()));
+        }
+    };
+
+    // Tests world space AABBs against a Frustum in batches, 8 at a time with AVX, 4 with SSE or wasm simd128.
+    // The boxes are kept as centres and half extents in separate arrays (SoA) so a batch is one load per component.
+    // Push every object each frame (or keep the ones that don't move and only push the rest), then cull() gives
+    // the indices of the ones that are at least partly inside, to draw just those.
+    // Conservative: boxes near a corner of the frustum can pass without being inside.
+    class FrustumCuller
+    {
+    public:
+        void clear() noexcept;
+        void reserve(size_t count);
+        [[nodiscard]] auto size() const noexcept -> size_t { return _center_x.size(); }
+
+        // A model space box (Model::Static::axis_align_bounding_box) moved by `transform`. Its index is the count
+        // pushed before it.
+        auto push(const std::array<glm::vec3, 2>& aabb, const glm::mat4& transform) -> uint32_t;
+        // Already in world space, min then max.
+        auto push(const std::array<glm::vec3, 2>& world_aabb) -> uint32_t;
+
+        // Ascending indices of the pushed boxes that aren't entirely outside one of the planes.
+        // Valid until the next cull() or clear().
+        [[nodiscard]] auto cull(const Frustum& frustum) -> std::span<const uint32_t>;
+
+        // The test cull() does per box, without SIMD.
+        [[nodiscard]] static auto is_visible(const Frustum& frustum, const glm::vec3& center, const glm::vec3& half_extent) noexcept -> bool;
+
+    private:
+        std::vector<float> _center_x, _center_y, _center_z;
+        std::vector<float> _extent_x, _extent_y, _extent_z;
+        std::vector<uint32_t> _visible;
+
+        // Writes the visible indices of the first boxes, as many as fit whole batches, returns how many it wrote.
+        [[nodiscard]] auto cull_batches(const Frustum& frustum, uint32_t* visible, size_t& num_tested) const noexcept -> size_t;
+    };
+}
@@ -2,6 +2,9 @@
 
 #include "Core/Core.hpp"
 #include "Media/Media.hpp"
+#include "Renderer/FrameUniforms.hpp"
+#include "Renderer/FrustumCuller.hpp"
+#include "Renderer/RenderQueue.hpp"
 #include "Renderer/ResourceManager.hpp"
 
 namespace Renderer {
@@ -12,7 +15,10 @@ namespace Renderer {
         void stop(ResourceManager& resource_manager);
 
         void push_instance(const glm::mat4& instance_transformation);
-        void draw_instances(ResourceManager& resource_manager, const glm::mat4& projection, const glm::mat4& view);
+        // Uses the camera from FrameUniforms::set_camera(). Drawn when `render_queue` is submitted.
+        void draw_instances(ResourceManager& resource_manager, RenderQueue& render_queue);
+        // Same, but only the instances whose model AABB is in `frustum`.
+        void draw_instances(ResourceManager& resource_manager, RenderQueue& render_queue, const Frustum& frustum);
     private:
         Renderer::ResourceHandle<Core::Shader> _s;
         Renderer::ResourceHandle<Core::Texture> _t;
@@ -20,7 +26,10 @@ namespace Renderer {
         Renderer::ResourceHandle<Core::VertexBuffer> _vb_transforms; // the matrix transformation of each instance.
         Renderer::ResourceHandle<Core::IndexBuffer> _ib;
         Renderer::ResourceHandle<Core::VertexArray> _va;
+        Core::UniformHandle<int32_t> _u_texture;
 
         std::vector<glm::mat4> _current_instances;
+        std::array<glm::vec3, 2> _aabb;
+        FrustumCuller _culler;
     };
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Core/InlineTask.hpp"
+#include "Core/Shader.hpp"
+#include "Core/Texture.hpp"
+#include "Core/VertexArray.hpp"
+#include "Core/VertexBuffer.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Renderer {
+
+    // Draws are pushed as they're made and submitted together at the end of the frame, sorted by a 64-bit key.
+    // So draws sharing a shader and texture run back to back whatever order they were pushed in, opaque ones
+    // front to back within those (for early-z) and translucent ones back to front (for blending).
+    // Neighbours after the sort that share all their state and whose indices follow on are merged into one draw.
+    // GL thread only. AppRenderer has one that App::render() submits after Logic::draw().
+    class RenderQueue
+    {
+    public:
+        // Submitted in this order, before anything else in the key. There's room for 16.
+        enum class Pass : uint8_t {
+            world = 0,
+            overlay = 1,
+        };
+
+        struct DrawPacket {
+            Pass pass = Pass::world;
+            bool is_translucent = false;
+            bool is_depth_tested = true;
+            // View space distance to the camera, only the order matters. Negative counts as 0. See nearest_depth().
+            float depth = 0;
+
+            Core::Shader* shader = nullptr;
+            Core::VertexArray* vertex_array = nullptr;
+            // For a streaming vertex buffer, the offset its data was at when the draw was pushed (get_offset()),
+            // as it'll have moved on by the time it's submitted.
+            Core::VertexBuffer* vertex_buffer = nullptr;
+            size_t vertex_offset = 0;
+
+            // Bound to a unit whose index is set on texture_uniform.
+            Core::Texture* texture = nullptr;
+            Core::UniformHandle<int32_t> texture_uniform {};
+
+            uint32_t index_count = 0;
+            size_t index_offset = 0; // in bytes, into the vertex array's index buffer.
+            uint32_t instance_count = 1;
+
+            // Run once the shader's bound, for uniforms that differ per draw. Anything it reads has to last until
+            // submit(), see allocate(). Packets with one are never merged.
+            Core::InlineTask set_uniforms {};
+            // Makes the packet's draw calls itself in place of the one above, for multi-draws. It's called once the
+            // state's set and has to add its own draw calls to EngineCounters::draw_calls(). Never merged either.
+            Core::InlineTask draw {};
+        };
+
+        // 4 bits of pass, 1 of translucency, then for opaque draws 12 bits of shader, 16 of texture and 31 of depth.
+        // Translucent draws move the depth (inverted) ahead of the shader and texture so they're back to front.
+        [[nodiscard]] static auto make_key(const DrawPacket& packet) noexcept -> uint64_t;
+
+        struct SortItem {
+            uint64_t key;
+            uint32_t index;
+        };
+        // Least significant byte first, skipping bytes that are the same in every key. Stable. `scratch` is resized.
+        static void radix_sort(std::vector<SortItem>& items, std::vector<SortItem>& scratch) noexcept;
+
+        // Whether `next` can be drawn with the same call as `last`, straight after it.
+        [[nodiscard]] static auto can_merge(const DrawPacket& last, const DrawPacket& next) noexcept -> bool;
+
+        // The camera depths are measured from, set before pushing anything. Identity until it's set.
+        void set_view(const glm::mat4& view) noexcept { _view = view; }
+        // View space depth of the nearest of the transforms' origins, for DrawPacket::depth. 0 if there are none.
+        [[nodiscard]] auto nearest_depth(std::span<const glm::mat4> transforms) const noexcept -> float;
+
+        void push(DrawPacket&& packet);
+
+        // Memory that lasts until the next submit(), for the data a packet's set_uniforms reads.
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        [[nodiscard]] auto allocate(size_t count) -> std::span<T> {
+            return { reinterpret_cast<T*>(allocate_bytes(count * sizeof(T), alignof(T))), count };
+        }
+
+        // Sorts what's been pushed since the last submit(), into the order it'll be drawn in. `index` is the push order.
+        auto sort() noexcept -> std::span<const SortItem>;
+
+        // Sorts, binds and draws everything pushed since the last submit(), then clears the queue.
+        void submit();
+
+        struct Stats {
+            size_t num_packets;
+            size_t num_draws; // after merging, a packet with its own draw counts as one.
+        };
+        // Of the last submit().
+        [[nodiscard]] auto stats() const noexcept -> Stats { return _stats; }
+
+    private:
+        constexpr static size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+        struct ArenaBlock {
+            std::unique_ptr<std::byte[]> data;
+            size_t size;
+        };
+
+        std::vector<DrawPacket> _packets;
+        std::vector<SortItem> _items;
+        std::vector<SortItem> _scratch;
+        glm::mat4 _view { 1.0f };
+
+        // Blocks are kept between frames, only the cursor is reset.
+        std::vector<ArenaBlock> _arena;
+        size_t _arena_block = 0;
+        size_t _arena_used = 0;
+
+        Stats _stats = {};
+
+        auto allocate_bytes(size_t size, size_t alignment) -> std::byte*;
+        static void draw(const DrawPacket& packet, uint32_t index_count) noexcept;
+    };
+}
@@ -9,9 +9,16 @@ namespace Renderer {
     
     class ResourceManager;
     class FontRenderer;
+    class FrameUniforms;
+    class RenderQueue;
+    class ResidentBatchDrawer;
 }
 
 #include "Renderer/ResourceHandle.hpp"
 #include "Renderer/ResourceManager.hpp"
+#include "Renderer/RenderQueue.hpp"
 #include "Renderer/FontBatchRenderer.hpp"
 #include "Renderer/InstanceRenderer.hpp"
+#include "Renderer/FrameUniforms.hpp"
+#include "Renderer/FrustumCuller.hpp"
+#include "Renderer/ResidentBatchDrawer.hpp"
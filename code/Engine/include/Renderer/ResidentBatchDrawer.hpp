@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Core/Core.hpp"
+#include "Model/Static.hpp"
+#include "Renderer/RenderQueue.hpp"
+#include "Renderer/ResourceManager.hpp"
+
+#include <glm/glm.hpp>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+// Defines BATCH_DRAW_INDEX, the uint index of the draw within a ResidentBatchDrawer batch. It's gl_DrawIDARB where the
+// driver has ARB_shader_draw_parameters, so a whole batch is one glMultiDrawElementsBaseVertex, otherwise the
+// `u_draw_index` uniform that's set before each draw. #extension has to come before anything else, so this goes at
+// the very start of the vertex shader.
+#if defined(CONFIG_TARGET_NATIVE)
+#define RENDERER_BATCH_DRAW_INDEX_GLSL                    \
+    "#extension GL_ARB_shader_draw_parameters : enable\n" \
+    "#if defined(GL_ARB_shader_draw_parameters)\n"        \
+    "#define BATCH_DRAW_INDEX uint(gl_DrawIDARB)\n"       \
+    "#else\n"                                             \
+    "uniform int u_draw_index;\n"                         \
+    "#define BATCH_DRAW_INDEX uint(u_draw_index)\n"       \
+    "#endif\n"
+#else
+#define RENDERER_BATCH_DRAW_INDEX_GLSL              \
+    "uniform int u_draw_index;\n"                   \
+    "#define BATCH_DRAW_INDEX uint(u_draw_index)\n"
+#endif
+
+// Reads draw `draw`'s texture unit from a ResidentBatchDrawer's transform texture, where the units come after the
+// `u_num_draws` transforms, 16 to a matrix. Goes after CORE_TRANSFORM_TEXTURE_GLSL.
+#define RENDERER_BATCH_TEXTURE_UNIT_GLSL                                           \
+    "uniform int u_num_draws;\n"                                                   \
+    "int fetch_texture_unit(highp sampler2D sampler, uint draw) {\n"               \
+    "    mat4 units = fetch_transform(sampler, uint(u_num_draws) + draw / 16u);\n" \
+    "    return int(units[(draw % 16u) / 4u][draw % 4u]);\n"                       \
+    "}\n"
+
+namespace Renderer {
+    // The BatchDrawer for meshes that don't change. They're uploaded once by add_mesh() and stay in one vertex and
+    // index buffer, so a frame only uploads each draw's transform and texture unit, not every vertex and index.
+    // The shader takes plain Model::Vertex, and reads its transform with
+    // `fetch_transform(u_model_transforms, BATCH_DRAW_INDEX)` from a `uniform highp sampler2D u_model_transforms`,
+    // see CORE_TRANSFORM_TEXTURE_GLSL and RENDERER_BATCH_DRAW_INDEX_GLSL. Its texture unit, if it wants it, is
+    // `fetch_texture_unit(u_model_transforms, BATCH_DRAW_INDEX)` from RENDERER_BATCH_TEXTURE_UNIT_GLSL.
+    // WebGL2 has no base vertex draws, so there it's a draw per mesh with the attributes moved to each mesh's vertices.
+    class ResidentBatchDrawer
+    {
+    public:
+        struct MeshHandle {
+            uint32_t index = UINT32_MAX;
+        };
+        struct Draw {
+            MeshHandle mesh;
+            glm::mat4 transform;
+            Core::Texture* texture = nullptr; // locked to its unit until the batch is drawn.
+        };
+
+        void init(ResourceManager& resource_manager);
+        void stop(ResourceManager& resource_manager);
+
+        // Meshes are kept in memory as well, every one is uploaded again on the next draw() after adding one.
+        // So add them up front rather than between frames.
+        auto add_mesh(const Model::Static& model) -> MeshHandle;
+
+        // Queues every draw as one packet, drawn with one texture upload and one multi-draw however many there are.
+        void draw(ResourceManager& resource_manager, RenderQueue& render_queue, Core::Shader& shader, std::span<const Draw> draws);
+
+    private:
+        constexpr static Core::UniformName MODEL_TRANSFORMS_UNIFORM = "u_model_transforms";
+        constexpr static Core::UniformName NUM_DRAWS_UNIFORM = "u_num_draws";
+        constexpr static Core::UniformName DRAW_INDEX_UNIFORM = "u_draw_index";
+        constexpr static size_t TEXTURE_UNITS_PER_MATRIX = 16; // matches RENDERER_BATCH_TEXTURE_UNIT_GLSL.
+
+        struct Mesh {
+            uint32_t index_count;
+            size_t first_index;
+            int32_t base_vertex;
+        };
+
+        // The optional ones are only there if the shader uses them.
+        struct Uniforms {
+            Core::UniformHandle<int32_t> model_transforms;
+            std::optional<Core::UniformHandle<int32_t>> num_draws;
+            std::optional<Core::UniformHandle<int32_t>> draw_index;
+        };
+
+        // What the packet's draw needs, in the queue's memory.
+        struct Batch {
+            Core::Shader* shader;
+            Core::VertexArray* vertex_array;
+            Core::VertexBuffer* vertex_buffer;
+            Core::TransformTexture* transform_texture;
+            Uniforms uniforms;
+
+            std::span<const glm::mat4> draw_data; // the transforms, then the texture units, see RENDERER_BATCH_TEXTURE_UNIT_GLSL.
+            std::span<Core::Texture* const> textures;
+            std::span<const int32_t> index_counts;
+            std::span<const void* const> index_offsets;
+            std::span<const int32_t> base_vertices;
+        };
+
+        Renderer::ResourceHandle<Core::VertexBuffer> _vb;
+        Renderer::ResourceHandle<Core::IndexBuffer> _ib;
+        Renderer::ResourceHandle<Core::VertexArray> _va;
+
+        std::vector<Model::Vertex> _vertices;
+        std::vector<Model::Index> _indices;
+        std::vector<Mesh> _meshes;
+        bool _has_new_meshes = false;
+
+        // One per drawer like BatchDrawer's, it's uploaded to when each batch is drawn.
+        Core::TransformTexture _transforms;
+
+        // The shader the handles were looked up in, they're only looked up again when drawing with another one.
+        Core::Shader* _uniforms_shader = nullptr;
+        std::optional<int32_t> _uniforms_program;
+        Uniforms _uniforms;
+
+        auto uniforms(Core::Shader& shader) -> const Uniforms&;
+
+        static void draw_batch(const Batch& batch);
+    };
+}
@@ -33,6 +33,7 @@ namespace Renderer {
         constexpr static size_t MAX_VB = 32;
         constexpr static size_t MAX_VA = 32;
         constexpr static size_t MAX_IB = 32;
+        constexpr static size_t MAX_UB = 8;
 
 #if 1
         Utily::StaticVector<Core::Shader, MAX_S> _shaders;
@@ -40,12 +41,14 @@ namespace Renderer {
         Utily::StaticVector<Core::VertexArray, MAX_VA> _vertex_arrays;
         Utily::StaticVector<Core::IndexBuffer, MAX_IB> _index_buffers;
         Utily::StaticVector<Core::VertexBuffer, MAX_VB> _vertex_buffers;
+        Utily::StaticVector<Core::UniformBuffer, MAX_UB> _uniform_buffers;
 #else
         std::vector<Core::Shader> _shaders;
         std::vector<Core::Texture> _textures;
         std::vector<Core::VertexArray> _vertex_arrays;
         std::vector<Core::IndexBuffer> _index_buffers;
         std::vector<Core::VertexBuffer> _vertex_buffers;
+        std::vector<Core::UniformBuffer> _uniform_buffers;
 #endif
 
         size_t _owner_id;
@@ -62,6 +65,8 @@ namespace Renderer {
                 return _vertex_buffers;
             } else if constexpr (std::same_as<T, Core::IndexBuffer>) {
                 return _index_buffers;
+            } else if constexpr (std::same_as<T, Core::UniformBuffer>) {
+                return _uniform_buffers;
             } else {
                 throw std::runtime_error("That resource is not mapped.");
             }
@@ -6,7 +6,7 @@ namespace Core {
 
     auto AudioManager::init() -> Utily::Result<void, Utily::Error> {
 
-        Profiler::Timer timer("Core::AudioManager::init()");
+        PROFILER_ZONE("Core::AudioManager::init()");
 
         if (_has_init) {
             return Utily::Error("Trying to reinitialise AudioManager.");
@@ -28,7 +28,7 @@ namespace Core {
     }
 
     auto AudioManager::init_device() -> Utily::Result<void, Utily::Error> {
-        Profiler::Timer timer("Core::AudioManager::init_device()");
+        PROFILER_ZONE("Core::AudioManager::init_device()");
 
         if (_device) {
             return Utily::Error("The sound device has already been initialised.");
@@ -42,7 +42,7 @@ namespace Core {
     }
     auto AudioManager::init_context() -> Utily::Result<void, Utily::Error> {
 
-        Profiler::Timer timer("Core::AudioManager::init_context()");
+        PROFILER_ZONE("Core::AudioManager::init_context()");
 
         if (_context) {
             return Utily::Error("The openal context has already been initialised.");
@@ -73,7 +73,7 @@ namespace Core {
         return {};
     }
     auto AudioManager::init_buffers() -> Utily::Result<void, Utily::Error> {
-        Profiler::Timer timer("Core::AudioManager::init_buffers()");
+        PROFILER_ZONE("Core::AudioManager::init_buffers()");
 
         if (_buffers.size()) {
             return Utily::Error("The sound buffers have already been initialised.");
@@ -109,7 +109,7 @@ namespace Core {
         return {};
     }
     auto AudioManager::init_sources() -> Utily::Result<void, Utily::Error> {
-        Profiler::Timer timer("Core::AudioManager::init_sources()");
+        PROFILER_ZONE("Core::AudioManager::init_sources()");
 
         if (_sources.size()) {
             return Utily::Error("The sound sources have already been initialised.");
@@ -198,7 +198,7 @@ namespace Core {
     }
 
     auto AudioManager::load_sound_into_buffer(const Media::Sound& sound) -> Utily::Result<BufferHandle, Utily::Error> {
-        Profiler::Timer timer("Core::AudioManager::load_sound_into_buffer()");
+        PROFILER_ZONE("Core::AudioManager::load_sound_into_buffer()");
 
         if constexpr (Config::DEBUG_LEVEL != Config::DebugInfo::none) {
             if (!_has_init) {
@@ -238,7 +238,7 @@ namespace Core {
     }
 
     auto AudioManager::play_sound(BufferHandle buffer_handle, glm::vec3 pos, glm::vec3 vel) -> Utily::Result<Core::AudioManager::SourceHandle, Utily::Error> {
-        Profiler::Timer timer("Core::AudioManager::play_sound()");
+        PROFILER_ZONE("Core::AudioManager::play_sound()");
 
         if constexpr (Config::DEBUG_LEVEL != Config::DebugInfo::none) {
             if (!_has_init) {
@@ -280,7 +280,7 @@ namespace Core {
                 alSource3f(source.id, AL_POSITION, pos.x, pos.y, pos.z);
                 alSource3f(source.id, AL_VELOCITY, vel.x, vel.y, vel.z);
                 {
-                    Profiler::Timer player("alSourcePlay()");
+                    PROFILER_ZONE("alSourcePlay()");
                     alSourcePlay(source.id);
                 }
 
@@ -300,7 +300,7 @@ namespace Core {
     }
 
     void AudioManager::set_listener_properties(const ListenerProperties& listener_properties) {
-        Profiler::Timer timer("Core::AudioManager::set_listener_properties()");
+        PROFILER_ZONE("Core::AudioManager::set_listener_properties()");
 
         constexpr static auto default_val = glm::vec3(std::numeric_limits<float>::min());
         static ListenerProperties last = { default_val, default_val, default_val };
@@ -320,11 +320,18 @@ namespace Core {
         }
     }
 
+    auto AudioManager::num_active_sources() const -> size_t {
+        const auto now = std::chrono::steady_clock::now();
+        return std::ranges::count_if(_sources, [&now](const Source& source) {
+            return source.expected_finish && now <= source.expected_finish.value();
+        });
+    }
+
     auto AudioManager::set_source_motion(SourceHandle source_handle, glm::vec3 pos, glm::vec3 vel) -> Utily::Result<void, Utily::Error> {
-        Profiler::Timer timer("Core::AudioManager::set_source_motion()");
+        PROFILER_ZONE("Core::AudioManager::set_source_motion()");
 
         if constexpr (Config::DEBUG_LEVEL != Config::DebugInfo::none) {
-            Profiler::Timer timer2("alIsSource() *debug*");
+            PROFILER_ZONE("alIsSource() *debug*");
             if (source_handle.index >= _sources.size()) {
                 return Utily::Error("Core::AudioManager::set_source_motion() failed. The source is out of range.");
             } else if (!alIsSource(this->_sources[source_handle.index].id)) {
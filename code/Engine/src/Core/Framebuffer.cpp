@@ -1,4 +1,5 @@
 #include "Core/FrameBuffer.hpp"
+#include "Core/GlState.hpp"
 
 #include "Profiler/Profiler.hpp"
 #include <array>
@@ -81,6 +82,7 @@ namespace Core {
     void FrameBuffer::stop() noexcept {
         if (_id.value_or(INVALID_BUFFER_ID) != INVALID_BUFFER_ID) {
             glDeleteFramebuffers(1, &_id.value());
+            GlState::instance().forget_framebuffer(_id.value());
         }
         _id = std::nullopt;
 
@@ -102,7 +104,7 @@ namespace Core {
             }
         }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, _id.value_or(INVALID_BUFFER_ID));
+        GlState::instance().bind_framebuffer(_id.value_or(INVALID_BUFFER_ID));
     }
 
     void FrameBuffer::unbind() noexcept {
@@ -115,26 +117,26 @@ namespace Core {
             }
         }
 
-        glBindBuffer(GL_FRAMEBUFFER, 0);
+        GlState::instance().bind_framebuffer(0);
     }
 
     uint32_t ScreenFrameBuffer::width = 0;
     uint32_t ScreenFrameBuffer::height = 0;
 
     void ScreenFrameBuffer::clear(glm::vec4 colour) noexcept {
-        Profiler::Timer timer("Core::ScreenFrameBuffer::clear()", { "rendering" });
+        PROFILER_ZONE("Core::ScreenFrameBuffer::clear()", "rendering");
         ScreenFrameBuffer::bind();
         glClearColor(colour.x, colour.y, colour.z, colour.w);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
     void ScreenFrameBuffer::bind() noexcept {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        GlState::instance().bind_framebuffer(0);
     }
     void ScreenFrameBuffer::resize(uint32_t screen_width, uint32_t screen_height) noexcept {
         if (screen_width != ScreenFrameBuffer::width || screen_height != ScreenFrameBuffer::height) {
-            Profiler::Timer timer("Core::ScreenFrameBuffer::resize()", { "rendering" });
+            PROFILER_ZONE("Core::ScreenFrameBuffer::resize()", "rendering");
             ScreenFrameBuffer::bind();
-            glViewport(0, 0, screen_width, screen_height);
+            GlState::instance().viewport(0, 0, static_cast<int32_t>(screen_width), static_cast<int32_t>(screen_height));
             ScreenFrameBuffer::width = screen_width;
             ScreenFrameBuffer::height = screen_height;
         }
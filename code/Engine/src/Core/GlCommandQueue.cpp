@@ -0,0 +1,67 @@
+#include "Core/GlCommandQueue.hpp"
+
+#include "Profiler/Profiler.hpp"
+
+#include <utility>
+
+namespace Core {
+    GlCommandQueue::GlCommandQueue() {
+        Node* stub = new Node {};
+        _head.store(stub, std::memory_order_relaxed);
+        _tail = stub;
+    }
+
+    void GlCommandQueue::push(Command command) {
+        Node* node = new Node { .next = nullptr, .command = std::move(command) };
+        // Producers are serialised by the exchange, the link is published after. Until then the consumer just
+        // sees the queue as ending at prev, so nothing is lost.
+        Node* prev = _head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    auto GlCommandQueue::try_run_one() -> bool {
+        Node* tail = _tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        _tail = next;
+        delete tail;
+
+        Command command = std::move(next->command);
+        command();
+        return true;
+    }
+
+    auto GlCommandQueue::drain(std::chrono::nanoseconds budget) -> size_t {
+        PROFILER_ZONE("Core::GlCommandQueue::drain()", "rendering");
+
+        const auto deadline = std::chrono::steady_clock::now() + budget;
+        size_t num_run = 0;
+        while (try_run_one()) {
+            ++num_run;
+            if (std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+        return num_run;
+    }
+
+    auto GlCommandQueue::drain_all() -> size_t {
+        size_t num_run = 0;
+        while (try_run_one()) {
+            ++num_run;
+        }
+        return num_run;
+    }
+
+    GlCommandQueue::~GlCommandQueue() {
+        // Anything left over is dropped without running, the GL context is gone by now.
+        Node* node = _tail;
+        while (node != nullptr) {
+            Node* next = node->next.load(std::memory_order_acquire);
+            delete node;
+            node = next;
+        }
+    }
+}
@@ -0,0 +1,239 @@
+#include "Core/GlState.hpp"
+
+#include "Config.hpp"
+#include "Profiler/EngineCounters.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Core {
+    GlState::GlState() {
+        reset();
+    }
+
+    void GlState::reset() noexcept {
+        _program = UNKNOWN;
+        _vertex_array = UNKNOWN;
+        std::ranges::fill(_element_buffers, UNKNOWN);
+        std::ranges::fill(_buffers, UNKNOWN);
+        std::ranges::fill(_uniform_bindings, UNKNOWN);
+        _framebuffer = UNKNOWN;
+        _active_texture = UNKNOWN;
+        std::ranges::fill(_capabilities, uint8_t { 2 });
+        std::ranges::fill(_blend_func, UNKNOWN);
+        _depth_func = UNKNOWN;
+        std::ranges::fill(_viewport, -1);
+        // A new context has nothing bound, the units are set up again on first use.
+        _texture_units.reset(0);
+        if (_num_texture_units_in_use != 0) {
+            _num_texture_units_in_use = 0;
+            EngineCounters::texture_units_in_use().record(0);
+        }
+    }
+
+    template <typename T>
+    auto GlState::is_change(T& shadow, const T& value) noexcept -> bool {
+        if (shadow == value) {
+            ++_stats.num_redundant_calls;
+            EngineCounters::redundant_gl_calls().add(1);
+            return false;
+        }
+        shadow = value;
+        ++_stats.num_calls;
+        EngineCounters::gl_state_changes().add(1);
+        return true;
+    }
+
+    void GlState::use_program(uint32_t program) noexcept {
+        if (is_change(_program, program)) {
+            glUseProgram(program);
+        }
+    }
+
+    void GlState::bind_vertex_array(uint32_t vertex_array) noexcept {
+        if (is_change(_vertex_array, vertex_array)) {
+            glBindVertexArray(vertex_array);
+        }
+    }
+
+    auto GlState::element_buffer_slot() noexcept -> uint32_t* {
+        if (_vertex_array == UNKNOWN) {
+            return nullptr;
+        }
+        if (_element_buffers.size() <= _vertex_array) {
+            _element_buffers.resize(_vertex_array + 1, UNKNOWN);
+        }
+        return &_element_buffers[_vertex_array];
+    }
+
+    auto GlState::buffer_slot(uint32_t target) noexcept -> uint32_t* {
+        switch (target) {
+        case GL_ARRAY_BUFFER:
+            return &_buffers[static_cast<size_t>(BufferSlot::array)];
+        case GL_UNIFORM_BUFFER:
+            return &_buffers[static_cast<size_t>(BufferSlot::uniform)];
+#if defined(CONFIG_TARGET_NATIVE)
+        case GL_TEXTURE_BUFFER:
+            return &_buffers[static_cast<size_t>(BufferSlot::texture)];
+#endif
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return element_buffer_slot();
+        default:
+            return nullptr;
+        }
+    }
+
+    void GlState::bind_buffer(uint32_t target, uint32_t buffer) noexcept {
+        uint32_t* shadow = buffer_slot(target);
+        if (shadow == nullptr || is_change(*shadow, buffer)) {
+            glBindBuffer(target, buffer);
+        }
+    }
+
+    void GlState::bind_buffer_base(uint32_t target, uint32_t index, uint32_t buffer) noexcept {
+        uint32_t* shadow = nullptr;
+        if (target == GL_UNIFORM_BUFFER && index < NUM_UNIFORM_BINDINGS) {
+            shadow = &_uniform_bindings[index];
+        }
+        if (shadow == nullptr || is_change(*shadow, buffer)) {
+            glBindBufferBase(target, index, buffer);
+            if (uint32_t* generic = buffer_slot(target); generic) {
+                *generic = buffer;
+            }
+        }
+    }
+
+    void GlState::bind_framebuffer(uint32_t framebuffer) noexcept {
+        if (is_change(_framebuffer, framebuffer)) {
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        }
+    }
+
+    void GlState::active_texture(uint32_t unit) noexcept {
+        if (is_change(_active_texture, unit)) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+        }
+    }
+
+    void GlState::set_enabled(uint32_t capability, bool is_enabled) noexcept {
+        uint8_t* shadow = nullptr;
+        switch (capability) {
+        case GL_BLEND:
+            shadow = &_capabilities[0];
+            break;
+        case GL_CULL_FACE:
+            shadow = &_capabilities[1];
+            break;
+        case GL_DEPTH_TEST:
+            shadow = &_capabilities[2];
+            break;
+        default:
+            break;
+        }
+        if (shadow == nullptr || is_change(*shadow, static_cast<uint8_t>(is_enabled))) {
+            if (is_enabled) {
+                glEnable(capability);
+            } else {
+                glDisable(capability);
+            }
+        }
+    }
+
+    void GlState::blend_func(uint32_t source, uint32_t destination) noexcept {
+        if (is_change(_blend_func, { source, destination })) {
+            glBlendFunc(source, destination);
+        }
+    }
+
+    void GlState::depth_func(uint32_t func) noexcept {
+        if (is_change(_depth_func, func)) {
+            glDepthFunc(func);
+        }
+    }
+
+    void GlState::viewport(int32_t x, int32_t y, int32_t width, int32_t height) noexcept {
+        if (is_change(_viewport, { x, y, width, height })) {
+            glViewport(x, y, width, height);
+        }
+    }
+
+    void GlState::init_texture_units() noexcept {
+        int32_t max_texture_units = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &max_texture_units);
+        _texture_units.reset(static_cast<size_t>(std::max<int32_t>(max_texture_units, 1)));
+    }
+
+    auto GlState::acquire_texture_unit(uint32_t texture, std::optional<uint32_t> hint, bool is_locked) noexcept
+        -> Utily::Result<uint32_t, Utily::Error> {
+        if (_texture_units.size() == 0) {
+            init_texture_units();
+        }
+
+        auto result = _texture_units.acquire(texture, hint, is_locked);
+        if (result.has_error()) {
+            return result.error();
+        }
+        const TextureUnitLru::Acquired acquired = result.value();
+        active_texture(acquired.unit);
+        if (!acquired.is_bind_needed) {
+            ++_stats.num_redundant_calls;
+            EngineCounters::redundant_gl_calls().add(1);
+            return acquired.unit;
+        }
+        if (acquired.was_empty) {
+            EngineCounters::texture_units_in_use().record(++_num_texture_units_in_use);
+        }
+        glBindTexture(GL_TEXTURE_2D, texture);
+        ++_stats.num_calls;
+        EngineCounters::gl_state_changes().add(1);
+        return acquired.unit;
+    }
+
+    void GlState::unlock_texture_unit(uint32_t texture, uint32_t unit) noexcept {
+        _texture_units.unlock(texture, unit);
+    }
+
+    void GlState::release_texture_unit(uint32_t texture, uint32_t unit) noexcept {
+        if (!_texture_units.release(texture, unit)) {
+            return;
+        }
+        EngineCounters::texture_units_in_use().record(--_num_texture_units_in_use);
+
+        active_texture(unit);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        ++_stats.num_calls;
+        EngineCounters::gl_state_changes().add(1);
+    }
+
+    void GlState::forget_program(uint32_t program) noexcept {
+        if (_program == program) {
+            _program = UNKNOWN;
+        }
+    }
+
+    void GlState::forget_vertex_array(uint32_t vertex_array) noexcept {
+        if (_vertex_array == vertex_array) {
+            _vertex_array = UNKNOWN;
+        }
+        if (vertex_array < _element_buffers.size()) {
+            _element_buffers[vertex_array] = UNKNOWN;
+        }
+    }
+
+    void GlState::forget_buffer(uint32_t buffer) noexcept {
+        auto forget = [buffer](uint32_t& shadow) {
+            if (shadow == buffer) {
+                shadow = UNKNOWN;
+            }
+        };
+        std::ranges::for_each(_buffers, forget);
+        std::ranges::for_each(_uniform_bindings, forget);
+        std::ranges::for_each(_element_buffers, forget);
+    }
+
+    void GlState::forget_framebuffer(uint32_t framebuffer) noexcept {
+        if (_framebuffer == framebuffer) {
+            _framebuffer = UNKNOWN;
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include "Core/IndexBuffer.hpp"
+#include "Core/GlState.hpp"
 
 #include <utility>
 
@@ -7,7 +8,9 @@ namespace Core {
 
     IndexBuffer::IndexBuffer(IndexBuffer&& other) noexcept
         : _id(std::exchange(other._id, std::nullopt))
-        , _count(std::exchange(other._count, 0)) {
+        , _stream(std::exchange(other._stream, std::nullopt))
+        , _count(std::exchange(other._count, 0))
+        , _offset(std::exchange(other._offset, 0)) {
     }
 
     auto IndexBuffer::init() noexcept -> Utily::Result<void, Utily::Error> {
@@ -26,14 +29,27 @@ namespace Core {
         return {};
     }
 
+    auto IndexBuffer::init(Streaming streaming) noexcept -> Utily::Result<void, Utily::Error> {
+        if (auto result = init(); result.has_error()) {
+            return result.error();
+        }
+        // The element array binding belongs to the vertex array, so this is bound to one that's only used here.
+        GlState::instance().bind_buffer(GL_COPY_WRITE_BUFFER, _id.value());
+        _stream.emplace().init(GL_COPY_WRITE_BUFFER, streaming.bytes_per_frame);
+        return {};
+    }
+
     void IndexBuffer::stop() noexcept {
         Core::DebugOpRecorder::instance().push("Core::IndexBuffer", "stop()");
 
         if (_id.value_or(INVALID_INDEX_BUFFER_ID) != INVALID_INDEX_BUFFER_ID) {
             glDeleteBuffers(1, &_id.value());
+            GlState::instance().forget_buffer(_id.value());
         }
         _id = std::nullopt;
+        _stream = std::nullopt;
         _count = 0;
+        _offset = 0;
     }
 
     void IndexBuffer::bind() noexcept {
@@ -45,7 +61,7 @@ namespace Core {
                 assert(false);
             }
         }
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _id.value_or(INVALID_INDEX_BUFFER_ID));
+        GlState::instance().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, _id.value_or(INVALID_INDEX_BUFFER_ID));
     }
 
     void IndexBuffer::unbind() noexcept {
@@ -59,7 +75,7 @@ namespace Core {
                 assert(false);
             }
         }
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        GlState::instance().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     }
 
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Core/OpenglContext.hpp"
 
 #include "Config.hpp"
+#include "Core/GlState.hpp"
 
 #include <cassert>
 #include <iostream>
@@ -108,7 +109,7 @@ static void GLAPIENTRY openglDebugCallback(
 #endif
 
 static void framebufferSizeCallback(GLFWwindow* window [[maybe_unused]], int width, int height) {
-    glViewport(0, 0, width, height);
+    Core::GlState::instance().viewport(0, 0, width, height);
 }
 
 namespace Core {
@@ -125,18 +126,18 @@ namespace Core {
 #endif
 
     auto OpenglContext::init(std::string_view app_name, uint_fast16_t width, uint_fast16_t height) -> Utily::Result<void, Utily::Error> {
-        Profiler::Timer timer("Core::OpenglContext::init()", { "OpenglContext" });
+        PROFILER_ZONE("Core::OpenglContext::init()", "OpenglContext");
 
 #if defined(CONFIG_TARGET_NATIVE)
         {
-            Profiler::Timer timer("glfwInit()");
+            PROFILER_ZONE("glfwInit()");
             if (glfwInit() == GLFW_FALSE) {
                 return Utily::Error("GLFW3 failed to be initialised");
             }
         }
 
         {
-            Profiler::Timer timer("glfwCreateWindow()");
+            PROFILER_ZONE("glfwCreateWindow()");
             if (_window.has_value()) {
                 return {};
             }
@@ -168,14 +169,14 @@ namespace Core {
         }
 
         {
-            Profiler::Timer timer("glfwInit()");
+            PROFILER_ZONE("glfwInit()");
             if (glfwInit() == GLFW_FALSE) {
                 return Utily::Error("GLFW3 failed to be initialised");
             }
         }
 
         {
-            Profiler::Timer timer("glfwCreateWindow()");
+            PROFILER_ZONE("glfwCreateWindow()");
 
             if (_window.has_value()) {
                 return {};
@@ -198,7 +199,7 @@ namespace Core {
 
 #ifdef CONFIG_TARGET_NATIVE
         {
-            Profiler::Timer timer("glewInit()");
+            PROFILER_ZONE("glewInit()");
             glewExperimental = GL_TRUE;
             if (glewInit() != GLEW_OK) {
                 return Utily::Error("Glew failed to be initialised");
@@ -214,12 +215,15 @@ namespace Core {
 #endif
 
         glfwSetFramebufferSizeCallback(*_window, framebufferSizeCallback);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-        glEnable(GL_CULL_FACE);
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LESS);
+        auto& gl_state = GlState::instance();
+        gl_state.reset();
+        gl_state.set_enabled(GL_BLEND, true);
+        gl_state.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        gl_state.set_enabled(GL_CULL_FACE, true);
+        gl_state.set_enabled(GL_DEPTH_TEST, true);
+        gl_state.depth_func(GL_LESS);
 
         validate_window();
 
@@ -233,13 +237,13 @@ namespace Core {
 
     void OpenglContext::stop() {
 #if defined(CONFIG_TARGET_NATIVE)
-        Profiler::Timer timer("Core::OpenglContext::stop()");
+        PROFILER_ZONE("Core::OpenglContext::stop()");
         if (_window) {
-            Profiler::Timer window_timer("glfwDestroyWindow()");
+            PROFILER_ZONE("glfwDestroyWindow()");
             glfwDestroyWindow(_window.value());
             _window = std::nullopt;
         }
-        Profiler::Timer glfw_timer("glfwTerminate()");
+        PROFILER_ZONE("glfwTerminate()");
         glfwTerminate();
         DebugOpRecorder::instance().stop();
 
@@ -247,20 +251,20 @@ namespace Core {
     }
 
     void OpenglContext::swap_buffers() noexcept {
-        Profiler::Timer timer("OpenglContext::swap_buffers()", { "OpenglContext" });
+        PROFILER_ZONE("OpenglContext::swap_buffers()", "OpenglContext");
         validate_window();
         glfwSwapBuffers(*_window);
     }
 
     void OpenglContext::poll_events() {
-        Profiler::Timer timer("OpenglContext::poll_events()", { "OpenglContext" });
+        PROFILER_ZONE("OpenglContext::poll_events()", "OpenglContext");
         validate_window();
         {
-            Profiler::Timer timer2("glfwPollEvents()", { "OpenglContext" });
+            PROFILER_ZONE("glfwPollEvents()", "OpenglContext");
             glfwPollEvents();
         }
         {
-            Profiler::Timer timer3("glfwGetWindowSize()", { "OpenglContext" });
+            PROFILER_ZONE("glfwGetWindowSize()", "OpenglContext");
             int width, height;
             glfwGetWindowSize(*_window, &width, &height);
             window_width = static_cast<uint_fast16_t>(width);
@@ -0,0 +1,392 @@
+#include "Core/Scheduler.hpp"
+
+#include "Profiler/Profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <utility>
+
+namespace Core {
+    // Which scheduler and worker the calling thread is running for, so add_task() can push onto its own queue.
+    static thread_local const void* t_scheduler_shared = nullptr;
+    static thread_local size_t t_scheduler_worker_index = 0;
+    // Lane of the task currently running on this thread, children split off by parallel_for() inherit it.
+    static thread_local Scheduler::Priority t_scheduler_priority = Scheduler::Priority::normal;
+
+    Scheduler::WorkerQueue::WorkerQueue() {
+        _ring.resize(INITIAL_QUEUE_CAPACITY);
+    }
+
+    void Scheduler::WorkerQueue::lock() noexcept {
+        while (_lock.test_and_set(std::memory_order_acquire)) {
+            while (_lock.test(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void Scheduler::WorkerQueue::grow() {
+        std::vector<Task> larger(_ring.size() * 2);
+        const size_t size = _size.load(std::memory_order_relaxed);
+        const size_t mask = _ring.size() - 1;
+        for (size_t i = 0; i < size; ++i) {
+            larger[i] = std::move(_ring[(_head + i) & mask]);
+        }
+        _ring = std::move(larger);
+        _head = 0;
+    }
+
+    void Scheduler::WorkerQueue::push_back(Task&& task) {
+        lock();
+        const size_t size = _size.load(std::memory_order_relaxed);
+        if (size == _ring.size()) [[unlikely]] {
+            grow();
+        }
+        _ring[(_head + size) & (_ring.size() - 1)] = std::move(task);
+        // seq_cst pairs with the sleeping workers' check in run_until_idle().
+        _size.store(size + 1, std::memory_order_seq_cst);
+        unlock();
+    }
+
+    auto Scheduler::WorkerQueue::pop_back() -> std::optional<Task> {
+        if (is_empty()) {
+            return std::nullopt;
+        }
+        lock();
+        std::optional<Task> task = std::nullopt;
+        if (const size_t size = _size.load(std::memory_order_relaxed); size) {
+            task.emplace(std::move(_ring[(_head + size - 1) & (_ring.size() - 1)]));
+            _size.store(size - 1, std::memory_order_relaxed);
+        }
+        unlock();
+        return task;
+    }
+
+    auto Scheduler::WorkerQueue::steal_front() -> std::optional<Task> {
+        if (is_empty()) {
+            return std::nullopt;
+        }
+        lock();
+        std::optional<Task> task = std::nullopt;
+        if (const size_t size = _size.load(std::memory_order_relaxed); size) {
+            task.emplace(std::move(_ring[_head]));
+            _head = (_head + 1) & (_ring.size() - 1);
+            _size.store(size - 1, std::memory_order_relaxed);
+        }
+        unlock();
+        return task;
+    }
+
+    auto Scheduler::create(size_t num_threads) -> std::optional<Scheduler> {
+        static_assert(std::has_single_bit(INITIAL_QUEUE_CAPACITY), "The queue's ring buffer is masked, must be a power of 2.");
+
+        if constexpr (Config::PLATFORM == Config::TargetPlatform::web) {
+            num_threads = 0;
+        }
+
+        auto shared = std::make_unique<Shared>();
+        shared->workers.resize(num_threads + 1);
+        for (uint32_t i = 0; auto& worker : shared->workers) {
+            worker = std::make_unique<Worker>();
+            worker->rng_state = 0x9E3779B9u * (++i);
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (size_t i = 1; i <= num_threads; ++i) {
+            threads.emplace_back([shared = shared.get(), i]() { worker_thread_main(*shared, i); });
+        }
+
+        return Scheduler(M {
+            .shared = std::move(shared),
+            .threads = std::move(threads),
+            .next_worker = 0,
+        });
+    }
+
+    void Scheduler::notify_new_work(Shared& shared) noexcept {
+        if (shared.sleeping_workers.load(std::memory_order_seq_cst) > 0) {
+            shared.work_epoch.fetch_add(1, std::memory_order_seq_cst);
+            shared.work_epoch.notify_all();
+        }
+    }
+
+    void Scheduler::add_task(Task task, Priority priority) {
+        Shared& shared = *_m.shared;
+        const auto lane = static_cast<size_t>(priority);
+
+        if (t_scheduler_shared == &shared) {
+            // Spawned from a running task (or the launching thread), keep it local.
+            shared.workers[t_scheduler_worker_index]->queues[lane].push_back(std::move(task));
+            notify_new_work(shared);
+            return;
+        }
+        if (shared.is_launched.load(std::memory_order_acquire)) {
+            throw std::runtime_error("trying to add task from a thread outside of the launched scheduler");
+        }
+        // Not launched yet, so round-robin to give every worker something to start on.
+        shared.workers[_m.next_worker]->queues[lane].push_back(std::move(task));
+        _m.next_worker = (_m.next_worker + 1) % shared.workers.size();
+    }
+
+    auto Scheduler::is_background_allowed(const Shared& shared) noexcept -> bool {
+        const auto deadline = shared.frame_deadline.load(std::memory_order_relaxed);
+        return std::chrono::steady_clock::now().time_since_epoch().count() < deadline;
+    }
+
+    auto Scheduler::has_queued_tasks(const Shared& shared) noexcept -> bool {
+        // Background work past the deadline doesn't count, it's left for the next batch.
+        const size_t num_lanes = is_background_allowed(shared) ? NUM_PRIORITIES : NUM_PRIORITIES - 1;
+        return std::ranges::any_of(shared.workers, [num_lanes](const auto& worker) {
+            for (size_t lane = 0; lane < num_lanes; ++lane) {
+                if (!worker->queues[lane].is_empty(std::memory_order_seq_cst)) {
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+
+    auto Scheduler::steal_task(Shared& shared, size_t worker_index, Priority priority) -> std::optional<Task> {
+        Worker& self = *shared.workers[worker_index];
+        const auto lane = static_cast<size_t>(priority);
+
+        // Random victims, xorshift32 is plenty for picking who to steal from.
+        const size_t num_workers = shared.workers.size();
+        for (size_t attempt = 0; attempt < num_workers * 2; ++attempt) {
+            self.rng_state ^= self.rng_state << 13;
+            self.rng_state ^= self.rng_state >> 17;
+            self.rng_state ^= self.rng_state << 5;
+            const size_t victim = self.rng_state % num_workers;
+            if (victim == worker_index) {
+                continue;
+            }
+            if (auto task = shared.workers[victim]->queues[lane].steal_front(); task) {
+                return task;
+            }
+        }
+        return std::nullopt;
+    }
+
+    auto Scheduler::find_task(Shared& shared, size_t worker_index) -> std::optional<FoundTask> {
+        Worker& self = *shared.workers[worker_index];
+
+        // A whole lane, local then stolen, before looking at the next one down.
+        for (size_t lane = 0; lane < NUM_PRIORITIES; ++lane) {
+            const auto priority = static_cast<Priority>(lane);
+            if (priority == Priority::background && !is_background_allowed(shared)) {
+                break;
+            }
+            if (auto task = self.queues[lane].pop_back(); task) {
+                return FoundTask { std::move(*task), priority };
+            }
+            if (auto task = steal_task(shared, worker_index, priority); task) {
+                return FoundTask { std::move(*task), priority };
+            }
+        }
+        return std::nullopt;
+    }
+
+    void Scheduler::run_task(Task& task, Priority priority) {
+        PROFILER_ZONE("Scheduler::Task()");
+        const Priority outer_priority = std::exchange(t_scheduler_priority, priority);
+        task();
+        t_scheduler_priority = outer_priority;
+    }
+
+    void Scheduler::run_until_idle(Shared& shared, size_t worker_index) {
+        t_scheduler_shared = &shared;
+        t_scheduler_worker_index = worker_index;
+
+        const size_t num_workers = shared.workers.size();
+
+        for (;;) {
+            if (auto found = find_task(shared, worker_index); found) {
+                run_task(found->task, found->priority);
+                continue;
+            }
+
+            // Tasks are only ever pushed by busy workers, so once every worker is idle nothing can be left.
+            if (shared.idle_workers.fetch_add(1, std::memory_order_seq_cst) + 1 == num_workers) {
+                shared.work_epoch.fetch_add(1, std::memory_order_seq_cst);
+                shared.work_epoch.notify_all();
+                break;
+            }
+
+            bool found_work = false;
+            for (size_t spins = 0; !found_work; ++spins) {
+                if (shared.idle_workers.load(std::memory_order_seq_cst) == num_workers) {
+                    break;
+                }
+                if (has_queued_tasks(shared)) {
+                    shared.idle_workers.fetch_sub(1, std::memory_order_seq_cst);
+                    found_work = true;
+                } else if (spins < IDLE_SPINS_BEFORE_PARKING) {
+                    std::this_thread::yield();
+                } else {
+                    // Park until someone pushes work or the batch finishes. The epoch is read before re-checking,
+                    // so a notify between the check and the wait makes the wait return immediately.
+                    shared.sleeping_workers.fetch_add(1, std::memory_order_seq_cst);
+                    const uint32_t epoch = shared.work_epoch.load(std::memory_order_seq_cst);
+                    if (shared.idle_workers.load(std::memory_order_seq_cst) != num_workers && !has_queued_tasks(shared)) {
+                        shared.work_epoch.wait(epoch, std::memory_order_seq_cst);
+                    }
+                    shared.sleeping_workers.fetch_sub(1, std::memory_order_seq_cst);
+                }
+            }
+            if (!found_work) {
+                break;
+            }
+        }
+        t_scheduler_shared = nullptr;
+    }
+
+    void Scheduler::worker_thread_main(Shared& shared, size_t worker_index) {
+        uint32_t last_batch = 0;
+        for (;;) {
+            shared.batch_epoch.wait(last_batch, std::memory_order_acquire);
+            last_batch = shared.batch_epoch.load(std::memory_order_acquire);
+
+            if (shared.is_stopping.load(std::memory_order_acquire)) {
+                return;
+            }
+            run_until_idle(shared, worker_index);
+            shared.finished_workers.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    void Scheduler::launch_threads() {
+        Shared& shared = *_m.shared;
+        if (shared.is_launched.load(std::memory_order_acquire)) {
+            return;
+        }
+        shared.idle_workers.store(0, std::memory_order_relaxed);
+        shared.finished_workers.store(0, std::memory_order_relaxed);
+
+        // Release what was held back for this frame before the workers wake.
+        {
+            std::scoped_lock lock { shared.deferred_mutex };
+            for (auto& [task, priority] : shared.next_frame_tasks) {
+                shared.workers[_m.next_worker]->queues[static_cast<size_t>(priority)].push_back(std::move(task));
+                _m.next_worker = (_m.next_worker + 1) % shared.workers.size();
+            }
+            shared.next_frame_tasks.clear();
+        }
+        shared.is_launched.store(true, std::memory_order_release);
+
+        // The launching thread is workers[0], it joins in once it calls wait_for_threads().
+        t_scheduler_shared = &shared;
+        t_scheduler_worker_index = 0;
+
+        // Wake the parked pool.
+        shared.batch_epoch.fetch_add(1, std::memory_order_release);
+        shared.batch_epoch.notify_all();
+    }
+
+    void Scheduler::wait_for_threads() {
+        Shared& shared = *_m.shared;
+        if (!shared.is_launched.load(std::memory_order_acquire)) {
+            launch_threads();
+        }
+
+        // get the main thread going too.
+        run_until_idle(shared, 0);
+
+        // Every worker has seen the batch finish, wait for them to get back to parking before the next launch.
+        while (shared.finished_workers.load(std::memory_order_acquire) != _m.threads.size()) {
+            std::this_thread::yield();
+        }
+        _m.next_worker = 0;
+        shared.is_launched.store(false, std::memory_order_release);
+    }
+
+    void Scheduler::set_frame_deadline(std::chrono::steady_clock::time_point deadline) noexcept {
+        _m.shared->frame_deadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    void Scheduler::clear_frame_deadline() noexcept {
+        set_frame_deadline(std::chrono::steady_clock::time_point::max());
+    }
+
+    void Scheduler::add_next_frame_task(Task task, Priority priority) {
+        Shared& shared = *_m.shared;
+        std::scoped_lock lock { shared.deferred_mutex };
+        shared.next_frame_tasks.push_back(DeferredTask { std::move(task), priority });
+    }
+
+    void Scheduler::split_and_run(ParallelFor& job, size_t first, size_t last) {
+        // Keep the first half, hand off the second. Thieves take the oldest (largest) halves first.
+        while (last - first > job.grain_size) {
+            const size_t middle = first + (last - first) / 2;
+            add_task([this, &job, middle, last]() { split_and_run(job, middle, last); }, t_scheduler_priority);
+            last = middle;
+        }
+        job.chunk_function.invoke(job.chunk_function.context, first, last);
+        job.remaining.fetch_sub(last - first, std::memory_order_acq_rel);
+    }
+
+    void Scheduler::help_until_zero(const std::atomic<size_t>& counter) {
+        Shared& shared = *_m.shared;
+        const size_t worker_index = t_scheduler_worker_index;
+        Worker& self = *shared.workers[worker_index];
+
+        // Only help with lanes at or above our own, so a critical parallel_for isn't stuck behind a background
+        // task. The deadline is ignored here, the chunks being waited on are already running work.
+        const Priority lowest_priority = t_scheduler_priority;
+        auto find_helpable_task = [&]() -> std::optional<FoundTask> {
+            for (size_t lane = 0; lane <= static_cast<size_t>(lowest_priority); ++lane) {
+                const auto priority = static_cast<Priority>(lane);
+                if (auto task = self.queues[lane].pop_back(); task) {
+                    return FoundTask { std::move(*task), priority };
+                }
+                if (auto task = steal_task(shared, worker_index, priority); task) {
+                    return FoundTask { std::move(*task), priority };
+                }
+            }
+            return std::nullopt;
+        };
+
+        while (counter.load(std::memory_order_acquire) != 0) {
+            if (auto found = find_helpable_task(); found) {
+                run_task(found->task, found->priority);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void Scheduler::parallel_for_erased(size_t count, size_t grain_size, ChunkFunction chunk_function) {
+        if (count == 0) {
+            return;
+        }
+        ParallelFor job {
+            .chunk_function = chunk_function,
+            .grain_size = std::max(grain_size, size_t { 1 }),
+            .remaining = count,
+        };
+
+        Shared& shared = *_m.shared;
+        if (t_scheduler_shared != &shared) {
+            add_task([this, &job, count]() { split_and_run(job, 0, count); });
+            launch_threads();
+            wait_for_threads();
+            return;
+        }
+        split_and_run(job, 0, count);
+        help_until_zero(job.remaining);
+    }
+
+    Scheduler::~Scheduler() {
+        if (!_m.shared) {
+            return;
+        }
+        if (_m.shared->is_launched.load(std::memory_order_acquire)) {
+            wait_for_threads();
+        }
+        _m.shared->is_stopping.store(true, std::memory_order_release);
+        _m.shared->batch_epoch.fetch_add(1, std::memory_order_release);
+        _m.shared->batch_epoch.notify_all();
+        std::ranges::for_each(_m.threads, &std::thread::join);
+    }
+}
@@ -1,9 +1,11 @@
 #include "Core/Shader.hpp"
 #include "Config.hpp"
 #include "Core/DebugOpRecorder.hpp"
+#include "Core/GlState.hpp"
 
 #include "Profiler/Profiler.hpp"
 
+#include <charconv>
 #include <format>
 
 using namespace std::literals;
@@ -11,11 +13,12 @@ using namespace std::literals;
 namespace Core {
     Shader::Shader(Shader&& other)
         : _program_id(std::exchange(other._program_id, std::nullopt))
-        , _cached_uniforms(std::move(other._cached_uniforms)) {
+        , _uniforms(std::move(other._uniforms))
+        , _element_locations(std::move(other._element_locations)) {
     }
 
     auto Shader::compile_shader(Type type, const std::string_view& source) -> Utily::Result<uint32_t, Utily::Error> {
-        Profiler::Timer timer("Core::Shader::compile_shader()", { "rendering" });
+        PROFILER_ZONE("Core::Shader::compile_shader()", "rendering");
         Core::DebugOpRecorder::instance().push("Core::Shader", "compile_shader()");
 
         constexpr static auto shader_verison =
@@ -60,7 +63,7 @@ namespace Core {
 
     auto Shader::init(const std::string_view& vert, const std::string_view& frag) -> Utily::Result<void, Utily::Error> {
         Core::DebugOpRecorder::instance().push("Core::Shader", "init()");
-        Profiler::Timer timer("Core::Shader::init()", { "rendering" });
+        PROFILER_ZONE("Core::Shader::init()", "rendering");
         if (_program_id) {
             return Utily::Error { "Trying to override in-use shader" };
         }
@@ -79,7 +82,7 @@ namespace Core {
         }
 
         {
-            Profiler::Timer timer("glLinkProgram()", { "rendering" });
+            PROFILER_ZONE("glLinkProgram()", "rendering");
             glAttachShader(_program_id.value(), vr.value());
             glAttachShader(_program_id.value(), fr.value());
             glLinkProgram(_program_id.value());
@@ -111,10 +114,56 @@ namespace Core {
             }
         }
 
+        load_uniforms();
         return {};
     }
 
-    // cache it so we dont query the GPU over already bound stuff.
+    void Shader::load_uniforms() {
+        PROFILER_ZONE("Core::Shader::load_uniforms()", "rendering");
+        _uniforms.clear();
+        _element_locations.clear();
+
+        int32_t num_uniforms = 0;
+        int32_t max_name_length = 0;
+        glGetProgramiv(_program_id.value(), GL_ACTIVE_UNIFORMS, &num_uniforms);
+        glGetProgramiv(_program_id.value(), GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+        std::string name;
+        std::string element_name;
+        for (int32_t i = 0; i < num_uniforms; ++i) {
+            name.resize(static_cast<size_t>(max_name_length));
+            GLsizei name_length = 0;
+            GLint array_size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(_program_id.value(), static_cast<GLuint>(i), max_name_length, &name_length, &array_size, &type, name.data());
+            name.resize(static_cast<size_t>(name_length));
+
+            // Members of uniform blocks have no location, they're set through a UniformBuffer.
+            const int32_t location = glGetUniformLocation(_program_id.value(), name.c_str());
+            if (location == -1) {
+                continue;
+            }
+            // Arrays are reported as "name[0]".
+            if (name.ends_with("[0]")) {
+                name.resize(name.size() - 3);
+            }
+
+            const auto first_element = static_cast<uint32_t>(_element_locations.size());
+            _element_locations.push_back(location);
+            for (GLint n = 1; n < array_size; ++n) {
+                element_name = std::format("{}[{}]", name, n);
+                _element_locations.push_back(glGetUniformLocation(_program_id.value(), element_name.c_str()));
+            }
+            _uniforms.push_back(UniformInfo {
+                .name_hash = uniform_name_hash(name),
+                .type = type,
+                .location = location,
+                .array_size = static_cast<uint32_t>(array_size),
+                .first_element = first_element,
+            });
+        }
+        std::ranges::sort(_uniforms, {}, &UniformInfo::name_hash);
+    }
 
     void Shader::bind() noexcept {
         Core::DebugOpRecorder::instance().push("Core::Shader", "bind()");
@@ -125,7 +174,7 @@ namespace Core {
                 assert(_program_id.has_value());
             }
         }
-        glUseProgram(_program_id.value());
+        GlState::instance().use_program(_program_id.value());
     }
     void Shader::unbind() noexcept {
         Core::DebugOpRecorder::instance().push("Core::Shader", "unbind()");
@@ -139,32 +188,45 @@ namespace Core {
             }
         }
 
-        glUseProgram(0);
+        GlState::instance().use_program(0);
     }
     void Shader::stop() {
         Core::DebugOpRecorder::instance().push("Core::Shader", "stop()");
 
         if (_program_id) {
-            _cached_uniforms.clear();
+            _uniforms.clear();
+            _element_locations.clear();
             glDeleteProgram(*_program_id);
+            GlState::instance().forget_program(*_program_id);
             _program_id = std::nullopt;
         }
     }
 
     // Assumes shader is bound already.
-    auto Shader::get_uniform(const std::string_view uniform) noexcept -> Utily::Result<Uniform, Utily::Error> {
+    auto Shader::get_uniform(std::string_view uniform) noexcept -> Utily::Result<Uniform, Utily::Error> {
+        PROFILER_ZONE("Core::Shader::get_uniform()", "rendering");
         Core::DebugOpRecorder::instance().push("Core::Shader", "get_uniform()");
 
-        size_t uniform_hash = std::hash<std::string_view> {}(uniform);
-        Uniform& ul = _cached_uniforms[uniform_hash];
-
-        if (ul.location == -1) {
-            ul.location = glGetUniformLocation(_program_id.value(), uniform.data());
-            if (ul.location == -1) {
+        std::string_view base_name = uniform;
+        uint32_t element = 0;
+        if (uniform.ends_with(']')) {
+            const size_t open = uniform.rfind('[');
+            if (open == std::string_view::npos) {
+                return Utily::Error { std::format("Invalid Uniform key: {}", uniform) };
+            }
+            const std::string_view digits = uniform.substr(open + 1, uniform.size() - open - 2);
+            if (std::from_chars(digits.data(), digits.data() + digits.size(), element).ec != std::errc {}) {
                 return Utily::Error { std::format("Invalid Uniform key: {}", uniform) };
             }
+            base_name = uniform.substr(0, open);
+        }
+
+        const uint64_t hash = uniform_name_hash(base_name);
+        auto iter = std::ranges::lower_bound(_uniforms, hash, {}, &UniformInfo::name_hash);
+        if (iter == _uniforms.end() || iter->name_hash != hash || element >= iter->array_size) {
+            return Utily::Error { std::format("Invalid Uniform key: {}", uniform) };
         }
-        return ul;
+        return Uniform { .location = _element_locations[iter->first_element + element] };
     }
 
     auto Shader::set_uniform(std::string_view uniform, int32_t value) noexcept -> Utily::Result<void, Utily::Error> {
@@ -218,6 +280,18 @@ namespace Core {
         return {};
     }
 
+    auto Shader::bind_uniform_block(std::string_view block, uint32_t binding_point) noexcept -> Utily::Result<void, Utily::Error> {
+        Core::DebugOpRecorder::instance().push("Core::Shader", "bind_uniform_block()");
+
+        const std::string block_name { block };
+        const uint32_t block_index = glGetUniformBlockIndex(_program_id.value(), block_name.c_str());
+        if (block_index == GL_INVALID_INDEX) {
+            return Utily::Error { std::format("Invalid Uniform block: {}", block) };
+        }
+        glUniformBlockBinding(_program_id.value(), block_index, binding_point);
+        return {};
+    }
+
     Shader::~Shader() {
         stop();
     }
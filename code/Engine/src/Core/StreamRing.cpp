@@ -0,0 +1,157 @@
+#include "Core/StreamRing.hpp"
+#include "Profiler/EngineCounters.hpp"
+#include "Profiler/Profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+namespace Core {
+    StreamRing::StreamRing(StreamRing&& other) noexcept
+        : _region_size(std::exchange(other._region_size, 0))
+        , _region_bases(std::exchange(other._region_bases, {}))
+        , _region(std::exchange(other._region, 0))
+        , _cursor(std::exchange(other._cursor, 0))
+        , _frame(std::exchange(other._frame, 0))
+#if defined(CONFIG_TARGET_NATIVE)
+        , _fences(std::exchange(other._fences, {}))
+#endif
+    {
+    }
+
+    auto StreamRing::operator=(StreamRing&& other) noexcept -> StreamRing& {
+        if (this != &other) {
+            stop();
+            _region_size = std::exchange(other._region_size, 0);
+            _region_bases = std::exchange(other._region_bases, {});
+            _region = std::exchange(other._region, 0);
+            _cursor = std::exchange(other._cursor, 0);
+            _frame = std::exchange(other._frame, 0);
+#if defined(CONFIG_TARGET_NATIVE)
+            _fences = std::exchange(other._fences, {});
+#endif
+        }
+        return *this;
+    }
+
+    void StreamRing::init(uint32_t target, size_t region_size) noexcept {
+        _region = 0;
+        _cursor = 0;
+        _frame = s_frame;
+        allocate(target, 0, std::max(ALIGNMENT, (region_size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT));
+    }
+
+    void StreamRing::allocate(uint32_t target, size_t first_base, size_t region_size) noexcept {
+        _region_size = region_size;
+        for (size_t i = 0; i < NUM_REGIONS; ++i) {
+            _region_bases[(_region + i) % NUM_REGIONS] = first_base + i * region_size;
+        }
+        glBufferData(target, static_cast<GLsizeiptr>(first_base + region_size * NUM_REGIONS), nullptr, GL_STREAM_DRAW);
+    }
+
+    void StreamRing::delete_fences() noexcept {
+#if defined(CONFIG_TARGET_NATIVE)
+        for (GLsync& fence : _fences) {
+            if (fence) {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+#endif
+    }
+
+    void StreamRing::stop() noexcept {
+        delete_fences();
+        _region_size = 0;
+        _region = 0;
+        _cursor = 0;
+    }
+
+    void StreamRing::next_region() noexcept {
+#if defined(CONFIG_TARGET_NATIVE)
+        // Every draw reading the region was issued last frame, so a fence issued now is behind them all.
+        if (_cursor != 0) {
+            if (_fences[_region]) {
+                glDeleteSync(_fences[_region]);
+            }
+            _fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+#endif
+        _region = (_region + 1) % NUM_REGIONS;
+        _cursor = 0;
+        _frame = s_frame;
+
+#if defined(CONFIG_TARGET_NATIVE)
+        if (GLsync fence = std::exchange(_fences[_region], nullptr); fence) {
+            GLenum status = glClientWaitSync(fence, 0, 0);
+            if (status == GL_TIMEOUT_EXPIRED) {
+                // The GPU is NUM_REGIONS frames behind.
+                PROFILER_ZONE("Core::StreamRing wait", "rendering");
+                EngineCounters::stream_buffer_waits().add(1);
+                do {
+                    status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000);
+                } while (status == GL_TIMEOUT_EXPIRED);
+            }
+            glDeleteSync(fence);
+        }
+#endif
+    }
+
+    void StreamRing::grow(uint32_t target, size_t min_region_size) noexcept {
+        PROFILER_ZONE("Core::StreamRing::grow()", "rendering");
+        // New storage (draws already issued keep the old), so the old fences no longer mean anything.
+        delete_fences();
+
+        // Draws that aren't issued yet (see Renderer::RenderQueue) can point at what was written earlier this
+        // frame, so the current region keeps its base and its data is copied over. The space before it is wasted,
+        // at most NUM_REGIONS - 1 of the old regions, until a grow with nothing written yet starts again from 0.
+        const size_t base = _cursor != 0 ? _region_bases[_region] : 0;
+        uint32_t saved = 0;
+        if (_cursor != 0) {
+            glGenBuffers(1, &saved);
+            glBindBuffer(GL_COPY_READ_BUFFER, saved);
+            glBufferData(GL_COPY_READ_BUFFER, static_cast<GLsizeiptr>(_cursor), nullptr, GL_STREAM_COPY);
+            glCopyBufferSubData(target, GL_COPY_READ_BUFFER, static_cast<GLintptr>(base), 0, static_cast<GLsizeiptr>(_cursor));
+        }
+        allocate(target, base, std::bit_ceil(min_region_size));
+        if (saved != 0) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, target, 0, static_cast<GLintptr>(base), static_cast<GLsizeiptr>(_cursor));
+            glDeleteBuffers(1, &saved);
+        }
+    }
+
+    auto StreamRing::write(uint32_t target, std::span<const std::byte> bytes) noexcept -> size_t {
+        if (_frame != s_frame) {
+            next_region();
+        }
+        if (_cursor + bytes.size() > _region_size) {
+            grow(target, _cursor + bytes.size());
+        }
+
+        const size_t offset = _region_bases[_region] + _cursor;
+        _cursor += (bytes.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        EngineCounters::bytes_uploaded().add(static_cast<int64_t>(bytes.size()));
+        if (bytes.empty()) {
+            return offset;
+        }
+
+#if defined(CONFIG_TARGET_NATIVE)
+        // Unsynchronized since the fences already keep the GPU out of this region.
+        constexpr static GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+        void* dst = glMapBufferRange(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes.size()), access);
+        if (dst) {
+            std::memcpy(dst, bytes.data(), bytes.size());
+            if (glUnmapBuffer(target) == GL_TRUE) {
+                return offset;
+            }
+        }
+#endif
+        glBufferSubData(target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes.size()), bytes.data());
+        return offset;
+    }
+
+    StreamRing::~StreamRing() {
+        delete_fences();
+    }
+}
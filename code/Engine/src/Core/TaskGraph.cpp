@@ -0,0 +1,136 @@
+#include "Core/TaskGraph.hpp"
+
+#include "Profiler/Profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <format>
+
+namespace Core {
+    auto TaskGraph::add_node(std::string_view name, Scheduler::Task task, Scheduler::Priority priority) -> NodeId {
+        _is_compiled = false;
+        _nodes.push_back(Node {
+            .name = std::string(name),
+            .zone = Profiler::Zone(name, "TaskGraph"),
+            .task = std::move(task),
+            .priority = priority,
+            .num_predecessors = 0,
+            .last_duration = std::chrono::nanoseconds { 0 },
+        });
+        return NodeId { _nodes.size() - 1 };
+    }
+
+    void TaskGraph::add_edge(NodeId before, NodeId after) {
+        assert(before.id < _nodes.size() && after.id < _nodes.size());
+        _is_compiled = false;
+        _edges.emplace_back(before.id, after.id);
+    }
+
+    auto TaskGraph::compile() -> Utily::Result<void, Utily::Error> {
+        PROFILER_ZONE("Core::TaskGraph::compile()");
+
+        const size_t num_nodes = _nodes.size();
+
+        // Flatten the edges into per-node successor lists.
+        _successor_offsets.assign(num_nodes + 1, 0);
+        for (auto& node : _nodes) {
+            node.num_predecessors = 0;
+        }
+        for (const auto& [before, after] : _edges) {
+            ++_successor_offsets[before + 1];
+            ++_nodes[after].num_predecessors;
+        }
+        for (size_t i = 0; i < num_nodes; ++i) {
+            _successor_offsets[i + 1] += _successor_offsets[i];
+        }
+        _successors.resize(_edges.size());
+        {
+            std::vector<size_t> insert_at(_successor_offsets.begin(), _successor_offsets.end() - 1);
+            for (const auto& [before, after] : _edges) {
+                _successors[insert_at[before]++] = after;
+            }
+        }
+
+        _roots.clear();
+        for (size_t i = 0; i < num_nodes; ++i) {
+            if (_nodes[i].num_predecessors == 0) {
+                _roots.push_back(i);
+            }
+        }
+
+        // Kahn's algorithm, if not every node can be visited then there is a cycle.
+        std::vector<uint32_t> in_degrees(num_nodes);
+        std::ranges::transform(_nodes, in_degrees.begin(), &Node::num_predecessors);
+        std::vector<size_t> ready = _roots;
+        size_t num_visited = 0;
+        while (!ready.empty()) {
+            const size_t node_index = ready.back();
+            ready.pop_back();
+            ++num_visited;
+            for (size_t successor : successors_of(node_index)) {
+                if (--in_degrees[successor] == 0) {
+                    ready.push_back(successor);
+                }
+            }
+        }
+        if (num_visited != num_nodes) {
+            return Utily::Error {
+                std::format("TaskGraph has a cycle, only {} of the {} nodes can run.", num_visited, num_nodes)
+            };
+        }
+
+        _remaining_predecessors = std::make_unique<std::atomic<uint32_t>[]>(num_nodes);
+        _is_compiled = true;
+        return {};
+    }
+
+    auto TaskGraph::successors_of(size_t node_index) const noexcept -> std::span<const size_t> {
+        return std::span { _successors }.subspan(
+            _successor_offsets[node_index],
+            _successor_offsets[node_index + 1] - _successor_offsets[node_index]);
+    }
+
+    void TaskGraph::run_node(Scheduler& scheduler, size_t node_index) {
+        Node& node = _nodes[node_index];
+        {
+            const Profiler::Timer timer(node.zone);
+            const auto start = std::chrono::steady_clock::now();
+            node.task();
+            node.last_duration = std::chrono::steady_clock::now() - start;
+        }
+
+        for (size_t successor : successors_of(node_index)) {
+            if (_remaining_predecessors[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                scheduler.add_task([this, &scheduler, successor]() { run_node(scheduler, successor); }, _nodes[successor].priority);
+            }
+        }
+    }
+
+    auto TaskGraph::execute(Scheduler& scheduler) -> Utily::Result<void, Utily::Error> {
+        PROFILER_ZONE("Core::TaskGraph::execute()");
+        if (!_is_compiled) {
+            if (auto result = compile(); result.has_error()) {
+                return result.error();
+            }
+        }
+
+        for (size_t i = 0; i < _nodes.size(); ++i) {
+            _remaining_predecessors[i].store(_nodes[i].num_predecessors, std::memory_order_relaxed);
+        }
+        for (size_t root : _roots) {
+            scheduler.add_task([this, &scheduler, root]() { run_node(scheduler, root); }, _nodes[root].priority);
+        }
+        scheduler.launch_threads();
+        scheduler.wait_for_threads();
+        return {};
+    }
+
+    auto TaskGraph::node_timings() const -> std::vector<NodeTiming> {
+        std::vector<NodeTiming> timings;
+        timings.reserve(_nodes.size());
+        for (const auto& node : _nodes) {
+            timings.push_back(NodeTiming { .name = node.name, .duration = node.last_duration });
+        }
+        return timings;
+    }
+}
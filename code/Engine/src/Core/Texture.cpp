@@ -1,50 +1,19 @@
 #include "Core/Texture.hpp"
 #include "Config.hpp"
 #include "Core/DebugOpRecorder.hpp"
+#include "Core/GlState.hpp"
 #include "Profiler/Profiler.hpp"
 
 #include <Utily/Utily.hpp>
 #include <iostream>
-#include <tuple>
 
 namespace Core {
-    struct TextureUnit {
-        Texture* texture = nullptr;
-        bool immutable = false;
-    };
-
-    auto texture_units() -> Utily::StaticVector<TextureUnit, 64>& {
-        static Utily::StaticVector<TextureUnit, 64> texture_units = {};
-        return texture_units;
-    }
-
     Texture::Texture(Texture&& other)
         : _height(std::exchange(other._height, 0))
         , _width(std::exchange(other._width, 0))
         , _id(std::exchange(other._id, std::nullopt))
         , _texture_unit_index(std::exchange(other._texture_unit_index, std::nullopt)) { }
 
-    auto get_usable_texture_unit() noexcept
-        -> Utily::Result<std::tuple<std::ptrdiff_t, TextureUnit*>, Utily::Error> {
-        if (!texture_units().size()) {
-            // TODO collect analytics about how many texture slots.
-            int32_t max_texture_units;
-            glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &max_texture_units);
-            texture_units().resize(static_cast<std::ptrdiff_t>(max_texture_units));
-            return std::tuple { 0, &texture_units()[0] };
-        }
-
-        auto isUsableUnit = [](TextureUnit& tu) {
-            return tu.texture == nullptr || tu.immutable == false;
-        };
-        auto iter = std::ranges::find_if(texture_units(), isUsableUnit);
-
-        if (iter == texture_units().end()) [[unlikely]] {
-            return Utily::Error { "Ran out of usable texture units." };
-        }
-        return std::tuple { std::distance(texture_units().begin(), iter), &(*iter) };
-    }
-
     constexpr static uint32_t INVALID_TEXTURE_ID = 0;
 
     auto Texture::init() noexcept -> Utily::Result<void, Utily::Error> {
@@ -67,7 +36,7 @@ namespace Core {
         Filter filter) noexcept
         -> Utily::Result<void, Utily::Error> {
         Core::DebugOpRecorder::instance().push("Core::Texture", "upload_image()");
-        Profiler::Timer timer("Core::Texture::upload_image()", { "rendering" });
+        PROFILER_ZONE("Core::Texture::upload_image()", "rendering");
 
         if (!_id) {
             if (auto ir = init(); ir.has_error()) {
@@ -114,57 +83,46 @@ namespace Core {
             }
         }
 
-        if (_texture_unit_index) {
-            assert(_texture_unit_index.value() < texture_units().size());
-            if (texture_units()[_texture_unit_index.value()].texture == this) {
-                texture_units()[_texture_unit_index.value()].immutable = locked;
-                return _texture_unit_index.value();
-            }
-            _texture_unit_index = std::nullopt;
-        }
-
-        auto result = get_usable_texture_unit();
+        // The unit it had last time is kept as a hint, GlState knows whether it still has it.
+        auto result = GlState::instance().acquire_texture_unit(_id.value_or(INVALID_TEXTURE_ID), _texture_unit_index, locked);
         if (result.has_error()) {
+            _texture_unit_index = std::nullopt;
             return result.error();
         }
-        auto& [index, texture_unit] = result.value();
-        texture_unit->texture = this;
-        texture_unit->immutable = locked;
-
-        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(index));
-        glBindTexture(GL_TEXTURE_2D, _id.value_or(INVALID_TEXTURE_ID));
-        _texture_unit_index = static_cast<uint32_t>(index);
+        _texture_unit_index = result.value();
+        return result.value();
+    }
+    void Texture::unlock() noexcept {
+        Core::DebugOpRecorder::instance().push("Core::Texture", "unlock()");
 
-        return static_cast<uint32_t>(index);
+        if (_id && _texture_unit_index) {
+            GlState::instance().unlock_texture_unit(_id.value(), _texture_unit_index.value());
+        }
     }
     void Texture::unbind() noexcept {
         Core::DebugOpRecorder::instance().push("Core::Texture", "unbind()");
 
-        if (!texture_units().size()) {
+        if (!_texture_unit_index) {
             return;
         }
 
         if constexpr (Config::SKIP_UNBINDING) {
-            if (texture_units()[_texture_unit_index.value_or(0)].texture == this) {
-                texture_units()[_texture_unit_index.value_or(0)].immutable = false;
-            }
+            GlState::instance().unlock_texture_unit(_id.value_or(INVALID_TEXTURE_ID), _texture_unit_index.value());
             return;
         }
 
-        if (texture_units()[_texture_unit_index.value_or(0)].texture == this) {
-            texture_units()[_texture_unit_index.value_or(0)].texture = nullptr;
-            texture_units()[_texture_unit_index.value_or(0)].immutable = false;
-            glActiveTexture(GL_TEXTURE0 + _texture_unit_index.value_or(0));
-            glBindTexture(GL_TEXTURE_2D, 0);
-            _texture_unit_index = std::nullopt;
-        }
+        GlState::instance().release_texture_unit(_id.value_or(INVALID_TEXTURE_ID), _texture_unit_index.value());
+        _texture_unit_index = std::nullopt;
     }
 
     void Texture::stop() noexcept {
         Core::DebugOpRecorder::instance().push("Core::Texture", "stop()");
 
         if (_id) {
-            unbind();
+            // Not unbind(), the unit has to be given back even when SKIP_UNBINDING.
+            if (_texture_unit_index) {
+                GlState::instance().release_texture_unit(_id.value(), _texture_unit_index.value());
+            }
             glDeleteTextures(1, &_id.value());
         }
         _id = std::nullopt;
@@ -0,0 +1,106 @@
+#include "Core/TextureUnitLru.hpp"
+
+#include <algorithm>
+
+namespace Core {
+    void TextureUnitLru::reset(size_t num_units) {
+        _units.assign(std::min<size_t>(num_units, NO_UNIT - 1), Unit {});
+        _front = NO_UNIT;
+        _back = NO_UNIT;
+        for (uint16_t unit = 0; unit < _units.size(); ++unit) {
+            push_back(unit);
+        }
+    }
+
+    void TextureUnitLru::unlink(uint16_t unit) noexcept {
+        Unit& u = _units[unit];
+        (u.prev == NO_UNIT ? _front : _units[u.prev].next) = u.next;
+        (u.next == NO_UNIT ? _back : _units[u.next].prev) = u.prev;
+        u.prev = NO_UNIT;
+        u.next = NO_UNIT;
+    }
+
+    void TextureUnitLru::push_front(uint16_t unit) noexcept {
+        Unit& u = _units[unit];
+        u.prev = NO_UNIT;
+        u.next = _front;
+        (_front == NO_UNIT ? _back : _units[_front].prev) = unit;
+        _front = unit;
+    }
+
+    void TextureUnitLru::push_back(uint16_t unit) noexcept {
+        Unit& u = _units[unit];
+        u.next = NO_UNIT;
+        u.prev = _back;
+        (_back == NO_UNIT ? _front : _units[_back].next) = unit;
+        _back = unit;
+    }
+
+    auto TextureUnitLru::acquire(uint32_t texture, std::optional<uint32_t> hint, bool is_locked) noexcept
+        -> Utily::Result<Acquired, Utily::Error> {
+        if (hint && *hint < _units.size() && _units[*hint].texture == texture) {
+            // Still there, just move it to the back of the list (or out of it while locked).
+            const auto unit = static_cast<uint16_t>(*hint);
+            Unit& u = _units[unit];
+            if (u.num_locks == 0) {
+                unlink(unit);
+            }
+            if (is_locked) {
+                if (u.num_locks == UINT16_MAX) [[unlikely]] {
+                    return Utily::Error { "Too many locks on one texture unit." };
+                }
+                ++u.num_locks;
+            }
+            if (u.num_locks == 0) {
+                push_back(unit);
+            }
+            return Acquired { .unit = unit, .is_bind_needed = false, .was_empty = false };
+        }
+
+        if (_front == NO_UNIT) [[unlikely]] {
+            return Utily::Error { "Ran out of usable texture units." };
+        }
+        // Whatever had the unit before finds out on its next acquire, its hint won't match any more.
+        const uint16_t unit = _front;
+        unlink(unit);
+        Unit& u = _units[unit];
+        const bool was_empty = u.texture == 0;
+        u.texture = texture;
+        u.num_locks = is_locked ? 1 : 0;
+        if (!is_locked) {
+            push_back(unit);
+        }
+        return Acquired { .unit = unit, .is_bind_needed = true, .was_empty = was_empty };
+    }
+
+    void TextureUnitLru::unlock(uint32_t texture, uint32_t unit) noexcept {
+        if (unit >= _units.size() || _units[unit].texture != texture || _units[unit].num_locks == 0) {
+            return;
+        }
+        if (--_units[unit].num_locks == 0) {
+            push_back(static_cast<uint16_t>(unit));
+        }
+    }
+
+    auto TextureUnitLru::release(uint32_t texture, uint32_t unit) noexcept -> bool {
+        if (texture == 0 || unit >= _units.size() || _units[unit].texture != texture) {
+            return false;
+        }
+        const auto index = static_cast<uint16_t>(unit);
+        if (_units[index].num_locks == 0) {
+            unlink(index);
+        }
+        _units[index].texture = 0;
+        _units[index].num_locks = 0;
+        push_front(index);
+        return true;
+    }
+
+    auto TextureUnitLru::lru_order() const -> std::vector<uint32_t> {
+        std::vector<uint32_t> order;
+        for (uint16_t unit = _front; unit != NO_UNIT; unit = _units[unit].next) {
+            order.push_back(unit);
+        }
+        return order;
+    }
+}
@@ -0,0 +1,99 @@
+#include "Core/TransformTexture.hpp"
+#include "Core/DebugOpRecorder.hpp"
+#include "Core/GlState.hpp"
+#include "Profiler/EngineCounters.hpp"
+#include "Profiler/Profiler.hpp"
+
+#include <bit>
+#include <utility>
+
+namespace Core {
+    TransformTexture::TransformTexture(TransformTexture&& other) noexcept
+        : _id(std::exchange(other._id, std::nullopt))
+        , _texture_unit_index(std::exchange(other._texture_unit_index, std::nullopt))
+        , _num_rows(std::exchange(other._num_rows, 0)) { }
+
+    auto TransformTexture::init() noexcept -> Utily::Result<void, Utily::Error> {
+        Core::DebugOpRecorder::instance().push("Core::TransformTexture", "init()");
+
+        if (_id) {
+            return Utily::Error { "Trying to override in-use TransformTexture" };
+        }
+        uint32_t id = 0;
+        glGenTextures(1, &id);
+        if (id == 0) {
+            return Utily::Error { "Failed to create TransformTexture. glGenTextures failed." };
+        }
+        _id = id;
+        _num_rows = 0;
+
+        if (auto br = bind(); br.has_error()) {
+            return br.error();
+        }
+        // Float textures can't be filtered on ES, and it's only ever read with texelFetch() anyway. Without mipmaps
+        // the default min filter would leave it incomplete, and texelFetch() would read zeros.
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        return {};
+    }
+
+    void TransformTexture::stop() noexcept {
+        Core::DebugOpRecorder::instance().push("Core::TransformTexture", "stop()");
+
+        if (_id) {
+            if (_texture_unit_index) {
+                GlState::instance().release_texture_unit(_id.value(), _texture_unit_index.value());
+            }
+            glDeleteTextures(1, &_id.value());
+        }
+        _id = std::nullopt;
+        _texture_unit_index = std::nullopt;
+        _num_rows = 0;
+    }
+
+    void TransformTexture::load(std::span<const glm::mat4> transforms) noexcept {
+        Core::DebugOpRecorder::instance().push("Core::TransformTexture", "load()");
+        PROFILER_ZONE("Core::TransformTexture::load()", "rendering");
+
+        if (bind().has_error() || transforms.empty()) {
+            return;
+        }
+        const auto num_transforms = static_cast<int32_t>(transforms.size());
+        const int32_t num_rows = (num_transforms + MATRICES_PER_ROW - 1) / MATRICES_PER_ROW;
+        if (num_rows > _num_rows) {
+            _num_rows = static_cast<int32_t>(std::bit_ceil(static_cast<uint32_t>(num_rows)));
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, WIDTH, _num_rows, 0, GL_RGBA, GL_FLOAT, nullptr);
+        }
+
+        // glm is column major like GL, so a matrix is already its four texels in order.
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        const int32_t num_full_rows = num_transforms / MATRICES_PER_ROW;
+        if (num_full_rows) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, WIDTH, num_full_rows, GL_RGBA, GL_FLOAT, transforms.data());
+        }
+        if (const int32_t rest = num_transforms % MATRICES_PER_ROW; rest) {
+            const glm::mat4* first = transforms.data() + static_cast<size_t>(num_full_rows) * MATRICES_PER_ROW;
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, num_full_rows, rest * 4, 1, GL_RGBA, GL_FLOAT, first);
+        }
+        EngineCounters::bytes_uploaded().add(static_cast<int64_t>(transforms.size_bytes()));
+    }
+
+    auto TransformTexture::bind(bool locked) noexcept -> Utily::Result<uint32_t, Utily::Error> {
+        Core::DebugOpRecorder::instance().push("Core::TransformTexture", "bind()");
+
+        if (!_id) {
+            return Utily::Error { "Trying to bind a TransformTexture that has not been initialised." };
+        }
+        auto result = GlState::instance().acquire_texture_unit(_id.value(), _texture_unit_index, locked);
+        if (result.has_error()) {
+            _texture_unit_index = std::nullopt;
+            return result.error();
+        }
+        _texture_unit_index = result.value();
+        return result.value();
+    }
+
+    TransformTexture::~TransformTexture() {
+        stop();
+    }
+}
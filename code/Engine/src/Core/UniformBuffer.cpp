@@ -0,0 +1,93 @@
+#include "Core/UniformBuffer.hpp"
+#include "Core/DebugOpRecorder.hpp"
+#include "Core/GlState.hpp"
+#include "Profiler/EngineCounters.hpp"
+#include "Profiler/Profiler.hpp"
+
+#include <utility>
+
+namespace Core {
+    constexpr static uint32_t INVALID_UNIFORM_BUFFER_ID = 0;
+
+    UniformBuffer::UniformBuffer(UniformBuffer&& other) noexcept
+        : _id(std::exchange(other._id, std::nullopt)) {
+    }
+
+    auto UniformBuffer::init() noexcept -> Utily::Result<void, Utily::Error> {
+        Core::DebugOpRecorder::instance().push("Core::UniformBuffer", "init()");
+
+        if (_id) {
+            return Utily::Error { "Trying to override in-use uniform buffer" };
+        }
+        _id = INVALID_UNIFORM_BUFFER_ID;
+        glGenBuffers(1, &_id.value());
+        if (_id.value() == INVALID_UNIFORM_BUFFER_ID) {
+            _id = std::nullopt;
+            return Utily::Error { "Failed to create Uniform Buffer. glGenBuffers failed." };
+        }
+        return {};
+    }
+
+    void UniformBuffer::stop() noexcept {
+        Core::DebugOpRecorder::instance().push("Core::UniformBuffer", "stop()");
+
+        if (_id.value_or(INVALID_UNIFORM_BUFFER_ID) != INVALID_UNIFORM_BUFFER_ID) {
+            glDeleteBuffers(1, &_id.value());
+            GlState::instance().forget_buffer(_id.value());
+        }
+        _id = std::nullopt;
+    }
+
+    void UniformBuffer::bind() noexcept {
+        Core::DebugOpRecorder::instance().push("Core::UniformBuffer", "bind()");
+
+        if constexpr (Config::DEBUG_LEVEL != Config::DebugInfo::none) {
+            if (_id.value_or(INVALID_UNIFORM_BUFFER_ID) == INVALID_UNIFORM_BUFFER_ID) {
+                std::cerr << "Trying to bind invalid uniform buffer.";
+                assert(false);
+            }
+        }
+        GlState::instance().bind_buffer(GL_UNIFORM_BUFFER, _id.value_or(INVALID_UNIFORM_BUFFER_ID));
+    }
+
+    void UniformBuffer::unbind() noexcept {
+        Core::DebugOpRecorder::instance().push("Core::UniformBuffer", "unbind()");
+
+        if constexpr (Config::SKIP_UNBINDING) {
+            return;
+        } else if constexpr (Config::DEBUG_LEVEL != Config::DebugInfo::none) {
+            if (_id.value_or(INVALID_UNIFORM_BUFFER_ID) == INVALID_UNIFORM_BUFFER_ID) {
+                std::cerr << "Trying to unbind invalid uniform buffer.";
+                assert(false);
+            }
+        }
+        GlState::instance().bind_buffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    void UniformBuffer::bind_to(uint32_t binding_point) noexcept {
+        Core::DebugOpRecorder::instance().push("Core::UniformBuffer", "bind_to()");
+
+        if constexpr (Config::DEBUG_LEVEL != Config::DebugInfo::none) {
+            if (_id.value_or(INVALID_UNIFORM_BUFFER_ID) == INVALID_UNIFORM_BUFFER_ID) {
+                std::cerr << "Trying to bind invalid uniform buffer.";
+                assert(false);
+            }
+        }
+        GlState::instance().bind_buffer_base(GL_UNIFORM_BUFFER, binding_point, _id.value_or(INVALID_UNIFORM_BUFFER_ID));
+    }
+
+    void UniformBuffer::load_bytes(std::span<const std::byte> bytes) noexcept {
+        PROFILER_ZONE("Core::UniformBuffer::load_bytes()", "rendering");
+        Core::DebugOpRecorder::instance().push("Core::UniformBuffer", "load_bytes()");
+
+        bind();
+        EngineCounters::bytes_uploaded().add(static_cast<int64_t>(bytes.size()));
+        // glBufferData rather than glBufferSubData, so the driver can give it new storage instead of waiting on
+        // draws from the last frame that still read the old contents.
+        glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(bytes.size()), bytes.data(), GL_DYNAMIC_DRAW);
+    }
+
+    UniformBuffer::~UniformBuffer() noexcept {
+        stop();
+    }
+}
@@ -1,20 +1,74 @@
 #include "Core/VertexArray.hpp"
 
 #include "Config.hpp"
+#include "Core/GlState.hpp"
 
 namespace Core {
 
     VertexArray::VertexArray(VertexArray&& other) noexcept
-        : _id(std::exchange(other._id, std::nullopt)) {
+        : _id(std::exchange(other._id, std::nullopt))
+        , _attributes(std::move(other._attributes)) {
+    }
+
+    void VertexArray::set_attribute_pointer(const Attribute& attribute) noexcept {
+        const auto* pointer = reinterpret_cast<const void*>(attribute.base + attribute.offset);
+        // Integers go through the I variant so the shader gets them as `in uint`/`in int`, not converted to floats.
+        const bool is_integer = attribute.type == GL_UNSIGNED_INT || attribute.type == GL_INT
+            || attribute.type == GL_UNSIGNED_SHORT || attribute.type == GL_SHORT
+            || attribute.type == GL_UNSIGNED_BYTE || attribute.type == GL_BYTE;
+        if (is_integer && !attribute.normalised) {
+            glVertexAttribIPointer(attribute.index, static_cast<GLint>(attribute.count), attribute.type, static_cast<GLsizei>(attribute.stride), pointer);
+        } else {
+            glVertexAttribPointer(attribute.index, static_cast<GLint>(attribute.count), attribute.type, static_cast<GLboolean>(attribute.normalised), static_cast<GLsizei>(attribute.stride), pointer);
+        }
+    }
+
+    void VertexArray::add_attribute(VertexBuffer& vb, uint32_t index, uint32_t count, uint32_t type, uint32_t normalised, uint32_t stride, uint32_t offset) noexcept {
+        const Attribute& attribute = _attributes.emplace_back(Attribute {
+            .index = index,
+            .count = count,
+            .type = type,
+            .normalised = normalised,
+            .stride = stride,
+            .offset = offset,
+            .buffer = vb.get_id().value_or(0),
+            .base = vb.get_offset(),
+        });
+        set_attribute_pointer(attribute);
+    }
+
+    void VertexArray::rebase(VertexBuffer& vb) noexcept {
+        rebase(vb, vb.get_offset());
+    }
+
+    void VertexArray::rebase(VertexBuffer& vb, size_t base) noexcept {
+        Core::DebugOpRecorder::instance().push("Core::VertexArray", "rebase()");
+
+        const uint32_t buffer = vb.get_id().value_or(0);
+        bool is_bound = false;
+        for (Attribute& attribute : _attributes) {
+            if (attribute.buffer != buffer || attribute.base == base) {
+                continue;
+            }
+            if (!is_bound) {
+                bind();
+                vb.bind();
+                is_bound = true;
+            }
+            attribute.base = base;
+            set_attribute_pointer(attribute);
+        }
     }
 
     void VertexArray::stop() noexcept {
         Core::DebugOpRecorder::instance().push("Core::VertexArray", "stop()");
 
-        if (_id.value_or(INVALID_ARRAY_OBJECT_ID) == INVALID_ARRAY_OBJECT_ID) {
+        if (_id.value_or(INVALID_ARRAY_OBJECT_ID) != INVALID_ARRAY_OBJECT_ID) {
             glDeleteVertexArrays(1, &_id.value());
+            GlState::instance().forget_vertex_array(_id.value());
         }
         _id = std::nullopt;
+        _attributes.clear();
     }
 
     void VertexArray::bind() noexcept {
@@ -27,7 +81,7 @@ namespace Core {
             }
         }
 
-        glBindVertexArray(_id.value_or(INVALID_ARRAY_OBJECT_ID));
+        GlState::instance().bind_vertex_array(_id.value_or(INVALID_ARRAY_OBJECT_ID));
     }
     void VertexArray::unbind() noexcept {
         Core::DebugOpRecorder::instance().push("Core::VertexArray", "unbind()");
@@ -40,7 +94,7 @@ namespace Core {
                 assert(false);
             }
         }
-        glBindVertexArray(0);
+        GlState::instance().bind_vertex_array(0);
     }
 
 }
\ No newline at end of file
@@ -1,15 +1,16 @@
 #include "Core/VertexBuffer.hpp"
 #include "Core/DebugOpRecorder.hpp"
+#include "Core/GlState.hpp"
 
 #include <utility>
 
 namespace Core {
     constexpr static uint32_t INVALID_VERTEX_BUFFER_ID = 0;
-    static VertexBuffer* last_bound_vb = nullptr;
 
     VertexBuffer::VertexBuffer(VertexBuffer&& other) noexcept
-        : _id(std::exchange(other._id, std::nullopt)) {
-        last_bound_vb = nullptr;
+        : _id(std::exchange(other._id, std::nullopt))
+        , _stream(std::exchange(other._stream, std::nullopt))
+        , _offset(std::exchange(other._offset, 0)) {
     }
 
     auto VertexBuffer::init() noexcept -> Utily::Result<void, Utily::Error> {
@@ -27,17 +28,25 @@ namespace Core {
         return {};
     }
 
+    auto VertexBuffer::init(Streaming streaming) noexcept -> Utily::Result<void, Utily::Error> {
+        if (auto result = init(); result.has_error()) {
+            return result.error();
+        }
+        bind();
+        _stream.emplace().init(GL_ARRAY_BUFFER, streaming.bytes_per_frame);
+        return {};
+    }
+
     void VertexBuffer::stop() noexcept {
         Core::DebugOpRecorder::instance().push("Core::VertexBuffer", "stop()");
 
         if (_id.value_or(INVALID_VERTEX_BUFFER_ID) != INVALID_VERTEX_BUFFER_ID) {
             glDeleteBuffers(1, &_id.value());
+            GlState::instance().forget_buffer(_id.value());
         }
         _id = std::nullopt;
-
-        if (last_bound_vb == this) {
-            last_bound_vb = this;
-        }
+        _stream = std::nullopt;
+        _offset = 0;
     }
 
     void VertexBuffer::bind() noexcept {
@@ -49,10 +58,7 @@ namespace Core {
                 assert(false);
             }
         }
-        if (last_bound_vb != this) {
-            glBindBuffer(GL_ARRAY_BUFFER, _id.value_or(INVALID_VERTEX_BUFFER_ID));
-            last_bound_vb = this;
-        }
+        GlState::instance().bind_buffer(GL_ARRAY_BUFFER, _id.value_or(INVALID_VERTEX_BUFFER_ID));
     }
     void VertexBuffer::unbind() noexcept {
         Core::DebugOpRecorder::instance().push("Core::VertexBuffer", "unbind()");
@@ -66,10 +72,7 @@ namespace Core {
             }
         }
 
-        if (last_bound_vb != nullptr) {
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-            last_bound_vb = nullptr;
-        }
+        GlState::instance().bind_buffer(GL_ARRAY_BUFFER, 0);
     }
 
     VertexBuffer::~VertexBuffer() noexcept {
@@ -24,7 +24,7 @@ namespace Media {
     }();
 
     auto FontAtlas::create(std::filesystem::path path, uint32_t char_height_px) noexcept -> Utily::Result<FontAtlas, Utily::Error> {
-        Profiler::Timer timer("Media::FontAtlas::create()");
+        PROFILER_ZONE("Media::FontAtlas::create()");
 
         // 1. Load ttf file from disk.
         // 2. Initalise the freetype and fontface.
@@ -11,7 +11,7 @@
 
 namespace Media {
     auto Image::create(std::filesystem::path path) -> Utily::Result<Image, Utily::Error> {
-        Profiler::Timer timer("Media::Image::create()");
+        PROFILER_ZONE("Media::Image::create()");
         // 1. Load the file contents into memory.
         // 2. Decode the file contents via libspng.
         // 3. Construct a valid Image instance.
@@ -31,7 +31,7 @@ namespace Media {
         size_t data_size_bytes = 0;
         glm::uvec2 dimensions = { 0, 0 };
         {
-            Profiler::Timer timer2("libspng_decode_image()");
+            PROFILER_ZONE("libspng_decode_image()");
             spng_ctx* ctx = spng_ctx_new(0);
             int spng_error = 0;
             spng_error = spng_set_png_buffer(ctx, encoded_png.data(), encoded_png.size());
@@ -132,7 +132,7 @@ namespace Media {
         : _m(std::move(other._m)) { }
 
     auto Image::save_to_disk(std::filesystem::path path) const noexcept -> Utily::Result<void, Utily::Error> {
-        Profiler::Timer timer("Media::Image::save_to_disk()");
+        PROFILER_ZONE("Media::Image::save_to_disk()");
 
         spng_ctx* ctx = spng_ctx_new(SPNG_CTX_ENCODER);
         if (!ctx) {
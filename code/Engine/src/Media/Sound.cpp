@@ -8,7 +8,7 @@
 
 namespace Media {
     auto Sound::create(std::filesystem::path wav_path) noexcept -> Utily::Result<Sound, Utily::Error> {
-        Profiler::Timer timer("Media::Sound::create()");
+        PROFILER_ZONE("Media::Sound::create()");
         // 1. Load the raw contents of the wav file.
         // 2. Decode the contents use dr-wav.
         // 3. Compress stereo audio into mono audio and copy into buffer.
@@ -5,11 +5,14 @@
 #include <cstdint>
 #include <format>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <ranges>
 #include <span>
 
+#include "Core/Scheduler.hpp"
 #include "Profiler/Profiler.hpp"
 #include <Utily/Utily.hpp>
 #include <assimp/Importer.hpp>
@@ -17,10 +20,8 @@
 #include <assimp/scene.h>
 
 namespace Model {
-    auto decode_as_static_model(std::span<uint8_t> file_data, std::string_view file_extension)
-        -> Utily::Result<Static, Utily::Error> {
-
-        Profiler::Timer timer("Model::decode_as_static_model()", { "rendering" });
+    static auto import_single_mesh(Assimp::Importer& importer, std::span<uint8_t> file_data, std::string_view file_extension)
+        -> Utily::Result<const aiMesh*, Utily::Error> {
 
         constexpr auto assimp_process_flags =
             aiProcess_CalcTangentSpace
@@ -32,14 +33,10 @@ namespace Model {
             | aiProcess_GenNormals
             | aiProcess_GenBoundingBoxes;
 
-
-        
-        Assimp::Importer importer {};
-
         const aiScene* assimp_scene = nullptr;
 
         {
-            Profiler::Timer assimp_timer("Assimp::Importer::ReadFileFromMemory()");
+            PROFILER_ZONE("Assimp::Importer::ReadFileFromMemory()");
 
             assimp_scene = importer.ReadFileFromMemory(
                 file_data.data(),
@@ -58,55 +55,132 @@ namespace Model {
 
         auto assimp_meshes = std::span { assimp_scene->mMeshes, assimp_scene->mNumMeshes };
 
-        Static loaded_model;
-
         if (assimp_meshes.size() > 1) {
             return Utily::Error { "There was multiple model mesh data. Use function decode_as_static_models." };
         } else if (assimp_meshes.size() == 0) {
             return Utily::Error { "There was no model mesh data" };
         }
 
+        const aiMesh* assimp_mesh = assimp_meshes.front();
+        if (!assimp_mesh->HasFaces() || !assimp_mesh->HasNormals() || !assimp_mesh->HasPositions()) {
+            return Utily::Error("There was either no: faces || normals || positions");
+        }
+        return assimp_mesh;
+    }
+
+    static auto get_formatted_aabb(const aiMesh& assimp_mesh) -> std::array<Vec3, 2> {
+        return std::array<Vec3, 2> {
+            Vec3 { static_cast<float>(assimp_mesh.mAABB.mMin.x), static_cast<float>(assimp_mesh.mAABB.mMin.y), static_cast<float>(assimp_mesh.mAABB.mMin.z) },
+            Vec3 { static_cast<float>(assimp_mesh.mAABB.mMax.x), static_cast<float>(assimp_mesh.mAABB.mMax.y), static_cast<float>(assimp_mesh.mAABB.mMax.z) },
+        };
+    }
+
+    static auto to_vertex(const aiVector3D& p, const aiVector3D& n, const aiVector3D& u) -> Vertex {
+        return {
+            .position = { p.x, p.y, p.z },
+            .normal = { n.x, n.y, n.z },
+            .uv_coord = { u.x, u.y }
+        };
+    }
+
+    auto decode_as_static_model(std::span<uint8_t> file_data, std::string_view file_extension)
+        -> Utily::Result<Static, Utily::Error> {
+
+        PROFILER_ZONE("Model::decode_as_static_model()", "rendering");
+
+        Assimp::Importer importer {};
+
+        auto mesh_result = import_single_mesh(importer, file_data, file_extension);
+        if (mesh_result.has_error()) {
+            return mesh_result.error();
+        }
+        const aiMesh* assimp_mesh = mesh_result.value();
+
+        Static loaded_model;
         {
-            Profiler::Timer extract_timer("extract_from_assimp_meshes()", { "rendering" });
-            for (const auto& assimp_mesh : assimp_meshes) {
+            PROFILER_ZONE("extract_from_assimp_meshes()", "rendering");
+
+            auto faces = std::span { assimp_mesh->mFaces, assimp_mesh->mNumFaces };
+            auto positions = std::span { assimp_mesh->mVertices, assimp_mesh->mNumVertices };
+            auto normals = std::span { assimp_mesh->mNormals, assimp_mesh->mNumVertices };
+            auto uvs = std::span { assimp_mesh->mTextureCoords[0], assimp_mesh->mNumVertices };
+
+            auto to_span = [](const aiFace& face) -> std::span<uint32_t> {
+                return { face.mIndices, face.mNumIndices };
+            };
+            auto to_vert = [](auto&& pnu) -> Vertex {
+                auto& [p, n, u] = pnu;
+                return to_vertex(p, n, u);
+            };
+            auto vertices_view = std::views::zip(positions, normals, uvs) | std::views::transform(to_vert);
+
+            auto indices_view = faces | std::views::transform(to_span) | std::views::join;
+            auto [ptr, vert, ind] = Utily::InlineArrays::alloc_copy(std::move(vertices_view), std::move(indices_view));
+
+            loaded_model.axis_align_bounding_box = get_formatted_aabb(*assimp_mesh);
+            loaded_model.data = std::move(ptr);
+            loaded_model.vertices = vert;
+            loaded_model.indices = ind;
+        }
+        return loaded_model;
+    }
 
-                if (!assimp_mesh->HasFaces() || !assimp_mesh->HasNormals() || !assimp_mesh->HasPositions()) {
-                    return Utily::Error("There was either no: faces || normals || positions");
-                }
+    auto decode_as_static_model(std::span<uint8_t> file_data, std::string_view file_extension, Core::Scheduler& scheduler)
+        -> Utily::Result<Static, Utily::Error> {
 
-                auto faces = std::span { assimp_mesh->mFaces, assimp_mesh->mNumFaces };
-                auto positions = std::span { assimp_mesh->mVertices, assimp_mesh->mNumVertices };
-                auto normals = std::span { assimp_mesh->mNormals, assimp_mesh->mNumVertices };
-                auto uvs = std::span { assimp_mesh->mTextureCoords[0], assimp_mesh->mNumVertices };
+        PROFILER_ZONE("Model::decode_as_static_model()", "rendering");
 
-                auto get_formatted_aabb = [&] {
-                    return std::array<Vec3, 2> {
-                        Vec3 { static_cast<float>(assimp_mesh->mAABB.mMin.x), static_cast<float>(assimp_mesh->mAABB.mMin.y), static_cast<float>(assimp_mesh->mAABB.mMin.z) },
-                        Vec3 { static_cast<float>(assimp_mesh->mAABB.mMax.x), static_cast<float>(assimp_mesh->mAABB.mMax.y), static_cast<float>(assimp_mesh->mAABB.mMax.z) },
-                    };
-                };
-                auto to_span = [](const aiFace& face) -> std::span<uint32_t> {
-                    return { face.mIndices, face.mNumIndices };
-                };
+        constexpr static size_t EXTRACT_GRAIN_SIZE = 4096;
 
-                auto to_vert = [](auto&& pnu) -> Vertex {
-                    auto& [p, n, u] = pnu;
-                    return {
-                        .position = { p.x, p.y, p.z },
-                        .normal = { n.x, n.y, n.z },
-                        .uv_coord = { u.x, u.y }
-                    };
-                };
-                auto vertices_view = std::views::zip(positions, normals, uvs) | std::views::transform(to_vert);
+        Assimp::Importer importer {};
+
+        auto mesh_result = import_single_mesh(importer, file_data, file_extension);
+        if (mesh_result.has_error()) {
+            return mesh_result.error();
+        }
+        const aiMesh* assimp_mesh = mesh_result.value();
+
+        Static loaded_model;
+        {
+            PROFILER_ZONE("extract_from_assimp_meshes()", "rendering");
 
-                auto indices_view = faces | std::views::transform(to_span) | std::views::join;
-                auto [ptr, vert, ind] = Utily::InlineArrays::alloc_copy(std::move(vertices_view), std::move(indices_view));
+            auto faces = std::span { assimp_mesh->mFaces, assimp_mesh->mNumFaces };
+            const size_t num_vertices = assimp_mesh->mNumVertices;
 
-                loaded_model.axis_align_bounding_box = get_formatted_aabb();
-                loaded_model.data = std::move(ptr);
-                loaded_model.vertices = vert;
-                loaded_model.indices = ind;
+            // aiProcess_Triangulate + aiProcess_SortByPType leaves a mesh of only triangles in the common case,
+            // then every face's indices land at 3 * face_index and the faces can be copied independently.
+            const bool is_only_triangles = assimp_mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE;
+            const size_t num_indices = is_only_triangles
+                ? faces.size() * 3
+                : std::transform_reduce(faces.begin(), faces.end(), size_t { 0 }, std::plus {}, [](const aiFace& face) {
+                      return static_cast<size_t>(face.mNumIndices);
+                  });
+
+            auto [ptr, vert, ind] = Utily::InlineArrays::alloc_uninit<Vertex, Index>(num_vertices, num_indices);
+
+            scheduler.parallel_for_chunks(num_vertices, EXTRACT_GRAIN_SIZE, [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    std::construct_at(&vert[i], to_vertex(assimp_mesh->mVertices[i], assimp_mesh->mNormals[i], assimp_mesh->mTextureCoords[0][i]));
+                }
+            });
+
+            if (is_only_triangles) {
+                scheduler.parallel_for_chunks(faces.size(), EXTRACT_GRAIN_SIZE, [&](size_t first, size_t last) {
+                    for (size_t f = first; f < last; ++f) {
+                        std::uninitialized_copy_n(faces[f].mIndices, 3, &ind[f * 3]);
+                    }
+                });
+            } else {
+                auto iter = ind.begin();
+                for (const aiFace& face : faces) {
+                    iter = std::uninitialized_copy_n(face.mIndices, face.mNumIndices, iter);
+                }
             }
+
+            loaded_model.axis_align_bounding_box = get_formatted_aabb(*assimp_mesh);
+            loaded_model.data = std::move(ptr);
+            loaded_model.vertices = vert;
+            loaded_model.indices = ind;
         }
         return loaded_model;
     }
@@ -0,0 +1,153 @@
+#include "Profiler/GpuProfiler.hpp"
+#include "Config.hpp"
+#include "Profiler/EngineCounters.hpp"
+
+#include <algorithm>
+#include <limits>
+
+auto GpuProfiler::instance() -> GpuProfiler& {
+    static GpuProfiler profiler {};
+    return profiler;
+}
+
+void GpuProfiler::init() {
+#if defined(CONFIG_TARGET_NATIVE)
+    // Core since 3.3, the web's EXT_disjoint_timer_query_webgl2 has no timestamp queries.
+    _is_active = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (_is_active) {
+        calibrate();
+    }
+#endif
+}
+
+void GpuProfiler::stop() {
+#if defined(CONFIG_TARGET_NATIVE)
+    if (!_is_active) {
+        return;
+    }
+    for (std::vector<uint32_t>& queries : _queries) {
+        if (queries.size()) {
+            glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+        }
+        queries.clear();
+    }
+    _span_frames.reset();
+    _is_active = false;
+#endif
+}
+
+void GpuProfiler::calibrate() {
+#if defined(CONFIG_TARGET_NATIVE)
+    // instance() first, the Profiler decides what a tick is when it's made.
+    auto& profiler = Profiler::instance();
+    GLint64 gpu_now = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+    _cpu_reference_ticks = profiler.now_ticks();
+    _gpu_reference_ns = gpu_now;
+    _frames_since_calibration = 0;
+#endif
+}
+
+void GpuProfiler::issue_timestamp(GpuSpanFrames::Slot slot) {
+#if defined(CONFIG_TARGET_NATIVE)
+    std::vector<uint32_t>& queries = _queries[slot.frame];
+    if (slot.query >= queries.size()) {
+        // Doubling keeps glGenQueries out of the steady state.
+        const size_t old_size = queries.size();
+        queries.resize(std::max<size_t>(old_size * 2, 64));
+        glGenQueries(static_cast<GLsizei>(queries.size() - old_size), queries.data() + old_size);
+    }
+    glQueryCounter(queries[slot.query], GL_TIMESTAMP);
+#endif
+}
+
+auto GpuProfiler::begin_span(uint32_t zone_id) -> GpuSpanFrames::SpanRef {
+    const auto [span, slot] = _span_frames.begin_span(zone_id, Profiler::instance().current_process_id());
+    issue_timestamp(slot);
+    return span;
+}
+
+void GpuProfiler::end_span(GpuSpanFrames::SpanRef span) {
+    if (const auto slot = _span_frames.end_span(span)) {
+        issue_timestamp(*slot);
+    }
+}
+
+auto GpuProfiler::try_read_back([[maybe_unused]] size_t frame_index, [[maybe_unused]] const GpuSpanFrames::Frame& frame) -> bool {
+#if defined(CONFIG_TARGET_NATIVE)
+    const std::vector<uint32_t>& queries = _queries[frame_index];
+    // Queries finish in order, so once the last one is available they all are.
+    GLint is_available = GL_FALSE;
+    glGetQueryObjectiv(queries[frame.num_queries_used - 1], GL_QUERY_RESULT_AVAILABLE, &is_available);
+    if (is_available == GL_FALSE) {
+        return false;
+    }
+
+    auto& timestamps = _timestamps;
+    timestamps.resize(frame.num_queries_used);
+    for (uint32_t i = 0; i < frame.num_queries_used; ++i) {
+        GLuint64 timestamp = 0;
+        glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &timestamp);
+        timestamps[i] = timestamp;
+    }
+
+    auto& profiler = Profiler::instance();
+    const double ticks_per_ns = 1.0 / profiler.ns_per_tick();
+    auto to_ticks = [&](uint64_t gpu_ns) {
+        return _cpu_reference_ticks + static_cast<int64_t>(static_cast<double>(static_cast<int64_t>(gpu_ns) - _gpu_reference_ns) * ticks_per_ns);
+    };
+    uint64_t frame_begin = std::numeric_limits<uint64_t>::max();
+    uint64_t frame_end = 0;
+    for (const GpuSpanFrames::Span& span : frame.spans) {
+        if (span.end_query == GpuSpanFrames::NOT_ENDED) {
+            continue;
+        }
+        const uint64_t begin = timestamps[span.begin_query];
+        const uint64_t end = std::max(timestamps[span.end_query], begin);
+        frame_begin = std::min(frame_begin, begin);
+        frame_end = std::max(frame_end, end);
+        profiler.submit_event(Profiler::Event {
+            .start_ticks = to_ticks(begin),
+            .end_ticks = to_ticks(end),
+            .zone_id = span.zone_id,
+            .process_id = span.process_id,
+            .thread_index = TraceFormat::GPU_THREAD_INDEX,
+        });
+    }
+    if (frame_end >= frame_begin) {
+        _last_frame_gpu_time = std::chrono::nanoseconds(frame_end - frame_begin);
+        EngineCounters::gpu_frame_time_us().record(static_cast<int64_t>((frame_end - frame_begin) / 1000));
+    }
+#endif
+    return true;
+}
+
+void GpuProfiler::end_frame() {
+    if (!_is_active) {
+        return;
+    }
+    PROFILER_ZONE("GpuProfiler::end_frame()", "profiler");
+
+    // If the oldest frame still isn't done when it's reused, the GPU is too far behind to wait for.
+    _span_frames.end_frame([this](size_t frame_index, const GpuSpanFrames::Frame& frame) {
+        return try_read_back(frame_index, frame);
+    });
+
+    if (++_frames_since_calibration >= CALIBRATION_INTERVAL_FRAMES) {
+        calibrate();
+    }
+}
+
+GpuProfiler::Timer::Timer(const Profiler::Zone& zone)
+    : _span {}
+    , _is_recording(zone.is_recording() && GpuProfiler::instance().is_active()) {
+    if (_is_recording) {
+        _span = GpuProfiler::instance().begin_span(zone.id());
+    }
+}
+
+GpuProfiler::Timer::~Timer() {
+    if (_is_recording) {
+        GpuProfiler::instance().end_span(_span);
+    }
+}
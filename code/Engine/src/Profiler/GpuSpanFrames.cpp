@@ -0,0 +1,39 @@
+#include "Profiler/GpuSpanFrames.hpp"
+
+auto GpuSpanFrames::begin_span(uint32_t zone_id, uint16_t process_id) -> std::pair<SpanRef, Slot> {
+    Frame& frame = _frames[_current_frame];
+    const uint32_t query = frame.num_queries_used++;
+    frame.spans.push_back(Span {
+        .zone_id = zone_id,
+        .process_id = process_id,
+        .begin_query = query,
+        .end_query = NOT_ENDED,
+    });
+    return {
+        SpanRef { .frame_number = frame.number, .span_index = static_cast<uint32_t>(frame.spans.size() - 1) },
+        Slot { .frame = _current_frame, .query = query },
+    };
+}
+
+auto GpuSpanFrames::end_span(SpanRef span) -> std::optional<Slot> {
+    // Frame n is always at n % FRAMES_IN_FLIGHT, it's just been reused once the number doesn't match.
+    const size_t index = span.frame_number % FRAMES_IN_FLIGHT;
+    Frame& frame = _frames[index];
+    if (frame.number != span.frame_number || span.span_index >= frame.spans.size()) {
+        return std::nullopt;
+    }
+    const uint32_t query = frame.num_queries_used++;
+    frame.spans[span.span_index].end_query = query;
+    return Slot { .frame = index, .query = query };
+}
+
+void GpuSpanFrames::reset() {
+    _frames = {};
+    _current_frame = 0;
+    _frame_number = 0;
+}
+
+void GpuSpanFrames::clear(Frame& frame) noexcept {
+    frame.num_queries_used = 0;
+    frame.spans.clear();
+}
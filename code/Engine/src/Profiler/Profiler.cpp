@@ -1,94 +1,411 @@
 #include "Profiler/Profiler.hpp"
 #include "Config.hpp"
 
-#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <limits>
 #include <mutex>
+#include <new>
 #include <string>
+#include <utility>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PROFILER_HAS_RDTSC
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace {
+    // Set once by the Profiler constructor, which runs before any zone can be timed.
+    constinit bool s_profiler_uses_tsc = false;
+
+    auto steady_clock_ns() noexcept -> int64_t {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // An invariant TSC ticks at a constant rate across cores and power states, otherwise it can't be used as a clock.
+    auto has_invariant_tsc() noexcept -> bool {
+#if defined(PROFILER_HAS_RDTSC) && defined(_MSC_VER)
+        std::array<int, 4> registers;
+        __cpuid(registers.data(), static_cast<int>(0x80000000));
+        if (static_cast<uint32_t>(registers[0]) < 0x80000007) {
+            return false;
+        }
+        __cpuid(registers.data(), static_cast<int>(0x80000007));
+        return (registers[3] & (1 << 8)) != 0;
+#elif defined(PROFILER_HAS_RDTSC)
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        return (edx & (1u << 8)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    // A TSC read is a handful of cycles rather than a trip through the vDSO, the conversion waits for the export.
+    auto read_ticks() noexcept -> int64_t {
+#if defined(PROFILER_HAS_RDTSC)
+        if (s_profiler_uses_tsc) {
+            return static_cast<int64_t>(__rdtsc());
+        }
+#endif
+        return steady_clock_ns();
+    }
+
+    thread_local void* t_profiler_thread_buffer = nullptr;
+    // A plain pointer, so reading it from inside operator new can't trigger any lazy thread_local construction.
+    thread_local Profiler::Timer* t_profiler_innermost_timer = nullptr;
+}
+
+// Gives the thread's buffer back when the thread exits.
+struct Profiler::ThreadBufferRelease {
+    ~ThreadBufferRelease() {
+        if (auto* buffer = static_cast<ThreadBuffer*>(t_profiler_thread_buffer); buffer) {
+            std::scoped_lock lock(Profiler::instance()._profiler_mutex);
+            buffer->is_owned = false;
+            t_profiler_thread_buffer = nullptr;
+        }
+    }
+};
+
+auto Profiler::now_ticks() noexcept -> int64_t {
+    return read_ticks();
+}
+
+auto Profiler::sample_clocks() noexcept -> ClockSample {
+    // Bracketing the steady_clock read keeps the pair within a few hundred ticks of each other.
+    const int64_t ticks_before = read_ticks();
+    const int64_t ns = steady_clock_ns();
+    const int64_t ticks_after = read_ticks();
+    return ClockSample { .ticks = ticks_before + (ticks_after - ticks_before) / 2, .ns = ns };
+}
+
+auto Profiler::ns_per_tick() const noexcept -> double {
+    if (!s_profiler_uses_tsc) {
+        return 1.0;
+    }
+    // The longer the baseline the better the estimate, so re-measure against startup once there's a decent gap.
+    const ClockSample now = sample_clocks();
+    if (now.ns - _clock_origin.ns < std::chrono::nanoseconds(CALIBRATION_TIME).count() * 10) {
+        return _startup_ns_per_tick;
+    }
+    return static_cast<double>(now.ns - _clock_origin.ns) / static_cast<double>(now.ticks - _clock_origin.ticks);
+}
 
 auto Profiler::instance() -> Profiler& {
     static Profiler profiler = {};
     return profiler;
 }
 
-void Profiler::switch_to_process(std::string_view process) {
-    if constexpr (Config::SKIP_PROFILE) {
-        return;
+Profiler::Profiler()
+    : _profiler_mutex()
+    , _is_enabled(Config::PROFILE_ON_STARTUP)
+    , _categories()
+    , _current_process_id(0)
+    , _clock_origin()
+    , _startup_ns_per_tick(1.0)
+    , _processes({ "default" })
+    , _zones({})
+    , _zone_locations({})
+    , _counters({})
+    , _per_frame_counters()
+    , _per_frame_counter_events({})
+    , _thread_buffers()
+    , _recorded_events({}) {
+    s_profiler_uses_tsc = has_invariant_tsc();
+    _clock_origin = sample_clocks();
+    if (s_profiler_uses_tsc) {
+        // Spin rather than sleep, the point is to measure the rate while the core is busy.
+        ClockSample calibration = sample_clocks();
+        while (calibration.ns - _clock_origin.ns < std::chrono::nanoseconds(CALIBRATION_TIME).count()) {
+            calibration = sample_clocks();
+        }
+        _startup_ns_per_tick = static_cast<double>(calibration.ns - _clock_origin.ns)
+            / static_cast<double>(calibration.ticks - _clock_origin.ticks);
     }
-    _current_process = process;
 }
-void Profiler::submit_timer(const Timer& timer) {
-    if constexpr (Config::SKIP_PROFILE) {
+
+Profiler::Zone::Zone(std::string_view name, std::string_view category, std::source_location location) {
+    Profiler::instance().register_zone(*this, name, category, location);
+}
+
+void Profiler::register_zone(Zone& zone, std::string_view name, std::string_view category, std::source_location location) {
+    std::scoped_lock lock(_profiler_mutex);
+    _zones.push_back(TraceFormat::Zone { .name = std::string(name), .category = std::string(category) });
+    _zone_locations.push_back(location);
+    zone._id = static_cast<uint32_t>(_zones.size() - 1);
+    zone._is_recording = &find_or_add_category_locked(category).is_recording;
+}
+
+Profiler::Counter::Counter(std::string_view name, std::string_view category, Kind kind) {
+    Profiler::instance().register_counter(*this, name, category, kind);
+}
+
+void Profiler::Counter::record(int64_t value) const noexcept {
+    if (!is_recording()) {
         return;
     }
-    _profiler_mutex.lock();
-    auto& recordings = _processes_recordings[_current_process];
-    recordings.emplace_back(timer.name, timer.start_time, timer.end_time, timer.thread_id, timer.categories);
-    _profiler_mutex.unlock();
+    auto& profiler = Profiler::instance();
+    profiler.submit_event(Event {
+        .start_ticks = read_ticks(),
+        .end_ticks = value,
+        .zone_id = _id | Event::COUNTER_BIT,
+        .process_id = profiler._current_process_id.load(std::memory_order_relaxed),
+        .thread_index = 0,
+    });
 }
-auto Profiler::format_as_trace_event_json() -> std::string {
-    if constexpr (Config::SKIP_PROFILE) {
-        return {};
+
+void Profiler::register_counter(Counter& counter, std::string_view name, std::string_view category, Counter::Kind kind) {
+    std::scoped_lock lock(_profiler_mutex);
+    _counters.push_back(TraceFormat::Zone { .name = std::string(name), .category = std::string(category) });
+    counter._id = static_cast<uint32_t>(_counters.size() - 1);
+    counter._is_recording = &find_or_add_category_locked(category).is_recording;
+    if (kind == Counter::Kind::per_frame) {
+        auto per_frame = std::make_unique<PerFrameCounter>();
+        per_frame->counter_id = counter._id;
+        per_frame->is_recording = counter._is_recording;
+        counter._per_frame_total = &per_frame->total;
+        _per_frame_counters.push_back(std::move(per_frame));
     }
+}
 
+auto Profiler::find_or_add_category_locked(std::string_view category) -> Category& {
+    auto iter = std::ranges::find(_categories, category, [](const auto& c) -> std::string_view { return c->name; });
+    if (iter == _categories.end()) {
+        auto new_category = std::make_unique<Category>();
+        new_category->name = std::string(category);
+        new_category->is_recording.store(_is_enabled.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        iter = _categories.insert(_categories.end(), std::move(new_category));
+    }
+    return **iter;
+}
+
+void Profiler::set_enabled(bool is_enabled) {
     std::scoped_lock lock(_profiler_mutex);
+    _is_enabled.store(is_enabled, std::memory_order_relaxed);
+    for (auto& category : _categories) {
+        category->is_recording.store(is_enabled && category->is_enabled.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
 
-    std::string res;
+void Profiler::set_category_enabled(std::string_view category, bool is_enabled) {
+    std::scoped_lock lock(_profiler_mutex);
+    Category& entry = find_or_add_category_locked(category);
+    entry.is_enabled.store(is_enabled, std::memory_order_relaxed);
+    entry.is_recording.store(is_enabled && _is_enabled.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
 
-    res += "{ \n\t\"traceEvents\": [ \n";
+auto Profiler::is_category_enabled(std::string_view category) -> bool {
+    std::scoped_lock lock(_profiler_mutex);
+    auto iter = std::ranges::find(_categories, category, [](const auto& c) -> std::string_view { return c->name; });
+    return iter == _categories.end() || (*iter)->is_enabled.load(std::memory_order_relaxed);
+}
 
-    std::unordered_map<std::thread::id, int> thread_names {};
+auto Profiler::register_thread() -> ThreadBuffer& {
+    thread_local ThreadBufferRelease release_on_exit {};
 
-    for (const auto& [process, recordings] : _processes_recordings) {
-        for (const auto& recording : recordings) {
-            if (std::chrono::duration_cast<std::chrono::nanoseconds>(recording.end_time - recording.start_time).count() < 1000) {
-                continue;
-            }
+    std::scoped_lock lock(_profiler_mutex);
+    auto iter = std::ranges::find_if(_thread_buffers, [](const auto& buffer) { return !buffer->is_owned; });
+    if (iter == _thread_buffers.end()) {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->thread_index = static_cast<uint16_t>(_thread_buffers.size());
+        iter = _thread_buffers.insert(_thread_buffers.end(), std::move(buffer));
+    }
+    ThreadBuffer& buffer = **iter;
+    buffer.is_owned = true;
+    t_profiler_thread_buffer = &buffer;
+    return buffer;
+}
 
-            res += "\t\t{ \"args\":{}, \"name\":\"";
-            res += recording.name;
-
-            if (recording.categories.size()) {
-                res += "\", \"cat\":\"";
-                for (std::ptrdiff_t i = 0; i < recording.categories.size() - 1; ++i) {
-                    res += *(recording.categories.begin() + i);
-                    res += ',';
-                }
-                res += *(recording.categories.end() - 1);
-                res += "\", ";
-            } else {
-                res += "\", ";
-            }
-            res += "\"ph\":\"X\", ";
-            res += "\"ts\":";
-
-            res += std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(recording.start_time - _profiler_start_time).count() / 1000.0);
-            res += ", ";
-            res += "\"dur\":";
-            res += std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(recording.end_time - recording.start_time).count() / 1000.0);
-            res += ", ";
-            res += "\"pid\": \"";
-            res += process;
-            res += "\", \"tid\":\"";
-            if (!thread_names.contains(recording.thread_id)) {
-                thread_names[recording.thread_id] = thread_names.size() + 1;
-            }
-            res += "Thread " + std::to_string(thread_names[recording.thread_id]);
-            res += "\" },\n";
+void Profiler::switch_to_process(std::string_view process) {
+    std::scoped_lock lock(_profiler_mutex);
+    auto iter = std::ranges::find(_processes, process);
+    if (iter == _processes.end()) {
+        iter = _processes.insert(_processes.end(), std::string(process));
+    }
+    _current_process_id.store(static_cast<uint16_t>(std::distance(_processes.begin(), iter)), std::memory_order_relaxed);
+}
+
+void Profiler::submit_event(const Event& event) {
+    auto* buffer = static_cast<ThreadBuffer*>(t_profiler_thread_buffer);
+    if (buffer == nullptr) [[unlikely]] {
+        buffer = &register_thread();
+    }
+
+    const uint64_t write_index = buffer->write_index.load(std::memory_order_relaxed);
+    if (write_index - buffer->read_index.load(std::memory_order_acquire) == ThreadBuffer::CAPACITY) [[unlikely]] {
+        // Full, make room ourselves rather than dropping events.
+        std::scoped_lock lock(_profiler_mutex);
+        drain_locked(*buffer);
+    }
+    Event& slot = buffer->events[write_index % ThreadBuffer::CAPACITY];
+    slot = event;
+    if (!event.is_gpu()) {
+        slot.thread_index = buffer->thread_index;
+    }
+    buffer->write_index.store(write_index + 1, std::memory_order_release);
+}
+
+void Profiler::drain_locked(ThreadBuffer& buffer) {
+    const uint64_t read_index = buffer.read_index.load(std::memory_order_relaxed);
+    const uint64_t write_index = buffer.write_index.load(std::memory_order_acquire);
+    if constexpr (Config::TRACK_ALLOCATIONS) {
+        for (uint64_t i = read_index; i < write_index; ++i) {
+            record_allocations_locked(buffer.events[i % ThreadBuffer::CAPACITY]);
         }
     }
-    if (_processes_recordings.size()) {
+    if (_zone_stats) {
+        for (uint64_t i = read_index; i < write_index; ++i) {
+            record_zone_stats_locked(buffer.events[i % ThreadBuffer::CAPACITY]);
+        }
+    }
+    if (_flight_recorder) {
+        for (uint64_t i = read_index; i < write_index; ++i) {
+            record_flight_event_locked(buffer.events[i % ThreadBuffer::CAPACITY]);
+        }
+    } else {
+        auto& destination = _stream ? _stream->pending_events : _recorded_events;
+        for (uint64_t i = read_index; i < write_index; ++i) {
+            destination.push_back(buffer.events[i % ThreadBuffer::CAPACITY]);
+        }
+    }
+    buffer.read_index.store(write_index, std::memory_order_release);
+}
+
+void Profiler::record_flight_event_locked(const Event& event) {
+    FlightRecorder& recorder = *_flight_recorder;
+    const size_t capacity = recorder.ring.size();
+    if (recorder.size == capacity) {
+        recorder.head = (recorder.head + 1) % capacity;
+        --recorder.size;
+    }
+    recorder.ring[(recorder.head + recorder.size) % capacity] = event;
+    ++recorder.size;
+    recorder.latest_end_ticks = std::max(recorder.latest_end_ticks, event.finish_ticks());
+
+    // Threads drain at different times so the ring is only roughly in time order, good enough to expire by.
+    const int64_t window_start = recorder.latest_end_ticks - recorder.window_ticks;
+    while (recorder.size > 0 && recorder.ring[recorder.head].finish_ticks() < window_start) {
+        recorder.head = (recorder.head + 1) % capacity;
+        --recorder.size;
+    }
+}
+
+auto Profiler::recorded_events_locked(std::vector<Event>& scratch) -> std::span<const Event> {
+    if (!_flight_recorder) {
+        return _recorded_events;
+    }
+    const FlightRecorder& recorder = *_flight_recorder;
+    const int64_t window_start = recorder.latest_end_ticks - recorder.window_ticks;
+    scratch.clear();
+    scratch.reserve(recorder.size);
+    for (size_t i = 0; i < recorder.size; ++i) {
+        const Event& event = recorder.ring[(recorder.head + i) % recorder.ring.size()];
+        if (event.finish_ticks() >= window_start) {
+            scratch.push_back(event);
+        }
+    }
+    return scratch;
+}
+
+void Profiler::collect() {
+    std::scoped_lock lock(_profiler_mutex);
+    collect_locked();
+}
+
+void Profiler::collect_locked() {
+    for (auto& buffer : _thread_buffers) {
+        drain_locked(*buffer);
+    }
+}
+
+auto Profiler::to_trace_event(const Event& event, double ns_per_tick) const noexcept -> TraceFormat::Event {
+    auto to_ns = [&](int64_t ticks) {
+        return static_cast<int64_t>(static_cast<double>(ticks - _clock_origin.ticks) * ns_per_tick);
+    };
+    return TraceFormat::Event {
+        .start_ns = to_ns(event.start_ticks),
+        .end_ns = to_ns(event.end_ticks),
+        .zone_id = event.zone_id,
+        .process_id = event.process_id,
+        .thread_index = event.thread_index,
+#if CONFIG_TRACK_ALLOCATIONS
+        .allocations = event.allocations,
+        .allocated_bytes = event.allocated_bytes,
+#endif
+    };
+}
+
+auto Profiler::to_trace_counter_event(const Event& event, double ns_per_tick) const noexcept -> TraceFormat::CounterEvent {
+    return TraceFormat::CounterEvent {
+        .time_ns = static_cast<int64_t>(static_cast<double>(event.start_ticks - _clock_origin.ticks) * ns_per_tick),
+        .value = event.end_ticks,
+        .counter_id = event.zone_id & ~Event::COUNTER_BIT,
+        .process_id = event.process_id,
+    };
+}
+
+// Sub-microsecond zones just clutter the JSON viewers, the binary trace keeps them.
+static auto is_worth_showing_in_json(const TraceFormat::Event& event) -> bool {
+    return event.end_ns - event.start_ns >= 1000;
+}
+
+void Profiler::append_json_events(std::string& out, std::span<const Event> recorded_events, const TraceTables& tables, double ns_per_tick) const {
+    for (const Event& recorded_event : recorded_events) {
+        if (recorded_event.is_counter()) {
+            const auto event = to_trace_counter_event(recorded_event, ns_per_tick);
+            TraceFormat::append_chrome_json_counter(out, event, tables.counters[event.counter_id], tables.processes[event.process_id]);
+            continue;
+        }
+        const auto event = to_trace_event(recorded_event, ns_per_tick);
+        if (is_worth_showing_in_json(event)) {
+            TraceFormat::append_chrome_json_event(out, event, tables.zones[event.zone_id], tables.processes[event.process_id]);
+        }
+    }
+}
+
+void Profiler::append_binary_events(TraceFormat::Writer& writer, std::string& out, std::span<const Event> recorded_events, double ns_per_tick) const {
+    std::vector<TraceFormat::Event> events;
+    std::vector<TraceFormat::CounterEvent> counter_events;
+    events.reserve(recorded_events.size());
+    for (const Event& recorded_event : recorded_events) {
+        if (recorded_event.is_counter()) {
+            counter_events.push_back(to_trace_counter_event(recorded_event, ns_per_tick));
+        } else {
+            events.push_back(to_trace_event(recorded_event, ns_per_tick));
+        }
+    }
+    writer.write_events(out, events);
+    writer.write_counter_events(out, counter_events);
+}
+
+auto Profiler::format_as_trace_event_json() -> std::string {
+    collect();
+
+    std::scoped_lock lock(_profiler_mutex);
+
+    std::vector<Event> scratch;
+    std::string res { TraceFormat::CHROME_JSON_BEGIN };
+    append_json_events(res, recorded_events_locked(scratch), TraceTables { _zones, _counters, _processes }, ns_per_tick());
+    if (res.ends_with(",\n")) {
         res.pop_back(); // remove \n
         res.pop_back(); // remove ,
     }
-    res += "\n\t]\n}";
+    res += TraceFormat::CHROME_JSON_END;
 
     return res;
 }
-auto Profiler::save_as_trace_event_json(std::filesystem::path path) -> Utily::Result<void, Utily::Error> {
-    if constexpr (Config::SKIP_PROFILE) {
-        return {};
-    }
 
+auto Profiler::save_as_trace_event_json(std::filesystem::path path) -> Utily::Result<void, Utily::Error> {
     auto contents = Profiler::format_as_trace_event_json();
     std::ofstream fileStream(path, std::ios::out | std::ios::trunc);
     if (!fileStream) {
@@ -115,33 +432,648 @@ auto Profiler::save_as_trace_event_json(std::filesystem::path path) -> Utily::Re
     return {};
 }
 
+auto Profiler::format_as_binary_trace() -> std::string {
+    collect();
+
+    std::scoped_lock lock(_profiler_mutex);
+    std::vector<Event> scratch;
+    return format_as_binary_trace_locked(recorded_events_locked(scratch));
+}
+
+auto Profiler::format_as_binary_trace_locked(std::span<const Event> recorded_events) -> std::string {
+    TraceFormat::Writer writer;
+    std::string res;
+    writer.write_header(res);
+    for (uint32_t i = 0; i < _zones.size(); ++i) {
+        writer.write_zone(res, i, _zones[i].name, _zones[i].category);
+    }
+    for (uint32_t i = 0; i < _counters.size(); ++i) {
+        writer.write_counter(res, i, _counters[i].name, _counters[i].category);
+    }
+    for (uint16_t i = 0; i < _processes.size(); ++i) {
+        writer.write_process(res, i, _processes[i]);
+    }
+    append_binary_events(writer, res, recorded_events, ns_per_tick());
+    writer.write_end(res);
+
+    return res;
+}
+
+auto Profiler::save_as_binary_trace(std::filesystem::path path) -> Utily::Result<void, Utily::Error> {
+    auto contents = Profiler::format_as_binary_trace();
+    std::ofstream fileStream(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!fileStream) {
+        return Utily::Error("Unable to open file for writing");
+    }
+    fileStream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    return {};
+}
+
+auto Profiler::start_streaming(std::filesystem::path path, std::chrono::milliseconds flush_interval, TraceFileFormat format)
+    -> Utily::Result<void, Utily::Error> {
+    if constexpr (Config::PLATFORM == Config::TargetPlatform::web) {
+        return Utily::Error("Streaming the trace needs a background thread, which isn't available on web.");
+    }
+    if (is_streaming()) {
+        return Utily::Error("Already streaming the trace.");
+    }
+    if (is_flight_recording()) {
+        return Utily::Error("Can't stream the trace while the flight recorder is on.");
+    }
+
+    auto stream = std::make_unique<Stream>();
+    stream->format = format;
+    stream->flush_interval = flush_interval;
+    stream->file.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!stream->file) {
+        return Utily::Error("Unable to open file for writing");
+    }
+
+    std::string header;
+    if (format == TraceFileFormat::json) {
+        header = TraceFormat::CHROME_JSON_BEGIN;
+    } else {
+        stream->binary_writer.write_header(header);
+    }
+    stream->file << header;
+
+    // Anything recorded so far goes out with the first flush.
+    collect();
+    {
+        std::scoped_lock lock(_profiler_mutex);
+        stream->pending_events = std::move(_recorded_events);
+        _recorded_events = {};
+        _stream = std::move(stream);
+        _stream->writer = std::thread([this, &stream = *_stream]() { stream_writer_main(stream); });
+    }
+    return {};
+}
+
+void Profiler::stream_writer_main(Stream& stream) {
+    bool is_stopping = false;
+    while (!is_stopping) {
+        {
+            std::unique_lock lock(stream.wake_mutex);
+            is_stopping = stream.wake.wait_for(lock, stream.flush_interval, [&] { return stream.is_stopping; });
+        }
+        collect();
+        write_stream_chunk(stream);
+    }
+}
+
+void Profiler::write_stream_chunk(Stream& stream) {
+    std::vector<Event>& writing_events = stream.writing_events;
+    std::string& writing = stream.writing;
+    {
+        std::scoped_lock lock(_profiler_mutex);
+        std::swap(writing_events, stream.pending_events);
+        // The tables only ever grow, so just copy the new entries.
+        stream.zones.insert(stream.zones.end(), _zones.begin() + stream.zones.size(), _zones.end());
+        stream.counters.insert(stream.counters.end(), _counters.begin() + stream.counters.size(), _counters.end());
+        stream.processes.insert(stream.processes.end(), _processes.begin() + stream.processes.size(), _processes.end());
+    }
+
+    const double ns_per_tick = Profiler::ns_per_tick();
+    if (stream.format == TraceFileFormat::json) {
+        append_json_events(writing, writing_events, TraceTables { stream.zones, stream.counters, stream.processes }, ns_per_tick);
+        if (!writing.empty()) {
+            // Events are formatted as `event,\n`, so this chunk's separator goes before it instead.
+            writing.resize(writing.size() - 2);
+            if (stream.has_written_event) {
+                writing.insert(0, ",\n");
+            }
+            stream.has_written_event = true;
+        }
+    } else {
+        for (; stream.num_zones_written < stream.zones.size(); ++stream.num_zones_written) {
+            const auto& zone = stream.zones[stream.num_zones_written];
+            stream.binary_writer.write_zone(writing, static_cast<uint32_t>(stream.num_zones_written), zone.name, zone.category);
+        }
+        for (; stream.num_counters_written < stream.counters.size(); ++stream.num_counters_written) {
+            const auto& counter = stream.counters[stream.num_counters_written];
+            stream.binary_writer.write_counter(writing, static_cast<uint32_t>(stream.num_counters_written), counter.name, counter.category);
+        }
+        for (; stream.num_processes_written < stream.processes.size(); ++stream.num_processes_written) {
+            stream.binary_writer.write_process(writing, static_cast<uint16_t>(stream.num_processes_written), stream.processes[stream.num_processes_written]);
+        }
+        append_binary_events(stream.binary_writer, writing, writing_events, ns_per_tick);
+    }
+
+    stream.file.write(writing.data(), static_cast<std::streamsize>(writing.size()));
+    stream.file.flush();
+    writing.clear();
+    writing_events.clear();
+}
+
+void Profiler::stop_streaming() {
+    {
+        std::scoped_lock lock(_profiler_mutex);
+        if (!_stream) {
+            return;
+        }
+        {
+            std::scoped_lock wake_lock(_stream->wake_mutex);
+            _stream->is_stopping = true;
+        }
+        _stream->wake.notify_one();
+    }
+    // The writer does one last collect() before exiting, it needs the profiler mutex for that.
+    _stream->writer.join();
+
+    // Threads can still drain into pending_events after the writer's last chunk, so those are written here.
+    // Anything drained after _stream is cleared goes to _recorded_events instead.
+    std::unique_ptr<Stream> stream;
+    {
+        std::scoped_lock lock(_profiler_mutex);
+        collect_locked();
+        stream = std::move(_stream);
+    }
+    write_stream_chunk(*stream);
+
+    std::string footer;
+    if (stream->format == TraceFileFormat::json) {
+        footer = TraceFormat::CHROME_JSON_END;
+    } else {
+        stream->binary_writer.write_end(footer);
+    }
+    stream->file << footer;
+    stream->file.close();
+}
+
+auto Profiler::is_streaming() -> bool {
+    std::scoped_lock lock(_profiler_mutex);
+    return _stream != nullptr;
+}
+
+auto Profiler::start_flight_recorder(FlightRecorderSettings settings) -> Utily::Result<void, Utily::Error> {
+    if (settings.max_events == 0) {
+        return Utily::Error("The flight recorder needs room for at least one event.");
+    }
+
+    collect();
+
+    std::scoped_lock lock(_profiler_mutex);
+    if (_stream) {
+        return Utily::Error("Can't use the flight recorder while streaming the trace.");
+    }
+    if (_flight_recorder) {
+        return Utily::Error("The flight recorder is already on.");
+    }
+    auto recorder = std::make_unique<FlightRecorder>();
+    recorder->settings = std::move(settings);
+    recorder->ring.resize(recorder->settings.max_events);
+    recorder->window_ticks = static_cast<int64_t>(
+        static_cast<double>(std::chrono::nanoseconds(recorder->settings.window).count()) / _startup_ns_per_tick);
+    _flight_recorder = std::move(recorder);
+
+    // Whatever was recorded so far is kept if it's recent enough, then the unbounded recording is freed.
+    for (const Event& event : _recorded_events) {
+        record_flight_event_locked(event);
+    }
+    _recorded_events = {};
+    return {};
+}
+
+void Profiler::stop_flight_recorder() {
+    collect();
+
+    std::scoped_lock lock(_profiler_mutex);
+    if (!_flight_recorder) {
+        return;
+    }
+    std::vector<Event> window;
+    recorded_events_locked(window);
+    _recorded_events = std::move(window);
+    _flight_recorder = nullptr;
+}
+
+auto Profiler::is_flight_recording() -> bool {
+    std::scoped_lock lock(_profiler_mutex);
+    return _flight_recorder != nullptr;
+}
+
+auto Profiler::dump_flight_recorder(std::filesystem::path path) -> Utily::Result<void, Utily::Error> {
+    PROFILER_ZONE("Profiler::dump_flight_recorder()", "profiler");
+
+    collect();
+
+    std::string contents;
+    {
+        std::scoped_lock lock(_profiler_mutex);
+        if (!_flight_recorder) {
+            return Utily::Error("The flight recorder isn't on.");
+        }
+        std::vector<Event> window;
+        contents = format_as_binary_trace_locked(recorded_events_locked(window));
+    }
+
+    std::ofstream fileStream(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!fileStream) {
+        return Utily::Error("Unable to open file for writing");
+    }
+    fileStream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    return {};
+}
+
+void Profiler::start_zone_stats(size_t num_frames) {
+    std::scoped_lock lock(_profiler_mutex);
+    auto stats = std::make_unique<ZoneStatsWindow>();
+    // The frame being recorded plus the last num_frames finished ones.
+    stats->frames.resize(std::max<size_t>(num_frames, 1) + 1);
+    _zone_stats = std::move(stats);
+}
+
+void Profiler::stop_zone_stats() {
+    std::scoped_lock lock(_profiler_mutex);
+    _zone_stats = nullptr;
+}
+
+void Profiler::record_zone_stats_locked(const Event& event) {
+    if (event.is_counter()) {
+        return;
+    }
+    ZoneStatsWindow& stats = *_zone_stats;
+    if (stats.histograms.size() <= event.zone_id) {
+        stats.histograms.resize(_zones.size());
+    }
+    auto& histogram = stats.histograms[event.zone_id];
+    if (!histogram) {
+        histogram = std::make_unique<HdrHistogram>();
+    }
+    const auto duration = static_cast<uint64_t>(event.end_ticks - event.start_ticks);
+    histogram->record(duration);
+    stats.frames[stats.current_frame].push_back(ZoneSample { .zone_id = event.zone_id, .duration = duration });
+}
+
+void Profiler::advance_zone_stats_frame_locked() {
+    ZoneStatsWindow& stats = *_zone_stats;
+    stats.current_frame = (stats.current_frame + 1) % stats.frames.size();
+    stats.num_frames_finished = std::min(stats.num_frames_finished + 1, stats.frames.size() - 1);
+    // The oldest frame leaves the window.
+    auto& expired = stats.frames[stats.current_frame];
+    for (const ZoneSample& sample : expired) {
+        stats.histograms[sample.zone_id]->remove(sample.duration);
+    }
+    expired.clear();
+}
+
+auto Profiler::make_zone_stats_locked(const HdrHistogram& histogram, uint32_t zone_id, double ns_per_tick) const -> ZoneStats {
+    // The histograms are in ticks.
+    return ZoneStats {
+        .name = _zones[zone_id].name,
+        .category = _zones[zone_id].category,
+        .count = histogram.count(),
+        .mean_ns = histogram.mean() * ns_per_tick,
+        .p50_ns = static_cast<double>(histogram.percentile(50.0)) * ns_per_tick,
+        .p95_ns = static_cast<double>(histogram.percentile(95.0)) * ns_per_tick,
+        .p99_ns = static_cast<double>(histogram.percentile(99.0)) * ns_per_tick,
+        .max_ns = static_cast<double>(histogram.max()) * ns_per_tick,
+        .per_frame_ns = static_cast<double>(histogram.total()) * ns_per_tick / static_cast<double>(std::max<size_t>(_zone_stats->num_frames_finished, 1)),
+    };
+}
+
+auto Profiler::zone_stats(std::string_view name) -> std::optional<ZoneStats> {
+    std::scoped_lock lock(_profiler_mutex);
+    if (!_zone_stats) {
+        return std::nullopt;
+    }
+    collect_locked();
+
+    const auto& histograms = _zone_stats->histograms;
+    std::optional<HdrHistogram> merged;
+    uint32_t first_zone_id = 0;
+    for (uint32_t zone_id = 0; zone_id < histograms.size(); ++zone_id) {
+        if (!histograms[zone_id] || histograms[zone_id]->count() == 0 || _zones[zone_id].name != name) {
+            continue;
+        }
+        if (!merged) {
+            merged = *histograms[zone_id];
+            first_zone_id = zone_id;
+        } else {
+            merged->merge(*histograms[zone_id]);
+        }
+    }
+    if (!merged) {
+        return std::nullopt;
+    }
+    return make_zone_stats_locked(*merged, first_zone_id, ns_per_tick());
+}
+
+auto Profiler::all_zone_stats() -> std::vector<ZoneStats> {
+    std::scoped_lock lock(_profiler_mutex);
+    if (!_zone_stats) {
+        return {};
+    }
+    collect_locked();
+
+    std::vector<ZoneStats> res;
+    const double ns_per_tick = Profiler::ns_per_tick();
+    const auto& histograms = _zone_stats->histograms;
+    for (uint32_t zone_id = 0; zone_id < histograms.size(); ++zone_id) {
+        if (histograms[zone_id] && histograms[zone_id]->count() > 0) {
+            res.push_back(make_zone_stats_locked(*histograms[zone_id], zone_id, ns_per_tick));
+        }
+    }
+    std::ranges::sort(res, std::ranges::greater {}, &ZoneStats::per_frame_ns);
+    return res;
+}
+
+void Profiler::record_allocations_locked([[maybe_unused]] const Event& event) {
+#if CONFIG_TRACK_ALLOCATIONS
+    if (event.is_counter() || event.is_gpu()) {
+        return;
+    }
+    if (_allocation_totals.size() <= event.zone_id) {
+        _allocation_totals.resize(_zones.size());
+    }
+    AllocationTotals& totals = _allocation_totals[event.zone_id];
+    ++totals.count;
+    totals.allocations += event.allocations;
+    totals.allocated_bytes += event.allocated_bytes;
+#endif
+}
+
+auto Profiler::allocation_stats(std::string_view name) -> std::optional<AllocationStats> {
+    std::scoped_lock lock(_profiler_mutex);
+    collect_locked();
+
+    std::optional<AllocationStats> res;
+    for (uint32_t zone_id = 0; zone_id < _allocation_totals.size(); ++zone_id) {
+        const AllocationTotals& totals = _allocation_totals[zone_id];
+        if (totals.count == 0 || _zones[zone_id].name != name) {
+            continue;
+        }
+        if (!res) {
+            res = AllocationStats { .name = _zones[zone_id].name, .category = _zones[zone_id].category, .count = 0, .allocations = 0, .allocated_bytes = 0 };
+        }
+        res->count += totals.count;
+        res->allocations += totals.allocations;
+        res->allocated_bytes += totals.allocated_bytes;
+    }
+    return res;
+}
+
+auto Profiler::all_allocation_stats() -> std::vector<AllocationStats> {
+    std::scoped_lock lock(_profiler_mutex);
+    collect_locked();
+
+    std::vector<AllocationStats> res;
+    for (uint32_t zone_id = 0; zone_id < _allocation_totals.size(); ++zone_id) {
+        const AllocationTotals& totals = _allocation_totals[zone_id];
+        if (totals.allocations > 0) {
+            res.push_back(AllocationStats {
+                .name = _zones[zone_id].name,
+                .category = _zones[zone_id].category,
+                .count = totals.count,
+                .allocations = totals.allocations,
+                .allocated_bytes = totals.allocated_bytes,
+            });
+        }
+    }
+    std::ranges::sort(res, std::ranges::greater {}, &AllocationStats::allocated_bytes);
+    return res;
+}
+
+void Profiler::reset_allocation_stats() {
+    std::scoped_lock lock(_profiler_mutex);
+    collect_locked();
+    _allocation_totals.clear();
+}
+
+auto Profiler::mark_frame(std::chrono::nanoseconds frame_time) -> std::optional<std::filesystem::path> {
+    {
+        // The totals are submitted outside the lock, submit_event() takes it when a thread buffer fills up.
+        std::unique_lock lock(_profiler_mutex);
+        const int64_t now = read_ticks();
+        const uint16_t process_id = _current_process_id.load(std::memory_order_relaxed);
+        _per_frame_counter_events.clear();
+        for (auto& counter : _per_frame_counters) {
+            if (counter->is_recording->load(std::memory_order_relaxed)) {
+                _per_frame_counter_events.push_back(Event {
+                    .start_ticks = now,
+                    .end_ticks = counter->total.exchange(0, std::memory_order_relaxed),
+                    .zone_id = counter->counter_id | Event::COUNTER_BIT,
+                    .process_id = process_id,
+                    .thread_index = 0,
+                });
+            }
+        }
+        auto events = std::move(_per_frame_counter_events);
+        lock.unlock();
+        for (const Event& event : events) {
+            submit_event(event);
+        }
+        lock.lock();
+        _per_frame_counter_events = std::move(events);
+    }
+
+    std::filesystem::path path;
+    {
+        std::scoped_lock lock(_profiler_mutex);
+        if (_zone_stats) {
+            // Whatever finished this frame counts towards it, then the window slides along.
+            collect_locked();
+            advance_zone_stats_frame_locked();
+        }
+        if (!_flight_recorder || frame_time <= _flight_recorder->settings.frame_budget) {
+            return std::nullopt;
+        }
+        FlightRecorder& recorder = *_flight_recorder;
+        const auto now = std::chrono::steady_clock::now();
+        if (recorder.last_dump && now - *recorder.last_dump < recorder.settings.dump_cooldown) {
+            return std::nullopt;
+        }
+        recorder.last_dump = now;
+        path = recorder.settings.dump_directory
+            / ("flight_recorder_" + std::to_string(recorder.num_dumps++) + std::string(TraceFormat::FILE_EXTENSION));
+    }
+
+    if (dump_flight_recorder(path).has_error()) {
+        return std::nullopt;
+    }
+    return path;
+}
+
 Profiler::~Profiler() {
-    if constexpr (Config::SKIP_PROFILE) {
+    if (is_streaming()) {
+        stop_streaming();
         return;
     }
+    collect();
+    {
+        // Don't leave an empty trace behind when profiling was never switched on.
+        std::scoped_lock lock(_profiler_mutex);
+        if (_recorded_events.empty() && (!_flight_recorder || _flight_recorder->size == 0)) {
+            return;
+        }
+    }
     Profiler::save_as_trace_event_json(TRACE_FILE_NAME);
 }
 
-auto now = []() {
-    thread_local std::chrono::steady_clock::time_point last_time = std::chrono::high_resolution_clock::now();
-    auto curr = std::chrono::high_resolution_clock::now();
-    if (curr <= last_time) {
-        curr = last_time + std::chrono::nanoseconds(10);
+Profiler::Timer::Timer(const Zone& zone)
+    : _start_ticks(0)
+    , _zone_id(zone.id())
+    , _is_recording(zone.is_recording())
+    , _allocations(0)
+    , _allocated_bytes(0)
+    , _parent(nullptr) {
+    if (_is_recording) {
+        if constexpr (Config::TRACK_ALLOCATIONS) {
+            _parent = std::exchange(t_profiler_innermost_timer, this);
+        }
+        _start_ticks = read_ticks();
     }
-    last_time = curr;
-    return curr;
-};
+}
 
-Profiler::Timer::Timer(std::string function_name, std::vector<std::string_view> cats)
-    : name(std::move(function_name))
-    , start_time(now())
-    , end_time(now())
-    , thread_id(std::this_thread::get_id())
-    , categories(cats) { }
 Profiler::Timer::~Timer() {
-    if constexpr (Config::SKIP_PROFILE) {
+    if (!_is_recording) {
         return;
     }
-    end_time = now();
-    Profiler::instance().submit_timer(*this);
-}
\ No newline at end of file
+    const int64_t end_ticks = read_ticks();
+    if constexpr (Config::TRACK_ALLOCATIONS) {
+        // Before submitting, so the ring buffer registration of a new thread isn't charged to this zone.
+        // Only while it's still the innermost, so timers ended out of order can't leave a dead one behind.
+        if (t_profiler_innermost_timer == this) {
+            t_profiler_innermost_timer = _parent;
+        }
+    }
+    Profiler::instance().submit_event(Event {
+        .start_ticks = _start_ticks,
+        .end_ticks = end_ticks,
+        .zone_id = _zone_id,
+        .process_id = Profiler::instance()._current_process_id.load(std::memory_order_relaxed),
+        .thread_index = 0,
+#if CONFIG_TRACK_ALLOCATIONS
+        .allocations = _allocations,
+        .allocated_bytes = static_cast<uint32_t>(std::min<uint64_t>(_allocated_bytes, std::numeric_limits<uint32_t>::max())),
+#endif
+    });
+}
+
+void Profiler::Timer::count_allocation(size_t bytes) noexcept {
+    if (Timer* timer = t_profiler_innermost_timer; timer) {
+        ++timer->_allocations;
+        timer->_allocated_bytes += bytes;
+    }
+}
+
+#if CONFIG_TRACK_ALLOCATIONS
+// The replaceable global allocation functions, they count against the innermost zone and forward to malloc.
+// Nothing in here may allocate.
+namespace {
+    template <typename Allocate>
+    auto profiler_tracked_new(size_t size, Allocate&& allocate) -> void* {
+        Profiler::Timer::count_allocation(size);
+        while (true) {
+            if (void* ptr = allocate(); ptr) {
+                return ptr;
+            }
+            auto handler = std::get_new_handler();
+            if (!handler) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    auto profiler_malloc(size_t size) noexcept -> void* {
+        return std::malloc(size ? size : 1);
+    }
+
+    auto profiler_aligned_malloc(size_t size, std::align_val_t alignment) noexcept -> void* {
+        const auto align = static_cast<size_t>(alignment);
+#if defined(_MSC_VER)
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        // aligned_alloc() wants a non-zero multiple of the alignment.
+        return std::aligned_alloc(align, std::max((size + align - 1) / align, size_t { 1 }) * align);
+#endif
+    }
+
+    void profiler_aligned_free(void* ptr) noexcept {
+#if defined(_MSC_VER)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+auto operator new(size_t size) -> void* {
+    return profiler_tracked_new(size, [&] { return profiler_malloc(size); });
+}
+auto operator new[](size_t size) -> void* {
+    return profiler_tracked_new(size, [&] { return profiler_malloc(size); });
+}
+auto operator new(size_t size, std::align_val_t alignment) -> void* {
+    return profiler_tracked_new(size, [&] { return profiler_aligned_malloc(size, alignment); });
+}
+auto operator new[](size_t size, std::align_val_t alignment) -> void* {
+    return profiler_tracked_new(size, [&] { return profiler_aligned_malloc(size, alignment); });
+}
+auto operator new(size_t size, const std::nothrow_t&) noexcept -> void* {
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+auto operator new[](size_t size, const std::nothrow_t&) noexcept -> void* {
+    try {
+        return operator new[](size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+auto operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept -> void* {
+    try {
+        return operator new(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+auto operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept -> void* {
+    try {
+        return operator new[](size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    profiler_aligned_free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    profiler_aligned_free(ptr);
+}
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    profiler_aligned_free(ptr);
+}
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+    profiler_aligned_free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    profiler_aligned_free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    profiler_aligned_free(ptr);
+}
+#endif // CONFIG_TRACK_ALLOCATIONS
@@ -1,4 +1,5 @@
 #include "Renderer/FontBatchRenderer.hpp"
+#include "Profiler/Profiler.hpp"
 
 namespace Renderer {
 
@@ -33,6 +34,9 @@ namespace Renderer {
         "    }\n"
         "}";
 
+    // Enough for a few thousand glyphs before it has to grow.
+    constexpr static size_t STREAMING_BYTES_PER_FRAME = 64 * 1024;
+
     void FontBatchRenderer::load_text_into_vb(const std::string_view& text, glm::vec2 bottom_left, float height_px) {
         int v = static_cast<int>(_m.current_batch_vertices.size());
         _m.current_batch_vertices.resize(_m.current_batch_vertices.size() + text.size() * 4);
@@ -85,7 +89,7 @@ namespace Renderer {
 
         auto [s_handle, shader] = resource_manager.create_and_init_resource<Core::Shader>(FBR_SHADER_VERT_SRC, FBR_SHADER_FRAG_SRC);
         auto [t_handle, texture] = resource_manager.create_and_init_resource<Core::Texture>();
-        auto [vb_handle, vertex_buffer] = resource_manager.create_and_init_resource<Core::VertexBuffer>();
+        auto [vb_handle, vertex_buffer] = resource_manager.create_and_init_resource<Core::VertexBuffer>(Core::Streaming { .bytes_per_frame = STREAMING_BYTES_PER_FRAME });
         auto [ib_handle, index_buffer] = resource_manager.create_and_init_resource<Core::IndexBuffer>();
         auto [va_handle, vertex_array] = resource_manager.create_and_init_resource<Core::VertexArray>(Vertex::VBL {}, vertex_buffer, index_buffer);
 
@@ -93,6 +97,14 @@ namespace Renderer {
         if (texture_upload_result.has_error()) {
             return texture_upload_result.error();
         }
+        auto u_texture = shader.uniform<int32_t>("u_texture");
+        if (u_texture.has_error()) {
+            return u_texture.error();
+        }
+        auto u_colour = shader.uniform<glm::vec4>("u_colour");
+        if (u_colour.has_error()) {
+            return u_colour.error();
+        }
 
         return FontBatchRenderer(M {
             .current_batch_vertices = {},
@@ -103,6 +115,8 @@ namespace Renderer {
             .vb = vb_handle,
             .ib = ib_handle,
             .va = va_handle,
+            .u_texture = u_texture.value(),
+            .u_colour = u_colour.value(),
         });
     }
 
@@ -111,19 +125,19 @@ namespace Renderer {
         _m.current_batch_config.emplace(std::move(batch_config));
     }
     void FontBatchRenderer::push_to_batch(std::string_view text, glm::vec2 bottom_left, float height_px) {
-        Profiler::Timer timer("FontBatchRenderer::push_to_batch()", {});
+        PROFILER_ZONE("FontBatchRenderer::push_to_batch()");
         assert(_m.current_batch_config);
         load_text_into_vb(text, bottom_left, height_px);
     }
     void FontBatchRenderer::end_batch() {
         // 1. Validate a batch config has been passed in.
-        // 2. Get resources, bind, set uniforms, load vertices.
+        // 2. Get resources and load vertices.
         // 3. Ensure the index buffer has enough loaded for the vertex buffer.
-        // 4. Disable depth testing, draw, and then re-enable depth testing.
+        // 4. Queue the draw as an overlay, without depth testing.
         // 5. Clear batch's config and vertices.
 
         // 1.
-        Profiler::Timer timer("FontBatchRenderer::end_batch()", {});
+        PROFILER_ZONE("FontBatchRenderer::end_batch()");
         assert(_m.current_batch_config);
         if (_m.current_batch_vertices.size() == 0) {
             assert(false && "redundant batching");
@@ -132,20 +146,14 @@ namespace Renderer {
 
         // 2.
         auto [s, t, va, vb, ib] = _m.current_batch_config->resource_manager.get_resources(_m.s, _m.t, _m.va, _m.vb, _m.ib);
-        const int32_t texture_slot = t.bind().value();
-        s.bind();
-        va.bind();
-        ib.bind();
         vb.bind();
-
-        s.set_uniform("u_texture", texture_slot).on_error(Panic {});
-        s.set_uniform("u_colour", _m.current_batch_config->font_colour).on_error(Panic {});
         vb.load_vertices(_m.current_batch_vertices);
 
         // 3.
-        if (ib.get_count() < _m.current_batch_vertices.size() / 4 * 6) {
+        const size_t index_count = _m.current_batch_vertices.size() / 4 * 6;
+        if (ib.get_count() < index_count) {
             std::vector<Model::Index> indices;
-            indices.resize(_m.current_batch_vertices.size() / (size_t)4 * (size_t)6, 0);
+            indices.resize(index_count, 0);
 
             for (int v = 0, i = 0; i < indices.size(); i += 6, v += 4) {
                 indices[i + 0] = v + 0;
@@ -156,16 +164,27 @@ namespace Renderer {
                 indices[i + 5] = v + 0;
             }
             assert(indices.size());
+            va.bind();
+            ib.bind();
             ib.load_indices(indices);
         }
 
         // 4.
-        {
-            Profiler::Timer draw_timer("glDrawElements()", {});
-            glDisable(GL_DEPTH_TEST);
-            glDrawElements(GL_TRIANGLES, _m.current_batch_vertices.size() / 4 * 6, GL_UNSIGNED_INT, (void*)0);
-            glEnable(GL_DEPTH_TEST);
-        }
+        _m.current_batch_config->render_queue.push(RenderQueue::DrawPacket {
+            .pass = RenderQueue::Pass::overlay,
+            .is_translucent = true,
+            .is_depth_tested = false,
+            .shader = &s,
+            .vertex_array = &va,
+            .vertex_buffer = &vb,
+            .vertex_offset = vb.get_offset(),
+            .texture = &t,
+            .texture_uniform = _m.u_texture,
+            .index_count = static_cast<uint32_t>(index_count),
+            .set_uniforms = [shader = &s, u_colour = _m.u_colour, colour = _m.current_batch_config->font_colour] {
+                shader->set(u_colour, colour);
+            },
+        });
 
         // 5.
         _m.current_batch_config = std::nullopt;
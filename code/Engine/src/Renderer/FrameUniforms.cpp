@@ -0,0 +1,26 @@
+#include "Renderer/FrameUniforms.hpp"
+#include "Profiler/Profiler.hpp"
+
+namespace Renderer {
+    void FrameUniforms::init(ResourceManager& resource_manager) {
+        auto [camera_ub_handle, camera_ub] = resource_manager.create_and_init_resource<Core::UniformBuffer>();
+        _camera_ub = camera_ub_handle;
+    }
+
+    void FrameUniforms::stop(ResourceManager& resource_manager) {
+        resource_manager.free_resource(_camera_ub);
+    }
+
+    void FrameUniforms::set_camera(ResourceManager& resource_manager, const glm::mat4& projection, const glm::mat4& view, const glm::vec3& position) {
+        PROFILER_ZONE("Renderer::FrameUniforms::set_camera()", "rendering");
+        auto& camera_ub = resource_manager.get_resource(_camera_ub);
+
+        _camera.set<CameraMember::view>(view);
+        _camera.set<CameraMember::projection>(projection);
+        _camera.set<CameraMember::view_projection>(projection * view);
+        _camera.set<CameraMember::position>(position);
+
+        camera_ub.load(_camera);
+        camera_ub.bind_to(CAMERA_BINDING);
+    }
+}
@@ -0,0 +1,175 @@
+#include "Renderer/FrustumCuller.hpp"
+#include "Profiler/Profiler.hpp"
+
+#include <bit>
+#include <cmath>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace Renderer {
+
+    auto Frustum::from_view_projection(const glm::mat4& view_projection) noexcept -> Frustum {
+        // Gribb & Hartmann, each plane is the last row of the matrix plus or minus one of the others.
+        const auto row = [&](int r) {
+            return glm::vec4 { view_projection[0][r], view_projection[1][r], view_projection[2][r], view_projection[3][r] };
+        };
+        const glm::vec4 x = row(0), y = row(1), z = row(2), w = row(3);
+
+        Frustum frustum { .planes = { w + x, w - x, w + y, w - y, w + z, w - z } };
+        for (glm::vec4& plane : frustum.planes) {
+            plane /= glm::length(glm::vec3 { plane });
+        }
+        return frustum;
+    }
+
+    void FrustumCuller::clear() noexcept {
+        for (auto* soa : { &_center_x, &_center_y, &_center_z, &_extent_x, &_extent_y, &_extent_z }) {
+            soa->clear();
+        }
+        _visible.clear();
+    }
+
+    void FrustumCuller::reserve(size_t count) {
+        for (auto* soa : { &_center_x, &_center_y, &_center_z, &_extent_x, &_extent_y, &_extent_z }) {
+            soa->reserve(count);
+        }
+    }
+
+    auto FrustumCuller::push(const std::array<glm::vec3, 2>& aabb, const glm::mat4& transform) -> uint32_t {
+        // Arvo, the new half extent on each axis is the old ones scaled by the absolute rotation and scale.
+        const glm::vec3 center = (aabb[0] + aabb[1]) * 0.5f;
+        const glm::vec3 extent = (aabb[1] - aabb[0]) * 0.5f;
+        const glm::vec3 world_center = glm::vec3 { transform * glm::vec4 { center, 1.0f } };
+        const glm::mat3 abs_basis = { glm::abs(glm::vec3 { transform[0] }), glm::abs(glm::vec3 { transform[1] }), glm::abs(glm::vec3 { transform[2] }) };
+        const glm::vec3 world_extent = abs_basis * extent;
+        return push({ world_center - world_extent, world_center + world_extent });
+    }
+
+    auto FrustumCuller::push(const std::array<glm::vec3, 2>& world_aabb) -> uint32_t {
+        const glm::vec3 center = (world_aabb[0] + world_aabb[1]) * 0.5f;
+        const glm::vec3 extent = (world_aabb[1] - world_aabb[0]) * 0.5f;
+        _center_x.push_back(center.x);
+        _center_y.push_back(center.y);
+        _center_z.push_back(center.z);
+        _extent_x.push_back(extent.x);
+        _extent_y.push_back(extent.y);
+        _extent_z.push_back(extent.z);
+        return static_cast<uint32_t>(_center_x.size() - 1);
+    }
+
+    auto FrustumCuller::is_visible(const Frustum& frustum, const glm::vec3& center, const glm::vec3& half_extent) noexcept -> bool {
+        for (const glm::vec4& plane : frustum.planes) {
+            // The box's furthest corner along the normal is half_extent . |normal| past its centre.
+            const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+            const float radius = std::abs(plane.x) * half_extent.x + std::abs(plane.y) * half_extent.y + std::abs(plane.z) * half_extent.z;
+            if (!(distance + radius >= 0.0f)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto FrustumCuller::cull(const Frustum& frustum) -> std::span<const uint32_t> {
+        PROFILER_ZONE("FrustumCuller::cull()", "rendering");
+        const size_t n = size();
+        _visible.resize(n);
+
+        size_t num_tested = 0;
+        size_t num_visible = cull_batches(frustum, _visible.data(), num_tested);
+        for (size_t i = num_tested; i < n; ++i) {
+            const glm::vec3 center { _center_x[i], _center_y[i], _center_z[i] };
+            const glm::vec3 extent { _extent_x[i], _extent_y[i], _extent_z[i] };
+            if (is_visible(frustum, center, extent)) {
+                _visible[num_visible++] = static_cast<uint32_t>(i);
+            }
+        }
+        _visible.resize(num_visible);
+        return _visible;
+    }
+
+    auto FrustumCuller::cull_batches([[maybe_unused]] const Frustum& frustum, [[maybe_unused]] uint32_t* visible, size_t& num_tested) const noexcept -> size_t {
+#if defined(__wasm_simd128__)
+        constexpr static size_t LANES = 4;
+        using Lanes = v128_t;
+        const auto splat = [](float f) { return wasm_f32x4_splat(f); };
+        const auto load = [](const float* p) { return wasm_v128_load(p); };
+        const auto mul_add = [](Lanes a, Lanes b, Lanes c) { return wasm_f32x4_add(wasm_f32x4_mul(a, b), c); };
+        const auto is_non_negative = [](Lanes a) { return wasm_f32x4_ge(a, wasm_f32x4_splat(0.0f)); };
+        const auto both = [](Lanes a, Lanes b) { return wasm_v128_and(a, b); };
+        const auto to_mask = [](Lanes inside) { return static_cast<uint32_t>(wasm_i32x4_bitmask(inside)); };
+#elif defined(__AVX__)
+        constexpr static size_t LANES = 8;
+        using Lanes = __m256;
+        const auto splat = [](float f) { return _mm256_set1_ps(f); };
+        const auto load = [](const float* p) { return _mm256_loadu_ps(p); };
+        const auto mul_add = [](Lanes a, Lanes b, Lanes c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); };
+        const auto is_non_negative = [](Lanes a) { return _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_GE_OQ); };
+        const auto both = [](Lanes a, Lanes b) { return _mm256_and_ps(a, b); };
+        const auto to_mask = [](Lanes inside) { return static_cast<uint32_t>(_mm256_movemask_ps(inside)); };
+#elif defined(__SSE2__) || defined(_M_X64)
+        constexpr static size_t LANES = 4;
+        using Lanes = __m128;
+        const auto splat = [](float f) { return _mm_set1_ps(f); };
+        const auto load = [](const float* p) { return _mm_loadu_ps(p); };
+        const auto mul_add = [](Lanes a, Lanes b, Lanes c) { return _mm_add_ps(_mm_mul_ps(a, b), c); };
+        const auto is_non_negative = [](Lanes a) { return _mm_cmpge_ps(a, _mm_setzero_ps()); };
+        const auto both = [](Lanes a, Lanes b) { return _mm_and_ps(a, b); };
+        const auto to_mask = [](Lanes inside) { return static_cast<uint32_t>(_mm_movemask_ps(inside)); };
+#else
+        // No SIMD, cull() tests them all one at a time.
+        num_tested = 0;
+        return 0;
+#endif
+#if defined(__wasm_simd128__) || defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+        // Same test as is_visible(), a lane per box. Each batch's visible lanes come out of the mask in order.
+        size_t num_visible = 0;
+        const auto write_visible = [&](uint32_t mask, size_t first) {
+            for (; mask != 0; mask &= mask - 1) {
+                visible[num_visible++] = static_cast<uint32_t>(first + std::countr_zero(mask));
+            }
+        };
+
+        struct PlaneLanes {
+            Lanes x, y, z, w;
+            Lanes abs_x, abs_y, abs_z;
+        };
+        std::array<PlaneLanes, 6> planes;
+        for (size_t p = 0; p < planes.size(); ++p) {
+            const glm::vec4& plane = frustum.planes[p];
+            planes[p] = PlaneLanes {
+                .x = splat(plane.x),
+                .y = splat(plane.y),
+                .z = splat(plane.z),
+                .w = splat(plane.w),
+                .abs_x = splat(std::abs(plane.x)),
+                .abs_y = splat(std::abs(plane.y)),
+                .abs_z = splat(std::abs(plane.z)),
+            };
+        }
+
+        num_tested = size() / LANES * LANES;
+        for (size_t i = 0; i < num_tested; i += LANES) {
+            const Lanes cx = load(_center_x.data() + i), cy = load(_center_y.data() + i), cz = load(_center_z.data() + i);
+            const Lanes ex = load(_extent_x.data() + i), ey = load(_extent_y.data() + i), ez = load(_extent_z.data() + i);
+
+            // distance + radius from is_visible() as one chain, starting from the plane's w.
+            const auto furthest_corner_distance = [&](const PlaneLanes& plane) {
+                const Lanes radius = mul_add(plane.abs_x, ex, mul_add(plane.abs_y, ey, mul_add(plane.abs_z, ez, plane.w)));
+                return mul_add(plane.x, cx, mul_add(plane.y, cy, mul_add(plane.z, cz, radius)));
+            };
+            Lanes inside = is_non_negative(furthest_corner_distance(planes[0]));
+            for (size_t p = 1; p < planes.size(); ++p) {
+                inside = both(inside, is_non_negative(furthest_corner_distance(planes[p])));
+            }
+            write_visible(to_mask(inside), i);
+        }
+        return num_visible;
+#endif
+    }
+}
@@ -13,12 +13,11 @@ namespace Renderer {
 
         "out vec2 uv;\n"
 
-        "uniform mat4 u_view;\n"
-        "uniform mat4 u_proj;\n"
+        RENDERER_CAMERA_BLOCK_GLSL
 
         "void main() {\n"
         "    mat4 m = mat4(l_inst_col_0, l_inst_col_1, l_inst_col_2, l_inst_col_3);"
-        "    mat4 mvp = u_proj * u_view * m;\n"
+        "    mat4 mvp = u_view_proj * m;\n"
         "    gl_Position =  mvp * vec4(l_pos, 1);\n"
         "    uv = l_uv;\n"
         "}";
@@ -32,14 +31,19 @@ namespace Renderer {
         "        FragColor = texture(u_texture, uv);\n"
         "}";
 
+    // 1024 instances' transforms before it has to grow.
+    constexpr static size_t STREAMING_BYTES_PER_FRAME = 1024 * sizeof(glm::mat4);
+
     void InstanceRenderer::init(ResourceManager& resource_manager, const Model::Static& model, Media::Image& image) {
         auto [ib_handle, ib] = resource_manager.create_and_init_resource<Core::IndexBuffer>();
         auto [vb_mesh_handle, vb_mesh] = resource_manager.create_and_init_resource<Core::VertexBuffer>();
-        auto [vb_tran_handle, vb_tran] = resource_manager.create_and_init_resource<Core::VertexBuffer>();
+        auto [vb_tran_handle, vb_tran] = resource_manager.create_and_init_resource<Core::VertexBuffer>(Core::Streaming { .bytes_per_frame = STREAMING_BYTES_PER_FRAME });
         auto [va_handle, va] = resource_manager.create_and_init_resource<Core::VertexArray>(Model::Vertex::VBL {}, vb_mesh, vb_tran, ib);
         auto [s_handle, s] = resource_manager.create_and_init_resource<Core::Shader>(INSTANCE_SHADER_VERT_SRC, INSTANCE_SHADER_FRAG_SRC);
         auto [t_handle, t] = resource_manager.create_and_init_resource<Core::Texture>();
         t.upload_image(image).on_error(Renderer::Panic {});
+        s.bind_uniform_block(FrameUniforms::CAMERA_BLOCK, FrameUniforms::CAMERA_BINDING).on_error(Renderer::Panic {});
+        _u_texture = s.uniform<int32_t>("u_texture").on_error(Renderer::Panic {}).value();
 
         _s = s_handle;
         _t = t_handle;
@@ -55,33 +59,53 @@ namespace Renderer {
         ib.load_indices(model.indices);
 
         va.unbind();
+
+        _aabb = model.axis_align_bounding_box;
     }
     void InstanceRenderer::stop(ResourceManager& resource_manager) {
     }
     void InstanceRenderer::push_instance(const glm::mat4& instance_transformation) {
         _current_instances.emplace_back(instance_transformation);
     }
-    void InstanceRenderer::draw_instances(ResourceManager& resource_manager, const glm::mat4& projection, const glm::mat4& view) {
-        auto [s, t, ib, vbm, vbt, va] = resource_manager.get_resources(_s, _t, _ib, _vb_mesh, _vb_transforms, _va);
+    void InstanceRenderer::draw_instances(ResourceManager& resource_manager, RenderQueue& render_queue) {
+        if (_current_instances.empty()) {
+            return;
+        }
+        auto [s, t, ib, vbt, va] = resource_manager.get_resources(_s, _t, _ib, _vb_transforms, _va);
 
         auto transfrom_verts = std::span {
             reinterpret_cast<const float*>(_current_instances.data()),
             _current_instances.size() * 16
         };
-        va.bind();
-        ib.bind();
         vbt.bind();
         vbt.load_vertices(transfrom_verts);
-        vbm.bind();
-        s.bind();
-        s.set_uniform("u_view", view).on_error(Panic{});
-        s.set_uniform("u_proj", projection).on_error(Panic{});
 
-        int32_t t_id = static_cast<int32_t>(t.bind().on_error(Panic {}).value());
-        s.set_uniform("u_texture", t_id);
-        glDrawElementsInstanced(GL_TRIANGLES, ib.get_count(), GL_UNSIGNED_INT, 0, _current_instances.size());
-        va.unbind();
+        render_queue.push(RenderQueue::DrawPacket {
+            .depth = render_queue.nearest_depth(_current_instances),
+            .shader = &s,
+            .vertex_array = &va,
+            .vertex_buffer = &vbt,
+            .vertex_offset = vbt.get_offset(),
+            .texture = &t,
+            .texture_uniform = _u_texture,
+            .index_count = static_cast<uint32_t>(ib.get_count()),
+            .instance_count = static_cast<uint32_t>(_current_instances.size()),
+        });
         _current_instances.clear();
     }
+    void InstanceRenderer::draw_instances(ResourceManager& resource_manager, RenderQueue& render_queue, const Frustum& frustum) {
+        _culler.clear();
+        _culler.reserve(_current_instances.size());
+        for (const glm::mat4& instance : _current_instances) {
+            _culler.push(_aabb, instance);
+        }
+        // Ascending, so each visible instance only ever moves back.
+        const auto visible = _culler.cull(frustum);
+        for (size_t i = 0; i < visible.size(); ++i) {
+            _current_instances[i] = _current_instances[visible[i]];
+        }
+        _current_instances.resize(visible.size());
+        draw_instances(resource_manager, render_queue);
+    }
 
 }
\ No newline at end of file
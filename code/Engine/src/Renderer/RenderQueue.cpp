@@ -0,0 +1,180 @@
+#include "Renderer/RenderQueue.hpp"
+
+#include "Config.hpp"
+#include "Core/GlState.hpp"
+#include "Profiler/EngineCounters.hpp"
+#include "Profiler/GpuProfiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <limits>
+#include <utility>
+
+namespace Renderer {
+
+    auto RenderQueue::make_key(const DrawPacket& packet) noexcept -> uint64_t {
+        // Positive floats order the same as their bits, the sign bit is always 0 so it's dropped.
+        const float depth = packet.depth > 0 ? packet.depth : 0.0f;
+        const uint64_t depth_bits = std::bit_cast<uint32_t>(depth) & 0x7FFF'FFFF;
+        const uint64_t shader = static_cast<uint64_t>(packet.shader ? packet.shader->get_id().value_or(0) : 0) & 0xFFF;
+        const uint64_t texture = static_cast<uint64_t>(packet.texture ? packet.texture->get_id().value_or(0) : 0) & 0xFFFF;
+
+        uint64_t key = static_cast<uint64_t>(packet.pass) << 60;
+        if (!packet.is_translucent) {
+            return key | shader << 47 | texture << 31 | depth_bits;
+        }
+        key |= uint64_t { 1 } << 59;
+        return key | (~depth_bits & 0x7FFF'FFFF) << 28 | shader << 16 | texture;
+    }
+
+    void RenderQueue::radix_sort(std::vector<SortItem>& items, std::vector<SortItem>& scratch) noexcept {
+        constexpr static size_t NUM_DIGITS = sizeof(uint64_t);
+
+        // All 8 histograms in one pass over the keys.
+        std::array<std::array<uint32_t, 256>, NUM_DIGITS> counts {};
+        for (const SortItem& item : items) {
+            for (size_t d = 0; d < NUM_DIGITS; ++d) {
+                ++counts[d][(item.key >> (d * 8)) & 0xFF];
+            }
+        }
+
+        scratch.resize(items.size());
+        for (size_t d = 0; d < NUM_DIGITS; ++d) {
+            auto& count = counts[d];
+            // Every key has the same byte here, so this pass wouldn't move anything. Most of them in practice.
+            if (std::ranges::find(count, static_cast<uint32_t>(items.size())) != count.end()) {
+                continue;
+            }
+            uint32_t offset = 0;
+            for (uint32_t& c : count) {
+                offset += std::exchange(c, offset);
+            }
+            for (const SortItem& item : items) {
+                scratch[count[(item.key >> (d * 8)) & 0xFF]++] = item;
+            }
+            items.swap(scratch);
+        }
+    }
+
+    auto RenderQueue::nearest_depth(std::span<const glm::mat4> transforms) const noexcept -> float {
+        if (transforms.empty()) {
+            return 0.0f;
+        }
+        // Only view space z is needed, and the camera looks down -z.
+        const glm::vec4 row_z { _view[0][2], _view[1][2], _view[2][2], _view[3][2] };
+        float nearest = std::numeric_limits<float>::max();
+        for (const glm::mat4& transform : transforms) {
+            nearest = std::min(nearest, -glm::dot(row_z, transform[3]));
+        }
+        return nearest;
+    }
+
+    void RenderQueue::push(DrawPacket&& packet) {
+        assert(packet.shader && packet.vertex_array);
+        _items.push_back(SortItem {
+            .key = make_key(packet),
+            .index = static_cast<uint32_t>(_packets.size()),
+        });
+        _packets.push_back(std::move(packet));
+    }
+
+    auto RenderQueue::allocate_bytes(size_t size, size_t alignment) -> std::byte* {
+        while (true) {
+            if (_arena_block == _arena.size()) {
+                const size_t block_size = std::max(ARENA_BLOCK_SIZE, size + alignment);
+                _arena.push_back(ArenaBlock { .data = std::make_unique<std::byte[]>(block_size), .size = block_size });
+            }
+            ArenaBlock& block = _arena[_arena_block];
+            const auto base = reinterpret_cast<uintptr_t>(block.data.get());
+            const size_t offset = (base + _arena_used + alignment - 1) / alignment * alignment - base;
+            if (offset + size <= block.size) {
+                _arena_used = offset + size;
+                return block.data.get() + offset;
+            }
+            ++_arena_block;
+            _arena_used = 0;
+        }
+    }
+
+    auto RenderQueue::can_merge(const DrawPacket& last, const DrawPacket& next) noexcept -> bool {
+        return !last.set_uniforms && !next.set_uniforms
+            && !last.draw && !next.draw
+            && last.instance_count == 1 && next.instance_count == 1
+            && last.shader == next.shader
+            && last.vertex_array == next.vertex_array
+            && last.vertex_buffer == next.vertex_buffer
+            && last.vertex_offset == next.vertex_offset
+            && last.texture == next.texture
+            && last.is_depth_tested == next.is_depth_tested
+            && last.index_offset + last.index_count * sizeof(uint32_t) == next.index_offset;
+    }
+
+    void RenderQueue::draw(const DrawPacket& packet, uint32_t index_count) noexcept {
+        const auto* indices = reinterpret_cast<const void*>(packet.index_offset);
+        if (packet.instance_count == 1) {
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(index_count), GL_UNSIGNED_INT, indices);
+        } else {
+            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(index_count), GL_UNSIGNED_INT, indices, static_cast<GLsizei>(packet.instance_count));
+        }
+    }
+
+    auto RenderQueue::sort() noexcept -> std::span<const SortItem> {
+        radix_sort(_items, _scratch);
+        return _items;
+    }
+
+    void RenderQueue::submit() {
+        if (_packets.empty()) {
+            _stats = Stats { .num_packets = 0, .num_draws = 0 };
+            return;
+        }
+        PROFILER_ZONE("RenderQueue::submit()", "rendering");
+        PROFILER_GPU_ZONE("RenderQueue::submit() (GPU)", "rendering");
+
+        sort();
+
+        // Binding what's already bound is only a compare in GlState, so everything is set for every draw.
+        auto& gl_state = Core::GlState::instance();
+        size_t num_draws = 0;
+        for (size_t i = 0; i < _items.size();) {
+            DrawPacket& packet = _packets[_items[i].index];
+
+            uint32_t index_count = packet.index_count;
+            const DrawPacket* last = &packet;
+            for (++i; i < _items.size() && can_merge(*last, _packets[_items[i].index]); ++i) {
+                last = &_packets[_items[i].index];
+                index_count += last->index_count;
+            }
+
+            packet.shader->bind();
+            packet.vertex_array->bind();
+            if (packet.vertex_buffer) {
+                packet.vertex_array->rebase(*packet.vertex_buffer, packet.vertex_offset);
+            }
+            gl_state.set_enabled(GL_DEPTH_TEST, packet.is_depth_tested);
+            if (packet.texture) {
+                const auto unit = packet.texture->bind().on_error(Utily::ErrorHandler::print_then_quit).value();
+                packet.shader->set(packet.texture_uniform, static_cast<int32_t>(unit));
+            }
+            if (packet.set_uniforms) {
+                packet.set_uniforms();
+            }
+            if (packet.draw) {
+                packet.draw();
+            } else {
+                draw(packet, index_count);
+                EngineCounters::draw_calls().add(1);
+            }
+            ++num_draws;
+        }
+        gl_state.set_enabled(GL_DEPTH_TEST, true);
+
+        _stats = Stats { .num_packets = _packets.size(), .num_draws = num_draws };
+        _packets.clear();
+        _items.clear();
+        _arena_block = 0;
+        _arena_used = 0;
+    }
+}
@@ -0,0 +1,172 @@
+#include "Renderer/ResidentBatchDrawer.hpp"
+#include "Profiler/EngineCounters.hpp"
+#include "Profiler/Profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace Renderer {
+
+    void ResidentBatchDrawer::init(ResourceManager& resource_manager) {
+        auto [vb_handle, vb] = resource_manager.create_and_init_resource<Core::VertexBuffer>();
+        auto [ib_handle, ib] = resource_manager.create_and_init_resource<Core::IndexBuffer>();
+        auto [va_handle, va] = resource_manager.create_and_init_resource<Core::VertexArray>(Model::Vertex::VBL {}, vb, ib);
+        va.unbind();
+
+        _vb = vb_handle;
+        _ib = ib_handle;
+        _va = va_handle;
+
+        _transforms.init().on_error(Renderer::Panic {});
+    }
+
+    void ResidentBatchDrawer::stop(ResourceManager& resource_manager) {
+        resource_manager.free_resources(_va, _vb, _ib);
+        _transforms.stop();
+        _uniforms_shader = nullptr;
+        _vertices.clear();
+        _indices.clear();
+        _meshes.clear();
+        _has_new_meshes = false;
+    }
+
+    auto ResidentBatchDrawer::add_mesh(const Model::Static& model) -> MeshHandle {
+        _meshes.push_back(Mesh {
+            .index_count = static_cast<uint32_t>(model.indices.size()),
+            .first_index = _indices.size(),
+            .base_vertex = static_cast<int32_t>(_vertices.size()),
+        });
+        _vertices.insert(_vertices.end(), model.vertices.begin(), model.vertices.end());
+        _indices.insert(_indices.end(), model.indices.begin(), model.indices.end());
+        _has_new_meshes = true;
+        return MeshHandle { .index = static_cast<uint32_t>(_meshes.size() - 1) };
+    }
+
+    void ResidentBatchDrawer::draw(ResourceManager& resource_manager, RenderQueue& render_queue, Core::Shader& shader, std::span<const Draw> draws) {
+        PROFILER_ZONE("ResidentBatchDrawer::draw()", "rendering");
+        if (draws.empty()) {
+            return;
+        }
+        auto [vb, ib, va] = resource_manager.get_resources(_vb, _ib, _va);
+
+        if (_has_new_meshes) {
+            va.bind();
+            vb.bind();
+            vb.load_vertices(_vertices);
+            ib.bind();
+            ib.load_indices(_indices);
+            _has_new_meshes = false;
+        }
+
+        // Only the per draw data, the meshes are already there.
+        const size_t n = draws.size();
+        auto draw_data = render_queue.allocate<glm::mat4>(n + (n + TEXTURE_UNITS_PER_MATRIX - 1) / TEXTURE_UNITS_PER_MATRIX);
+        auto textures = render_queue.allocate<Core::Texture*>(n);
+        auto index_counts = render_queue.allocate<int32_t>(n);
+        auto index_offsets = render_queue.allocate<const void*>(n);
+        auto base_vertices = render_queue.allocate<int32_t>(n);
+        const auto transforms = draw_data.first(n);
+        const auto texture_units = draw_data.subspan(n);
+        std::ranges::fill(texture_units, glm::mat4 { 0.0f });
+        for (size_t i = 0; i < n; ++i) {
+            const Draw& draw = draws[i];
+            assert(draw.mesh.index < _meshes.size() && "A MeshHandle from another ResidentBatchDrawer or a default one.");
+            const Mesh& mesh = _meshes[draw.mesh.index];
+            transforms[i] = draw.transform;
+            textures[i] = draw.texture;
+            if (draw.texture) {
+                const auto unit = draw.texture->bind(true).on_error(Utily::ErrorHandler::print_then_quit).value();
+                texture_units[i / TEXTURE_UNITS_PER_MATRIX][(i % TEXTURE_UNITS_PER_MATRIX) / 4][i % 4] = static_cast<float>(unit);
+            }
+            index_counts[i] = static_cast<int32_t>(mesh.index_count);
+            index_offsets[i] = reinterpret_cast<const void*>(mesh.first_index * sizeof(Model::Index));
+            base_vertices[i] = mesh.base_vertex;
+        }
+
+        const Batch& batch = *std::construct_at(render_queue.allocate<Batch>(1).data(), Batch {
+            .shader = &shader,
+            .vertex_array = &va,
+            .vertex_buffer = &vb,
+            .transform_texture = &_transforms,
+            .uniforms = uniforms(shader),
+            .draw_data = draw_data,
+            .textures = textures,
+            .index_counts = index_counts,
+            .index_offsets = index_offsets,
+            .base_vertices = base_vertices,
+        });
+
+        render_queue.push(RenderQueue::DrawPacket {
+            .depth = render_queue.nearest_depth(transforms),
+            .shader = &shader,
+            .vertex_array = &va,
+            .draw = [batch = &batch] { draw_batch(*batch); },
+        });
+    }
+
+    auto ResidentBatchDrawer::uniforms(Core::Shader& shader) -> const Uniforms& {
+        if (_uniforms_shader != &shader || _uniforms_program != shader.get_id()) {
+            auto u_num_draws = shader.uniform<int32_t>(NUM_DRAWS_UNIFORM);
+            auto u_draw_index = shader.uniform<int32_t>(DRAW_INDEX_UNIFORM);
+            _uniforms = Uniforms {
+                .model_transforms = shader.uniform<int32_t>(MODEL_TRANSFORMS_UNIFORM).on_error(Utily::ErrorHandler::print_then_quit).value(),
+                .num_draws = u_num_draws.has_value() ? std::optional { u_num_draws.value() } : std::nullopt,
+                .draw_index = u_draw_index.has_value() ? std::optional { u_draw_index.value() } : std::nullopt,
+            };
+            _uniforms_shader = &shader;
+            _uniforms_program = shader.get_id();
+        }
+        return _uniforms;
+    }
+
+    void ResidentBatchDrawer::draw_batch(const Batch& batch) {
+        Core::Shader& shader = *batch.shader;
+        const size_t n = batch.textures.size();
+
+        // One texture upload and one sampler uniform however many draws there are.
+        batch.transform_texture->load(batch.draw_data);
+        const auto unit = batch.transform_texture->bind().on_error(Utily::ErrorHandler::print_then_quit).value();
+        shader.set(batch.uniforms.model_transforms, static_cast<int32_t>(unit));
+        if (batch.uniforms.num_draws) {
+            shader.set(*batch.uniforms.num_draws, static_cast<int32_t>(n));
+        }
+
+        int64_t num_draw_calls = 0;
+#if defined(CONFIG_TARGET_NATIVE)
+        if (!batch.uniforms.draw_index) {
+            // BATCH_DRAW_INDEX is gl_DrawIDARB, or the shader doesn't use it.
+            glMultiDrawElementsBaseVertex(
+                GL_TRIANGLES,
+                batch.index_counts.data(),
+                GL_UNSIGNED_INT,
+                batch.index_offsets.data(),
+                static_cast<GLsizei>(n),
+                batch.base_vertices.data());
+            num_draw_calls = 1;
+        }
+#endif
+        if (num_draw_calls == 0) {
+            for (size_t d = 0; d < n; ++d) {
+                if (batch.uniforms.draw_index) {
+                    shader.set(*batch.uniforms.draw_index, static_cast<int32_t>(d));
+                }
+#if defined(CONFIG_TARGET_NATIVE)
+                glDrawElementsBaseVertex(GL_TRIANGLES, batch.index_counts[d], GL_UNSIGNED_INT, batch.index_offsets[d], batch.base_vertices[d]);
+#else
+                batch.vertex_array->rebase(*batch.vertex_buffer, static_cast<size_t>(batch.base_vertices[d]) * sizeof(Model::Vertex));
+                glDrawElements(GL_TRIANGLES, batch.index_counts[d], GL_UNSIGNED_INT, batch.index_offsets[d]);
+#endif
+            }
+            num_draw_calls = static_cast<int64_t>(n);
+        }
+        EngineCounters::draw_calls().add(num_draw_calls);
+
+        // the units are set now, so they can be handed out again.
+        for (Core::Texture* texture : batch.textures) {
+            if (texture) {
+                texture->unlock();
+            }
+        }
+    }
+}
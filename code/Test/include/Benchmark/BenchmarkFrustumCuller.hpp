@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Benchmark/BenchmarkParallelFor.hpp"
+#include "Renderer/FrustumCuller.hpp"
+#include "TestPch.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+TEST(Benchmark, FrustumCuller_cull_vs_per_box) {
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3 { 0, 0, 0 }, glm::vec3 { 0, 0, -1 }, glm::vec3 { 0, 1, 0 });
+    const auto frustum = Renderer::Frustum::from_view_projection(projection * view);
+
+    for (size_t num_boxes : { 100'000, 1'000'000 }) {
+        // Spread all around the camera, so most are off screen.
+        std::mt19937 rng { 1 };
+        std::uniform_real_distribution<float> position { -1000.0f, 1000.0f };
+        std::uniform_real_distribution<float> size { 0.1f, 4.0f };
+        std::vector<glm::vec3> centers(num_boxes), extents(num_boxes);
+        for (size_t i = 0; i < num_boxes; ++i) {
+            centers[i] = { position(rng), position(rng), position(rng) };
+            extents[i] = { size(rng), size(rng), size(rng) };
+        }
+
+        Renderer::FrustumCuller culler;
+        culler.reserve(num_boxes);
+        auto push_time = Benchmark::time_it([&] {
+            for (size_t i = 0; i < num_boxes; ++i) {
+                culler.push({ centers[i] - extents[i], centers[i] + extents[i] });
+            }
+        });
+
+        std::vector<uint32_t> per_box_visible;
+        per_box_visible.reserve(num_boxes);
+        auto per_box_time = Benchmark::time_it([&] {
+            for (size_t i = 0; i < num_boxes; ++i) {
+                if (Renderer::FrustumCuller::is_visible(frustum, centers[i], extents[i])) {
+                    per_box_visible.push_back(static_cast<uint32_t>(i));
+                }
+            }
+        });
+
+        std::span<const uint32_t> visible;
+        auto cull_time = Benchmark::time_it([&] {
+            visible = culler.cull(frustum);
+        });
+
+        EXPECT_TRUE(std::ranges::equal(visible, per_box_visible));
+        std::cout << "[ BENCHMARK ] " << num_boxes << " boxes, " << visible.size() << " visible: "
+                  << "push " << push_time.count() << "us, "
+                  << "per box " << per_box_time.count() << "us, "
+                  << "cull " << cull_time.count() << "us\n";
+    }
+}
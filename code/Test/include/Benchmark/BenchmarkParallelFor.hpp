@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Core/Scheduler.hpp"
+#include "EntityComponents/EntityComponents.hpp"
+#include "Model/Types.hpp"
+#include "TestPch.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace Benchmark {
+    template <typename Fn>
+    auto time_it(Fn&& fn) -> std::chrono::microseconds {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    inline auto to_batching_vertex(const Model::Vertex& v) -> Model::BatchingVertex {
+        return Model::BatchingVertex { v.position, v.normal, v.uv_coord, 3, 7 };
+    }
+}
+
+TEST(Benchmark, ParallelFor_vertex_copy_vs_serial) {
+    const size_t num_threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    auto scheduler = std::move(Core::Scheduler::create(num_threads).value());
+
+    for (size_t num_vertices : { 10'000, 100'000, 1'000'000 }) {
+        std::vector<Model::Vertex> input(num_vertices);
+        for (size_t i = 0; i < num_vertices; ++i) {
+            const auto f = static_cast<float>(i);
+            input[i] = Model::Vertex { .position = { f, f, f }, .normal = { 0, 1, 0 }, .uv_coord = { f, -f } };
+        }
+        std::vector<Model::BatchingVertex> serial_output(num_vertices);
+        std::vector<Model::BatchingVertex> parallel_output(num_vertices);
+
+        auto serial_time = Benchmark::time_it([&] {
+            std::ranges::transform(input, serial_output.begin(), Benchmark::to_batching_vertex);
+        });
+        auto parallel_time = Benchmark::time_it([&] {
+            scheduler.parallel_transform(input, parallel_output, 4096, Benchmark::to_batching_vertex);
+        });
+
+        for (size_t i = 0; i < num_vertices; i += num_vertices / 100) {
+            EXPECT_EQ(serial_output[i].position, parallel_output[i].position);
+            EXPECT_EQ(serial_output[i].model_transform_index, parallel_output[i].model_transform_index);
+        }
+        std::cout << "[ BENCHMARK ] " << num_vertices << " vertex copies: "
+                  << "serial " << serial_time.count() << "us, "
+                  << "parallel_for " << parallel_time.count() << "us\n";
+    }
+}
+
+TEST(Benchmark, ParallelFor_transform_building_vs_serial) {
+    const size_t num_threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    auto scheduler = std::move(Core::Scheduler::create(num_threads).value());
+
+    auto to_mat = [](Components::Transform& transform) { return transform.calc_transform_mat(); };
+
+    for (size_t num_transforms : { 10'000, 100'000, 1'000'000 }) {
+        std::vector<Components::Transform> transforms(num_transforms);
+        for (size_t i = 0; i < num_transforms; ++i) {
+            transforms[i].position = glm::vec3(static_cast<float>(i), 0, 0);
+        }
+        std::vector<glm::mat4> serial_output(num_transforms);
+        std::vector<glm::mat4> parallel_output(num_transforms);
+
+        auto serial_time = Benchmark::time_it([&] {
+            std::ranges::transform(transforms, serial_output.begin(), to_mat);
+        });
+        auto parallel_time = Benchmark::time_it([&] {
+            scheduler.parallel_transform(transforms, parallel_output, 256, to_mat);
+        });
+
+        for (size_t i = 0; i < num_transforms; i += num_transforms / 100) {
+            EXPECT_EQ(serial_output[i], parallel_output[i]);
+        }
+        std::cout << "[ BENCHMARK ] " << num_transforms << " transforms: "
+                  << "serial " << serial_time.count() << "us, "
+                  << "parallel_for " << parallel_time.count() << "us\n";
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Profiler/Profiler.hpp"
+#include "TestPch.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Benchmark {
+    // The profiler before per-thread buffers. Every zone builds a std::string and a vector of categories, then
+    // takes a global mutex to push into a map of vectors.
+    class LegacyProfiler
+    {
+    public:
+        class Timer
+        {
+        public:
+            Timer(std::string function_name, std::vector<std::string_view> cats = {})
+                : name(std::move(function_name))
+                , start_time(std::chrono::steady_clock::now())
+                , end_time(start_time)
+                , thread_id(std::this_thread::get_id())
+                , categories(std::move(cats)) { }
+            ~Timer() {
+                end_time = std::chrono::steady_clock::now();
+                LegacyProfiler::instance().submit_timer(*this);
+            }
+
+            std::string name;
+            std::chrono::steady_clock::time_point start_time;
+            std::chrono::steady_clock::time_point end_time;
+            std::thread::id thread_id;
+            std::vector<std::string_view> categories;
+        };
+
+        static auto instance() -> LegacyProfiler& {
+            static LegacyProfiler profiler {};
+            return profiler;
+        }
+
+        void submit_timer(const Timer& timer) {
+            std::scoped_lock lock(_mutex);
+            _recordings[_current_process].emplace_back(timer.name, timer.start_time, timer.end_time, timer.thread_id, timer.categories);
+        }
+
+        void clear() {
+            std::scoped_lock lock(_mutex);
+            _recordings.clear();
+        }
+
+    private:
+        struct Recording {
+            std::string name;
+            std::chrono::steady_clock::time_point start_time;
+            std::chrono::steady_clock::time_point end_time;
+            std::thread::id thread_id;
+            std::vector<std::string_view> categories;
+        };
+        std::mutex _mutex;
+        std::string_view _current_process = "default";
+        std::unordered_map<std::string_view, std::vector<Recording>> _recordings;
+    };
+
+    template <typename ZoneFn>
+    auto time_zones_per_thread(size_t num_threads, size_t zones_per_thread, ZoneFn zone_fn) -> double {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&]() {
+                for (size_t i = 0; i < zones_per_thread; ++i) {
+                    zone_fn();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const auto total = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+        return total.count() / static_cast<double>(num_threads * zones_per_thread);
+    }
+}
+
+TEST(Benchmark, Profiler_cost_per_zone) {
+    constexpr size_t ZONES_PER_THREAD = 100'000;
+
+    for (size_t num_threads : { 1, 4 }) {
+        const double legacy_ns = Benchmark::time_zones_per_thread(num_threads, ZONES_PER_THREAD, []() {
+            Benchmark::LegacyProfiler::Timer timer("Benchmark::zone()", { "benchmark" });
+        });
+        Benchmark::LegacyProfiler::instance().clear();
+
+        const double zone_ns = Benchmark::time_zones_per_thread(num_threads, ZONES_PER_THREAD, []() {
+            PROFILER_ZONE("Benchmark::zone()", "benchmark");
+        });
+
+        Profiler::instance().set_category_enabled("benchmark", false);
+        const double disabled_zone_ns = Benchmark::time_zones_per_thread(num_threads, ZONES_PER_THREAD, []() {
+            PROFILER_ZONE("Benchmark::zone()", "benchmark");
+        });
+        Profiler::instance().set_category_enabled("benchmark", true);
+
+        std::cout << "[ BENCHMARK ] " << num_threads << " thread(s), cost per zone: "
+                  << "string + mutex " << legacy_ns << "ns, "
+                  << "interned + per-thread buffer " << zone_ns << "ns, "
+                  << "disabled " << disabled_zone_ns << "ns\n";
+    }
+}
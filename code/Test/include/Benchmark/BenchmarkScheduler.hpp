@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Benchmark/BenchmarkProfiler.hpp"
+#include "Core/Scheduler.hpp"
+#include "TestPch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace Benchmark {
+    // The scheduler before work-stealing. Every thread fetch_adds the same atomic index to claim the next task.
+    class FlatCounterScheduler
+    {
+    public:
+        using Task = std::variant<void (*)(), std::function<void()>>;
+
+        explicit FlatCounterScheduler(size_t num_threads)
+            : _num_threads(num_threads) { }
+
+        void add_task(Task task) { _tasks.emplace_back(std::move(task)); }
+
+        void launch_threads() {
+            _current_task.store(0);
+            auto execute = [this]() {
+                for (;;) {
+                    auto task_id = _current_task.fetch_add(1, std::memory_order_seq_cst);
+                    if (task_id >= _tasks.size()) {
+                        return;
+                    }
+                    std::string timer_name = "Scheduler::Task(" + std::to_string(task_id) + ")";
+                    LegacyProfiler::Timer timer(timer_name);
+                    std::visit([](auto& task) { task(); }, _tasks.at(task_id));
+                }
+            };
+            for (size_t i = 0; i < _num_threads; ++i) {
+                _threads.emplace_back(execute);
+            }
+        }
+
+        void wait_for_threads() {
+            for (;;) {
+                auto task_id = _current_task.fetch_add(1, std::memory_order_seq_cst);
+                if (task_id >= _tasks.size()) {
+                    break;
+                }
+                std::visit([](auto& task) { task(); }, _tasks.at(task_id));
+            }
+            for (auto& thread : _threads) {
+                thread.join();
+            }
+            _threads.clear();
+            _tasks.clear();
+        }
+
+    private:
+        std::vector<Task> _tasks;
+        std::vector<std::thread> _threads;
+        std::atomic<size_t> _current_task;
+        size_t _num_threads;
+    };
+
+    // Tiny and uneven, like most of the per-frame jobs.
+    inline auto micro_work(size_t i) -> float {
+        float result = 0;
+        for (size_t j = 0; j < (i % 7) * 16 + 8; ++j) {
+            result += std::sqrt(static_cast<float>(i + j));
+        }
+        return result;
+    }
+
+    template <typename SchedulerType>
+    auto time_micro_tasks(SchedulerType& scheduler, std::vector<float>& results) -> std::chrono::microseconds {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < results.size(); ++i) {
+            scheduler.add_task([&results, i]() { results[i] = micro_work(i); });
+        }
+        scheduler.launch_threads();
+        scheduler.wait_for_threads();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    }
+}
+
+TEST(Benchmark, Scheduler_work_stealing_vs_flat_counter) {
+    const size_t num_threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    for (size_t num_tasks : { 1'000, 10'000, 100'000 }) {
+        std::vector<float> results(num_tasks, 0.0f);
+
+        Benchmark::FlatCounterScheduler flat { num_threads };
+        auto flat_time = Benchmark::time_micro_tasks(flat, results);
+
+        std::ranges::fill(results, 0.0f);
+        auto work_stealing = std::move(Core::Scheduler::create(num_threads).value());
+        auto work_stealing_time = Benchmark::time_micro_tasks(work_stealing, results);
+
+        for (size_t i = 0; i < num_tasks; i += num_tasks / 100) {
+            EXPECT_EQ(results[i], Benchmark::micro_work(i));
+        }
+
+        std::cout << "[ BENCHMARK ] " << num_tasks << " micro-tasks: "
+                  << "flat counter " << flat_time.count() << "us, "
+                  << "work stealing " << work_stealing_time.count() << "us\n";
+    }
+}
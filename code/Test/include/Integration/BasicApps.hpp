@@ -311,6 +311,7 @@ struct FontLogic {
 
         Renderer::FontBatchRenderer::BatchConfig batch_config = {
             .resource_manager = data.resource_manager,
+            .render_queue = renderer.render_queue,
             .screen_dimensions = { renderer.window_width, renderer.window_height },
             .font_colour = { 0, 0, 0, 1 }
         };
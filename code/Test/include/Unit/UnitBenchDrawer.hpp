@@ -4,22 +4,54 @@
 #include "TestPch.hpp"
 
 #include <App/App.hpp>
-#include <iostream>
-#include <string>
 
-using namespace std::literals;
+TEST(Unit, Core_transform_texture_texels) {
+    using Core::TransformTexture;
 
-TEST(Unit, Renderer_batch_drawer_to_3_digits) {
+    static_assert(TransformTexture::WIDTH == TransformTexture::MATRICES_PER_ROW * 4);
 
-    for (uint32_t i = 0; i <= 999; ++i) {
-        auto result = Renderer::BatchDrawer::to_3_digit(i);
-        auto expected = std::to_string(i);
-        while (expected.size() < 3) {
-            expected = '0' + expected;
-        }
-
-        EXPECT_EQ(result[0], expected[0]);
-        EXPECT_EQ(result[1], expected[1]);
-        EXPECT_EQ(result[2], expected[2]);
+    // A matrix's four texels never cross a row, and no two matrices share one.
+    for (uint32_t i = 0; i < 100'000; ++i) {
+        const auto [x, y] = TransformTexture::texel(i);
+        EXPECT_EQ(x % 4, 0);
+        EXPECT_LE(x + 4, TransformTexture::WIDTH);
+        EXPECT_EQ(static_cast<uint32_t>(y) * TransformTexture::MATRICES_PER_ROW + static_cast<uint32_t>(x / 4), i);
     }
+    EXPECT_EQ(TransformTexture::texel(255), (std::array<int32_t, 2> { 1020, 0 }));
+    EXPECT_EQ(TransformTexture::texel(256), (std::array<int32_t, 2> { 0, 1 }));
+    EXPECT_EQ(TransformTexture::texel(99'999), (std::array<int32_t, 2> { (99'999 % 256) * 4, 99'999 / 256 }));
+}
+
+TEST(Unit, BatchDrawer_batch_overloads_instantiate) {
+    using Renderer::BatchDrawer;
+    using Renderer::RenderQueue;
+    constexpr size_t N = 2;
+    using Models = std::array<BatchDrawer::TexturedStaticModel, N>;
+
+    // Taking their addresses instantiates all four, GL or not.
+    void (BatchDrawer::*plain)(RenderQueue&, Core::VertexBuffer&, Core::IndexBuffer&, Core::VertexArray&, Core::Shader&, Models&) = &BatchDrawer::batch<N>;
+    void (BatchDrawer::*culled)(RenderQueue&, const Renderer::Frustum&, Core::VertexBuffer&, Core::IndexBuffer&, Core::VertexArray&, Core::Shader&, Models&) = &BatchDrawer::batch<N>;
+    void (BatchDrawer::*parallel)(RenderQueue&, Core::Scheduler&, Core::VertexBuffer&, Core::IndexBuffer&, Core::VertexArray&, Core::Shader&, Models&) = &BatchDrawer::batch<N>;
+    void (BatchDrawer::*parallel_culled)(RenderQueue&, Core::Scheduler&, const Renderer::Frustum&, Core::VertexBuffer&, Core::IndexBuffer&, Core::VertexArray&, Core::Shader&, Models&) = &BatchDrawer::batch<N>;
+    EXPECT_NE(plain, nullptr);
+    EXPECT_NE(parallel, nullptr);
+
+    // With everything culled nothing touches GL, so the culled ones can run here.
+    Model::Static model;
+    model.axis_align_bounding_box = { glm::vec3 { -0.5f, -0.5f, -0.5f }, glm::vec3 { 0.5f, 0.5f, 0.5f } };
+    Components::Transform left { .position = { -10, 0, 0 } }, right { .position = { 10, 0, 0 } };
+    Core::Texture texture;
+    Models models = { std::tie(model, left, texture), std::tie(model, right, texture) };
+    const auto frustum = Renderer::Frustum::from_view_projection(glm::mat4 { 1.0f });
+
+    BatchDrawer drawer;
+    RenderQueue render_queue;
+    Core::VertexBuffer vb;
+    Core::IndexBuffer ib;
+    Core::VertexArray va;
+    Core::Shader shader;
+    auto scheduler = std::move(Core::Scheduler::create(2).value());
+    (drawer.*culled)(render_queue, frustum, vb, ib, va, shader, models);
+    (drawer.*parallel_culled)(render_queue, scheduler, frustum, vb, ib, va, shader, models);
+    EXPECT_TRUE(render_queue.sort().empty());
 }
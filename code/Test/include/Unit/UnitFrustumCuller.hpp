@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Renderer/FrustumCuller.hpp"
+#include "TestPch.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace UnitFrustumCuller {
+    // At the origin looking down -z, as from Cameras::StationaryPerspective.
+    inline auto frustum() -> Renderer::Frustum {
+        const glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3 { 0, 0, 0 }, glm::vec3 { 0, 0, -1 }, glm::vec3 { 0, 1, 0 });
+        return Renderer::Frustum::from_view_projection(projection * view);
+    }
+
+    inline auto unit_box_at(glm::vec3 center) -> std::array<glm::vec3, 2> {
+        return { center - glm::vec3 { 1, 1, 1 }, center + glm::vec3 { 1, 1, 1 } };
+    }
+}
+
+TEST(Unit, FrustumCuller_keeps_boxes_inside_or_crossing_the_planes) {
+    using namespace UnitFrustumCuller;
+
+    Renderer::FrustumCuller culler;
+    const uint32_t in_front = culler.push(unit_box_at({ 0, 0, -10 }));
+    culler.push(unit_box_at({ 0, 0, 10 })); // behind
+    culler.push(unit_box_at({ 0, 0, -200 })); // past the far plane
+    culler.push(unit_box_at({ -50, 0, -10 })); // left
+    culler.push(unit_box_at({ 0, 30, -10 })); // above
+    const uint32_t crossing_near = culler.push(unit_box_at({ 0, 0, 0 }));
+    const uint32_t crossing_right = culler.push(unit_box_at({ 10.5f, 0, -10 }));
+    const uint32_t crossing_far = culler.push(unit_box_at({ 0, 0, -100.5f }));
+
+    const auto visible = culler.cull(frustum());
+    EXPECT_EQ(std::vector(visible.begin(), visible.end()), (std::vector { in_front, crossing_near, crossing_right, crossing_far }));
+}
+
+TEST(Unit, FrustumCuller_moves_model_space_boxes) {
+    using namespace UnitFrustumCuller;
+
+    const auto box = unit_box_at({ 0, 0, 0 });
+    Renderer::FrustumCuller culler;
+    culler.push(box, glm::translate(glm::mat4(1.0f), glm::vec3 { 0, 0, 10 }));
+    const uint32_t moved_in_front = culler.push(box, glm::translate(glm::mat4(1.0f), glm::vec3 { 0, 0, -10 }));
+    // 20 either side once scaled, so it reaches from behind the camera to in front of it.
+    const uint32_t scaled = culler.push(box, glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3 { 0, 0, 15 }), glm::vec3 { 20, 20, 20 }));
+
+    const auto visible = culler.cull(frustum());
+    EXPECT_EQ(std::vector(visible.begin(), visible.end()), (std::vector { moved_in_front, scaled }));
+}
+
+TEST(Unit, FrustumCuller_batches_match_per_box_test) {
+    using namespace UnitFrustumCuller;
+
+    const Renderer::Frustum f = frustum();
+    std::mt19937 rng { 7 };
+    std::uniform_real_distribution<float> position { -120.0f, 120.0f };
+    std::uniform_real_distribution<float> size { 0.0f, 5.0f };
+
+    // Every count up to a few batches, so the boxes that don't fill a batch are covered too.
+    Renderer::FrustumCuller culler;
+    for (size_t count = 0; count < 40; ++count) {
+        culler.clear();
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < count; ++i) {
+            const glm::vec3 center { position(rng), position(rng), position(rng) };
+            const glm::vec3 extent { size(rng), size(rng), size(rng) };
+            culler.push({ center - extent, center + extent });
+            if (Renderer::FrustumCuller::is_visible(f, center, extent)) {
+                expected.push_back(i);
+            }
+        }
+        const auto visible = culler.cull(f);
+        EXPECT_EQ(std::vector(visible.begin(), visible.end()), expected) << "count " << count;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Core/GlCommandQueue.hpp"
+#include "TestPch.hpp"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(Unit, GlCommandQueue_runs_every_pushed_command_on_the_draining_thread) {
+    auto& queue = Core::GlCommandQueue::instance();
+    queue.drain_all();
+
+    const auto draining_thread_id = std::this_thread::get_id();
+    std::vector<int> per_producer(4, 0);
+    int wrong_thread_runs = 0;
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < per_producer.size(); ++p) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < 1000; ++i) {
+                queue.push([&, p]() {
+                    ++per_producer[p];
+                    wrong_thread_runs += std::this_thread::get_id() != draining_thread_id;
+                });
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_EQ(queue.drain_all(), 4000);
+    EXPECT_TRUE(queue.is_empty());
+    EXPECT_EQ(wrong_thread_runs, 0);
+    for (int count : per_producer) {
+        EXPECT_EQ(count, 1000);
+    }
+}
+
+TEST(Unit, GlCommandQueue_drain_respects_budget) {
+    auto& queue = Core::GlCommandQueue::instance();
+    queue.drain_all();
+
+    for (int i = 0; i < 10; ++i) {
+        queue.push([]() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+    }
+    const size_t first_frame = queue.drain(std::chrono::microseconds(2500));
+    EXPECT_GE(first_frame, 1);
+    EXPECT_LT(first_frame, 10);
+    EXPECT_EQ(first_frame + queue.drain_all(), 10);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Core/TextureUnitLru.hpp"
+#include "TestPch.hpp"
+
+#include <vector>
+
+namespace UnitGlState {
+    inline auto acquire(Core::TextureUnitLru& lru, uint32_t texture, std::optional<uint32_t> hint = std::nullopt, bool is_locked = false) -> uint32_t {
+        auto result = lru.acquire(texture, hint, is_locked);
+        EXPECT_TRUE(result.has_value());
+        return result.value().unit;
+    }
+}
+
+TEST(Unit, TextureUnitLru_hands_out_empty_then_least_recently_used) {
+    using namespace UnitGlState;
+    Core::TextureUnitLru lru;
+    lru.reset(3);
+
+    const uint32_t a = acquire(lru, 10);
+    const uint32_t b = acquire(lru, 20);
+    const uint32_t c = acquire(lru, 30);
+    EXPECT_EQ((std::vector { a, b, c }), (std::vector<uint32_t> { 0, 1, 2 }));
+
+    // Still bound, so no bind is needed, and it's now the most recently used.
+    auto again = lru.acquire(10, a, false);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ(again.value().unit, a);
+    EXPECT_FALSE(again.value().is_bind_needed);
+    EXPECT_EQ(lru.lru_order(), (std::vector { b, c, a }));
+
+    // 20 is the oldest, so it loses its unit and its hint no longer matches.
+    auto evicting = lru.acquire(40, std::nullopt, false);
+    ASSERT_TRUE(evicting.has_value());
+    EXPECT_EQ(evicting.value().unit, b);
+    EXPECT_TRUE(evicting.value().is_bind_needed);
+    EXPECT_FALSE(evicting.value().was_empty);
+    EXPECT_EQ(lru.texture(b), 40u);
+    EXPECT_TRUE(lru.acquire(20, b, false).value().is_bind_needed);
+}
+
+TEST(Unit, TextureUnitLru_locks_are_counted) {
+    using namespace UnitGlState;
+    Core::TextureUnitLru lru;
+    lru.reset(2);
+
+    // Two batches lock the same texture, then something binds it unlocked in between.
+    const uint32_t unit = acquire(lru, 10, std::nullopt, true);
+    EXPECT_EQ(acquire(lru, 10, unit, true), unit);
+    EXPECT_EQ(acquire(lru, 10, unit, false), unit);
+    EXPECT_EQ(lru.num_locks(unit), 2u);
+    EXPECT_EQ(lru.lru_order(), (std::vector<uint32_t> { 1 }));
+
+    // Only the other unit can be handed out while any lock is left.
+    EXPECT_EQ(acquire(lru, 20), 1u);
+    EXPECT_EQ(acquire(lru, 30), 1u);
+    lru.unlock(10, unit);
+    EXPECT_EQ(acquire(lru, 40), 1u);
+    EXPECT_EQ(lru.texture(unit), 10u);
+
+    // Once unlocked it's the most recently used.
+    lru.unlock(10, unit);
+    EXPECT_EQ(lru.num_locks(unit), 0u);
+    EXPECT_EQ(lru.lru_order(), (std::vector<uint32_t> { 1, unit }));
+    EXPECT_EQ(acquire(lru, 50), 1u);
+    EXPECT_EQ(acquire(lru, 60), unit);
+
+    // Unlocking what isn't locked, or isn't there, does nothing.
+    lru.unlock(60, unit);
+    lru.unlock(10, unit);
+    EXPECT_EQ(lru.lru_order(), (std::vector<uint32_t> { 1, unit }));
+}
+
+TEST(Unit, TextureUnitLru_runs_out_when_everything_is_locked) {
+    using namespace UnitGlState;
+    Core::TextureUnitLru lru;
+    lru.reset(2);
+
+    acquire(lru, 10, std::nullopt, true);
+    acquire(lru, 20, std::nullopt, true);
+    EXPECT_TRUE(lru.acquire(30, std::nullopt, false).has_error());
+    EXPECT_TRUE(lru.lru_order().empty());
+
+    lru.unlock(20, 1);
+    EXPECT_EQ(acquire(lru, 30), 1u);
+}
+
+TEST(Unit, TextureUnitLru_release_empties_the_unit_whatever_its_locks) {
+    using namespace UnitGlState;
+    Core::TextureUnitLru lru;
+    lru.reset(3);
+
+    const uint32_t a = acquire(lru, 10);
+    const uint32_t b = acquire(lru, 20, std::nullopt, true);
+    acquire(lru, 20, b, true);
+
+    EXPECT_FALSE(lru.release(30, b));
+    EXPECT_FALSE(lru.release(0, 2)); // already empty.
+    EXPECT_TRUE(lru.release(20, b));
+    EXPECT_EQ(lru.texture(b), 0u);
+    EXPECT_EQ(lru.num_locks(b), 0u);
+
+    // Empty units go to the front.
+    EXPECT_EQ(lru.lru_order(), (std::vector<uint32_t> { b, 2, a }));
+    auto reused = lru.acquire(40, std::nullopt, false);
+    EXPECT_EQ(reused.value().unit, b);
+    EXPECT_TRUE(reused.value().was_empty);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Profiler/GpuSpanFrames.hpp"
+#include "TestPch.hpp"
+
+#include <vector>
+
+namespace UnitGpuProfiler {
+    // Times one span in the current frame, returns its begin and end slots.
+    inline auto time_span(GpuSpanFrames& frames, uint32_t zone_id) -> std::pair<GpuSpanFrames::Slot, GpuSpanFrames::Slot> {
+        const auto [span, begin] = frames.begin_span(zone_id, 0);
+        const auto end = frames.end_span(span);
+        EXPECT_TRUE(end.has_value());
+        return { begin, end.value_or(GpuSpanFrames::Slot {}) };
+    }
+}
+
+TEST(Unit, GpuProfiler_query_slots_are_reused_once_read_back) {
+    using namespace UnitGpuProfiler;
+    GpuSpanFrames frames;
+
+    // Nested spans share the frame's slots in the order they're issued.
+    const auto [outer, outer_begin] = frames.begin_span(1, 0);
+    const auto [inner_begin, inner_end] = time_span(frames, 2);
+    const auto outer_end = frames.end_span(outer);
+    ASSERT_TRUE(outer_end.has_value());
+    EXPECT_EQ(outer_begin.query, 0u);
+    EXPECT_EQ(inner_begin.query, 1u);
+    EXPECT_EQ(inner_end.query, 2u);
+    EXPECT_EQ(outer_end->query, 3u);
+    EXPECT_EQ(outer_end->frame, outer_begin.frame);
+
+    std::vector<size_t> read_back;
+    auto read_everything = [&](size_t frame_index, const GpuSpanFrames::Frame& frame) {
+        read_back.push_back(frame_index);
+        EXPECT_EQ(frame.num_queries_used, 4u);
+        EXPECT_EQ(frame.spans.size(), 2u);
+        EXPECT_EQ(frame.spans[0].end_query, 3u);
+        return true;
+    };
+    frames.end_frame(read_everything);
+    EXPECT_EQ(read_back, (std::vector<size_t> { 0 }));
+    EXPECT_EQ(frames.frames()[0].num_queries_used, 0u);
+
+    // Back round to frame 0, its slots start again from the beginning.
+    for (size_t i = 1; i < GpuSpanFrames::FRAMES_IN_FLIGHT; ++i) {
+        frames.end_frame([](size_t, const GpuSpanFrames::Frame&) { return true; });
+    }
+    EXPECT_EQ(frames.current_frame(), 0u);
+    const auto [begin, end] = time_span(frames, 1);
+    EXPECT_EQ(begin.frame, 0u);
+    EXPECT_EQ(begin.query, 0u);
+    EXPECT_EQ(end.query, 1u);
+    EXPECT_EQ(frames.num_dropped_frames(), 0u);
+}
+
+TEST(Unit, GpuProfiler_frames_are_read_back_oldest_first_until_one_isnt_done) {
+    using namespace UnitGpuProfiler;
+    GpuSpanFrames frames;
+
+    // Frames 0, 1 and 2 each time something, the GPU has only finished frame 0.
+    std::vector<size_t> tried;
+    size_t num_done = 1;
+    auto read_back = [&](size_t frame_index, const GpuSpanFrames::Frame&) {
+        tried.push_back(frame_index);
+        return frame_index < num_done;
+    };
+    for (uint32_t f = 0; f < 3; ++f) {
+        time_span(frames, f);
+        frames.end_frame(read_back);
+    }
+    // Frame 0 on the first call, then frame 1 is retried (and stops the search) every call after.
+    EXPECT_EQ(tried, (std::vector<size_t> { 0, 1, 1 }));
+    EXPECT_EQ(frames.frames()[0].num_queries_used, 0u);
+    EXPECT_EQ(frames.frames()[1].spans.size(), 1u);
+    EXPECT_EQ(frames.frames()[2].spans.size(), 1u);
+
+    // Once it's done, frame 2 follows straight after it.
+    tried.clear();
+    num_done = 3;
+    frames.end_frame(read_back);
+    EXPECT_EQ(tried, (std::vector<size_t> { 1, 2 }));
+    EXPECT_EQ(frames.num_dropped_frames(), 0u);
+}
+
+TEST(Unit, GpuProfiler_frames_the_gpu_is_too_far_behind_on_are_dropped) {
+    using namespace UnitGpuProfiler;
+    GpuSpanFrames frames;
+    auto never_done = [](size_t, const GpuSpanFrames::Frame&) { return false; };
+
+    time_span(frames, 1);
+    for (size_t i = 0; i < GpuSpanFrames::FRAMES_IN_FLIGHT - 1; ++i) {
+        frames.end_frame(never_done);
+    }
+    EXPECT_EQ(frames.num_dropped_frames(), 0u);
+
+    // Frame 0 is reused next and still isn't done.
+    frames.end_frame(never_done);
+    EXPECT_EQ(frames.num_dropped_frames(), 1u);
+    EXPECT_EQ(frames.current_frame(), 0u);
+    EXPECT_TRUE(frames.frames()[0].spans.empty());
+    EXPECT_EQ(time_span(frames, 2).first.query, 0u);
+}
+
+TEST(Unit, GpuProfiler_spans_end_in_the_frame_they_began_in) {
+    GpuSpanFrames frames;
+    auto never_done = [](size_t, const GpuSpanFrames::Frame&) { return false; };
+
+    // A zone open across end_frame() still ends in frame 0, not whichever frame is current.
+    const auto [span, begin] = frames.begin_span(1, 0);
+    frames.end_frame(never_done);
+    (void)frames.begin_span(2, 0);
+    const auto end = frames.end_span(span);
+    ASSERT_TRUE(end.has_value());
+    EXPECT_EQ(end->frame, begin.frame);
+    EXPECT_EQ(end->query, 1u);
+    EXPECT_EQ(frames.frames()[0].spans[0].end_query, 1u);
+    EXPECT_EQ(frames.frames()[1].spans[0].end_query, GpuSpanFrames::NOT_ENDED);
+
+    // Once its frame has been dropped and reused there's nothing left to end.
+    const auto [late_span, late_begin] = frames.begin_span(3, 0);
+    for (size_t i = 0; i < GpuSpanFrames::FRAMES_IN_FLIGHT; ++i) {
+        frames.end_frame(never_done);
+    }
+    EXPECT_FALSE(frames.end_span(late_span).has_value());
+}
@@ -0,0 +1,496 @@
+#pragma once
+
+#include "Config.hpp"
+#include "Profiler/Profiler.hpp"
+#include "TestPch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace UnitProfiler {
+    inline auto count_occurrences(std::string_view text, std::string_view pattern) -> size_t {
+        size_t count = 0;
+        for (size_t pos = text.find(pattern); pos != std::string_view::npos; pos = text.find(pattern, pos + pattern.size())) {
+            ++count;
+        }
+        return count;
+    }
+
+    // Stops the compiler from eliding new/delete pairs.
+    inline void* volatile allocation_sink = nullptr;
+}
+
+TEST(Unit, Profiler_streaming_writes_every_zone_as_valid_json) {
+    const std::filesystem::path path = "unit_profiler_stream.json";
+    auto& profiler = Profiler::instance();
+    ASSERT_FALSE(profiler.start_streaming(path, std::chrono::milliseconds(1)).has_error());
+    EXPECT_TRUE(profiler.is_streaming());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 500; ++i) {
+                PROFILER_ZONE("UnitProfiler::streamed_zone()", "unit");
+                std::this_thread::sleep_for(std::chrono::microseconds(2));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    profiler.stop_streaming();
+    EXPECT_FALSE(profiler.is_streaming());
+
+    std::stringstream contents;
+    contents << std::ifstream(path).rdbuf();
+    const std::string json = contents.str();
+
+    EXPECT_TRUE(json.starts_with("{"));
+    EXPECT_TRUE(json.ends_with("]\n}"));
+    EXPECT_EQ(UnitProfiler::count_occurrences(json, "UnitProfiler::streamed_zone()"), 2000);
+    // every event but the last is followed by a comma.
+    EXPECT_EQ(UnitProfiler::count_occurrences(json, "{ \"args\""), UnitProfiler::count_occurrences(json, " },\n") + 1);
+    EXPECT_EQ(json.find(",\n\n"), std::string::npos);
+    EXPECT_EQ(json.find("},\n\t]"), std::string::npos);
+}
+
+TEST(Unit, Profiler_binary_trace_format_roundtrips) {
+    const std::vector<TraceFormat::Event> events = {
+        { .start_ns = 1000, .end_ns = 5000, .zone_id = 0, .process_id = 0, .thread_index = 0 },
+        { .start_ns = 1200, .end_ns = 1300, .zone_id = 1, .process_id = 1, .thread_index = 3 },
+        { .start_ns = 900, .end_ns = 100'000'000'000, .zone_id = 1, .process_id = 0, .thread_index = 1 },
+    };
+
+    TraceFormat::Writer writer;
+    std::string bytes;
+    writer.write_header(bytes);
+    writer.write_zone(bytes, 0, "zone_a", "unit");
+    writer.write_zone(bytes, 1, "zone_b", "");
+    writer.write_process(bytes, 0, "default");
+    writer.write_process(bytes, 1, "unit");
+    writer.write_events(bytes, events);
+    const size_t size_before_end = bytes.size();
+    writer.write_end(bytes);
+
+    auto decoded = TraceFormat::decode({ reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size() });
+    ASSERT_FALSE(decoded.has_error());
+    const auto& trace = decoded.value();
+    ASSERT_EQ(trace.zones.size(), 2);
+    EXPECT_EQ(trace.zones[0].name, "zone_a");
+    EXPECT_EQ(trace.zones[0].category, "unit");
+    EXPECT_EQ(trace.zones[1].category, "");
+    ASSERT_EQ(trace.processes.size(), 2);
+    EXPECT_EQ(trace.processes[1], "unit");
+    ASSERT_EQ(trace.events.size(), events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        EXPECT_EQ(trace.events[i].start_ns, events[i].start_ns);
+        EXPECT_EQ(trace.events[i].end_ns, events[i].end_ns);
+        EXPECT_EQ(trace.events[i].zone_id, events[i].zone_id);
+        EXPECT_EQ(trace.events[i].process_id, events[i].process_id);
+        EXPECT_EQ(trace.events[i].thread_index, events[i].thread_index);
+    }
+
+    // A stream cut off mid-chunk keeps the complete chunks and drops the partial one.
+    auto truncated = TraceFormat::decode({ reinterpret_cast<const uint8_t*>(bytes.data()), size_before_end - 1 });
+    ASSERT_FALSE(truncated.has_error());
+    EXPECT_EQ(truncated.value().zones.size(), 2);
+    EXPECT_TRUE(truncated.value().events.empty());
+
+    bytes[0] = 'X';
+    EXPECT_TRUE(TraceFormat::decode({ reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size() }).has_error());
+}
+
+TEST(Unit, Profiler_binary_trace_rejects_undefined_ids) {
+    auto decode = [](const std::string& bytes) {
+        return TraceFormat::decode({ reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size() });
+    };
+    auto header = [] {
+        TraceFormat::Writer writer;
+        std::string bytes;
+        writer.write_header(bytes);
+        writer.write_zone(bytes, 0, "zone_a", "unit");
+        writer.write_process(bytes, 0, "default");
+        writer.write_counter(bytes, 0, "counter_a", "unit");
+        return std::pair { writer, bytes };
+    };
+    auto with_event = [&](TraceFormat::Event event) {
+        auto [writer, bytes] = header();
+        writer.write_events(bytes, std::array { event });
+        writer.write_end(bytes);
+        return decode(bytes);
+    };
+    auto with_counter_event = [&](TraceFormat::CounterEvent event) {
+        auto [writer, bytes] = header();
+        writer.write_counter_events(bytes, std::array { event });
+        writer.write_end(bytes);
+        return decode(bytes);
+    };
+
+    EXPECT_FALSE(with_event({ .start_ns = 0, .end_ns = 1, .zone_id = 0, .process_id = 0, .thread_index = 0 }).has_error());
+    EXPECT_TRUE(with_event({ .start_ns = 0, .end_ns = 1, .zone_id = 1, .process_id = 0, .thread_index = 0 }).has_error());
+    EXPECT_TRUE(with_event({ .start_ns = 0, .end_ns = 1, .zone_id = 0, .process_id = 1, .thread_index = 0 }).has_error());
+    EXPECT_FALSE(with_counter_event({ .time_ns = 0, .value = 1, .counter_id = 0, .process_id = 0 }).has_error());
+    EXPECT_TRUE(with_counter_event({ .time_ns = 0, .value = 1, .counter_id = 1, .process_id = 0 }).has_error());
+    EXPECT_TRUE(with_counter_event({ .time_ns = 0, .value = 1, .counter_id = 0, .process_id = 1 }).has_error());
+
+    // A zone named by a string that was never written.
+    auto [writer, bytes] = header();
+    bytes += { static_cast<char>(TraceFormat::Tag::zone), 1, 9, 0 };
+    auto decoded = decode(bytes);
+    ASSERT_TRUE(decoded.has_error());
+    EXPECT_TRUE(std::string_view(decoded.error().what()).starts_with("Corrupt binary trace"));
+}
+
+TEST(Unit, Profiler_binary_stream_decodes_every_zone) {
+    const std::filesystem::path path = std::string("unit_profiler_stream") + std::string(TraceFormat::FILE_EXTENSION);
+    auto& profiler = Profiler::instance();
+    ASSERT_FALSE(profiler.start_streaming(path, std::chrono::milliseconds(1), Profiler::TraceFileFormat::binary).has_error());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 500; ++i) {
+                PROFILER_ZONE("UnitProfiler::binary_streamed_zone()", "unit");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    profiler.stop_streaming();
+
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    const std::vector<uint8_t> bytes { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    auto decoded = TraceFormat::decode(bytes);
+    ASSERT_FALSE(decoded.has_error());
+    const auto& trace = decoded.value();
+
+    size_t num_zone_events = 0;
+    for (const auto& event : trace.events) {
+        ASSERT_LT(event.zone_id, trace.zones.size());
+        ASSERT_LT(event.process_id, trace.processes.size());
+        EXPECT_LE(event.start_ns, event.end_ns);
+        if (trace.zones[event.zone_id].name == "UnitProfiler::binary_streamed_zone()") {
+            ++num_zone_events;
+        }
+    }
+    EXPECT_EQ(num_zone_events, 2000);
+}
+
+TEST(Unit, Profiler_flight_recorder_keeps_the_window_and_dumps_on_spikes) {
+    auto& profiler = Profiler::instance();
+    ASSERT_FALSE(profiler.start_flight_recorder(Profiler::FlightRecorderSettings {
+                                .window = std::chrono::milliseconds(1000),
+                                .frame_budget = std::chrono::milliseconds(16),
+                                .dump_cooldown = std::chrono::seconds(60),
+                                .max_events = 64,
+                                .dump_directory = ".",
+                            })
+                     .has_error());
+    EXPECT_TRUE(profiler.is_flight_recording());
+    EXPECT_TRUE(profiler.start_streaming("unit_profiler_flight_stream.json").has_error());
+
+    const Profiler::Zone old_zone { "UnitProfiler::old_zone()", "unit" };
+    const Profiler::Zone recent_zone { "UnitProfiler::recent_zone()", "unit" };
+    const int64_t now = Profiler::now_ticks();
+    const auto ten_seconds = static_cast<int64_t>(10'000'000'000.0 / profiler.ns_per_tick());
+    profiler.submit_event({ .start_ticks = now - ten_seconds, .end_ticks = now - ten_seconds + 5000, .zone_id = old_zone.id(), .process_id = 0, .thread_index = 0 });
+    // More than max_events, only the newest 64 are kept.
+    for (int i = 0; i < 100; ++i) {
+        profiler.submit_event({ .start_ticks = now + i * 1000, .end_ticks = now + i * 1000 + 500, .zone_id = recent_zone.id(), .process_id = 0, .thread_index = 0 });
+    }
+
+    EXPECT_FALSE(profiler.mark_frame(std::chrono::milliseconds(5)).has_value());
+    const auto dump_path = profiler.mark_frame(std::chrono::milliseconds(40));
+    ASSERT_TRUE(dump_path.has_value());
+    // cooling down.
+    EXPECT_FALSE(profiler.mark_frame(std::chrono::milliseconds(40)).has_value());
+
+    std::ifstream file(*dump_path, std::ios::in | std::ios::binary);
+    const std::vector<uint8_t> bytes { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    auto decoded = TraceFormat::decode(bytes);
+    ASSERT_FALSE(decoded.has_error());
+    size_t num_old = 0;
+    size_t num_recent = 0;
+    for (const auto& event : decoded.value().events) {
+        num_old += event.zone_id == old_zone.id();
+        num_recent += event.zone_id == recent_zone.id();
+    }
+    EXPECT_EQ(num_old, 0);
+    EXPECT_GT(num_recent, 0);
+    EXPECT_LE(num_recent, 64);
+
+    profiler.stop_flight_recorder();
+    EXPECT_FALSE(profiler.is_flight_recording());
+    EXPECT_FALSE(profiler.mark_frame(std::chrono::milliseconds(40)).has_value());
+}
+
+TEST(Unit, Profiler_can_be_toggled_globally_and_per_category) {
+    auto& profiler = Profiler::instance();
+    const Profiler::Zone toggled_zone { "UnitProfiler::toggled_zone()", "unit_toggle" };
+    const Profiler::Zone other_zone { "UnitProfiler::other_zone()", "unit_other" };
+
+    auto count_recorded = [&](const Profiler::Zone& zone) {
+        const std::string trace = profiler.format_as_binary_trace();
+        auto decoded = TraceFormat::decode({ reinterpret_cast<const uint8_t*>(trace.data()), trace.size() });
+        return std::ranges::count_if(decoded.value().events, [&](const auto& event) { return event.zone_id == zone.id(); });
+    };
+    auto enter_both = [&]() {
+        {
+            const Profiler::Timer timer { toggled_zone };
+        }
+        {
+            const Profiler::Timer timer { other_zone };
+        }
+    };
+
+    enter_both();
+    EXPECT_EQ(count_recorded(toggled_zone), 1);
+
+    profiler.set_category_enabled("unit_toggle", false);
+    EXPECT_FALSE(profiler.is_category_enabled("unit_toggle"));
+    EXPECT_FALSE(toggled_zone.is_recording());
+    enter_both();
+    EXPECT_EQ(count_recorded(toggled_zone), 1);
+    EXPECT_EQ(count_recorded(other_zone), 2);
+
+    profiler.set_enabled(false);
+    EXPECT_FALSE(other_zone.is_recording());
+    enter_both();
+    EXPECT_EQ(count_recorded(other_zone), 2);
+
+    // Re-enabling globally keeps the category's own switch.
+    profiler.set_enabled(true);
+    EXPECT_FALSE(toggled_zone.is_recording());
+    EXPECT_TRUE(other_zone.is_recording());
+
+    profiler.set_category_enabled("unit_toggle", true);
+    enter_both();
+    EXPECT_EQ(count_recorded(toggled_zone), 2);
+    EXPECT_EQ(count_recorded(other_zone), 3);
+
+    // Categories switched off before any of their zones exist apply once they do.
+    profiler.set_category_enabled("unit_later", false);
+    const Profiler::Zone later_zone { "UnitProfiler::later_zone()", "unit_later" };
+    EXPECT_FALSE(later_zone.is_recording());
+    profiler.set_category_enabled("unit_later", true);
+}
+
+TEST(Unit, Profiler_hdr_histogram_percentiles) {
+    HdrHistogram histogram;
+    EXPECT_EQ(histogram.percentile(50.0), 0);
+    for (uint64_t i = 1; i <= 10'000; ++i) {
+        histogram.record(i * 1000);
+    }
+    EXPECT_EQ(histogram.count(), 10'000);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 5'000'500.0);
+
+    auto expect_within_bucket = [](uint64_t actual, double expected) {
+        EXPECT_NEAR(static_cast<double>(actual), expected, expected / HdrHistogram::SUB_BUCKETS);
+    };
+    expect_within_bucket(histogram.percentile(50.0), 5'000'000.0);
+    expect_within_bucket(histogram.percentile(95.0), 9'500'000.0);
+    expect_within_bucket(histogram.percentile(99.0), 9'900'000.0);
+    expect_within_bucket(histogram.max(), 10'000'000.0);
+
+    // Small values are exact.
+    HdrHistogram small;
+    small.record(3);
+    small.record(7);
+    EXPECT_EQ(small.percentile(50.0), 3);
+    EXPECT_EQ(small.percentile(100.0), 7);
+    small.remove(7);
+    EXPECT_EQ(small.max(), 3);
+    EXPECT_EQ(small.count(), 1);
+
+    for (uint64_t value : { uint64_t { 0 }, uint64_t { 127 }, uint64_t { 128 }, uint64_t { 1'000'000 }, HdrHistogram::MAX_VALUE }) {
+        EXPECT_LT(HdrHistogram::bucket_index(value), HdrHistogram::NUM_BUCKETS);
+    }
+    EXPECT_EQ(HdrHistogram::bucket_index(HdrHistogram::MAX_VALUE), HdrHistogram::NUM_BUCKETS - 1);
+}
+
+TEST(Unit, Profiler_zone_stats_cover_the_last_n_frames) {
+    auto& profiler = Profiler::instance();
+    profiler.start_zone_stats(4);
+    EXPECT_FALSE(profiler.zone_stats("UnitProfiler::stats_zone()").has_value());
+
+    const Profiler::Zone zone { "UnitProfiler::stats_zone()", "unit" };
+    const double ns_per_tick = profiler.ns_per_tick();
+    auto submit = [&](double duration_ns) {
+        const auto duration_ticks = static_cast<int64_t>(duration_ns / ns_per_tick);
+        profiler.submit_event({ .start_ticks = 0, .end_ticks = duration_ticks, .zone_id = zone.id(), .process_id = 0, .thread_index = 0 });
+    };
+
+    // One slow frame, followed by fast ones that push it out of the window.
+    submit(1'000'000);
+    profiler.mark_frame(std::chrono::milliseconds(1));
+    for (int frame = 0; frame < 3; ++frame) {
+        submit(1000);
+        submit(1000);
+        profiler.mark_frame(std::chrono::milliseconds(1));
+    }
+
+    auto stats = profiler.zone_stats("UnitProfiler::stats_zone()");
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->count, 7);
+    EXPECT_EQ(stats->category, "unit");
+    EXPECT_NEAR(stats->p50_ns, 1000.0, 1000.0 / HdrHistogram::SUB_BUCKETS);
+    EXPECT_NEAR(stats->p99_ns, 1'000'000.0, 1'000'000.0 / HdrHistogram::SUB_BUCKETS);
+
+    profiler.mark_frame(std::chrono::milliseconds(1));
+    stats = profiler.zone_stats("UnitProfiler::stats_zone()");
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->count, 6);
+    EXPECT_NEAR(stats->p99_ns, 1000.0, 1000.0 / HdrHistogram::SUB_BUCKETS);
+    EXPECT_NEAR(stats->per_frame_ns, 6000.0 / 4.0, 6000.0 / 4.0 / HdrHistogram::SUB_BUCKETS);
+
+    const auto all_stats = profiler.all_zone_stats();
+    EXPECT_TRUE(std::ranges::any_of(all_stats, [](const auto& s) { return s.name == "UnitProfiler::stats_zone()"; }));
+
+    profiler.stop_zone_stats();
+    EXPECT_FALSE(profiler.zone_stats("UnitProfiler::stats_zone()").has_value());
+}
+
+TEST(Unit, Profiler_timestamps_convert_to_steady_clock_time) {
+    auto& profiler = Profiler::instance();
+    const Profiler::Zone zone { "UnitProfiler::timed_zone()", "unit" };
+    const auto steady_start = std::chrono::steady_clock::now();
+    {
+        const Profiler::Timer timer { zone };
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    const auto steady_elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - steady_start).count();
+
+    const std::string trace = profiler.format_as_binary_trace();
+    auto decoded = TraceFormat::decode({ reinterpret_cast<const uint8_t*>(trace.data()), trace.size() });
+    ASSERT_FALSE(decoded.has_error());
+    auto iter = std::ranges::find_if(decoded.value().events, [&](const auto& event) { return event.zone_id == zone.id(); });
+    ASSERT_NE(iter, decoded.value().events.end());
+    const auto duration = static_cast<double>(iter->end_ns - iter->start_ns);
+    EXPECT_GE(duration, 20'000'000.0 * 0.99);
+    EXPECT_LE(duration, steady_elapsed * 1.01);
+
+    // Back to back reads never go backwards, with no fake nudging.
+    int64_t previous = Profiler::now_ticks();
+    for (int i = 0; i < 1000; ++i) {
+        const int64_t ticks = Profiler::now_ticks();
+        EXPECT_GE(ticks, previous);
+        previous = ticks;
+    }
+}
+
+TEST(Unit, Profiler_counters_are_exported_next_to_zones) {
+    auto& profiler = Profiler::instance();
+    const Profiler::Counter sampled { "UnitProfiler::sampled_counter", "unit" };
+    const Profiler::Counter per_frame { "UnitProfiler::per_frame_counter", "unit", Profiler::Counter::Kind::per_frame };
+
+    sampled.record(3);
+    sampled.record(-7);
+    per_frame.add(10);
+    per_frame.add(32);
+    profiler.mark_frame(std::chrono::milliseconds(1));
+    per_frame.add(5);
+    profiler.mark_frame(std::chrono::milliseconds(1));
+
+    const std::string trace = profiler.format_as_binary_trace();
+    auto decoded = TraceFormat::decode({ reinterpret_cast<const uint8_t*>(trace.data()), trace.size() });
+    ASSERT_FALSE(decoded.has_error());
+    ASSERT_GT(decoded.value().counters.size(), per_frame.id());
+    EXPECT_EQ(decoded.value().counters[sampled.id()].name, "UnitProfiler::sampled_counter");
+
+    auto values_of = [&](const Profiler::Counter& counter) {
+        std::vector<int64_t> values;
+        for (const auto& event : decoded.value().counter_events) {
+            if (event.counter_id == counter.id()) {
+                values.push_back(event.value);
+            }
+        }
+        return values;
+    };
+    EXPECT_EQ(values_of(sampled), (std::vector<int64_t> { 3, -7 }));
+    EXPECT_EQ(values_of(per_frame), (std::vector<int64_t> { 42, 5 }));
+
+    const std::string json = profiler.format_as_trace_event_json();
+    EXPECT_NE(json.find("\"name\":\"UnitProfiler::sampled_counter\", \"cat\":\"unit\", \"ph\":\"C\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{ \"value\":-7 }"), std::string::npos);
+
+    // Counters follow their category's switch too.
+    profiler.set_category_enabled("unit", false);
+    sampled.record(100);
+    profiler.set_category_enabled("unit", true);
+    EXPECT_EQ(profiler.format_as_trace_event_json().find("\"value\":100 "), std::string::npos);
+}
+
+TEST(Unit, Profiler_allocations_are_charged_to_the_innermost_zone) {
+    if constexpr (!Config::TRACK_ALLOCATIONS) {
+        GTEST_SKIP() << "Needs CONFIG_TRACK_ALLOCATIONS.";
+    }
+    auto& profiler = Profiler::instance();
+    profiler.reset_allocation_stats();
+
+    static const Profiler::Zone outer_zone { "UnitProfiler::allocating_outer()", "unit" };
+    static const Profiler::Zone inner_zone { "UnitProfiler::allocating_inner()", "unit" };
+    for (int i = 0; i < 3; ++i) {
+        const Profiler::Timer outer_timer { outer_zone };
+        auto outer = std::make_unique<std::array<char, 100>>();
+        UnitProfiler::allocation_sink = outer.get();
+        {
+            const Profiler::Timer inner_timer { inner_zone };
+            auto first = std::make_unique<std::array<char, 24>>();
+            auto second = std::make_unique<std::array<char, 8>>();
+            UnitProfiler::allocation_sink = first.get();
+            UnitProfiler::allocation_sink = second.get();
+        }
+    }
+
+    auto outer = profiler.allocation_stats("UnitProfiler::allocating_outer()");
+    auto inner = profiler.allocation_stats("UnitProfiler::allocating_inner()");
+    ASSERT_TRUE(outer && inner);
+    EXPECT_EQ(outer->count, 3);
+    EXPECT_EQ(outer->allocations, 3);
+    EXPECT_EQ(outer->allocated_bytes, 300);
+    EXPECT_EQ(inner->allocations, 6);
+    EXPECT_EQ(inner->allocated_bytes, 96);
+
+    const auto all = profiler.all_allocation_stats();
+    EXPECT_TRUE(std::ranges::is_sorted(all, std::ranges::greater {}, &Profiler::AllocationStats::allocated_bytes));
+
+    const std::string trace = profiler.format_as_binary_trace();
+    auto decoded = TraceFormat::decode({ reinterpret_cast<const uint8_t*>(trace.data()), trace.size() });
+    ASSERT_FALSE(decoded.has_error());
+    const auto inner_events = std::ranges::count_if(decoded.value().events, [](const TraceFormat::Event& event) {
+        return event.zone_id == inner_zone.id() && event.allocations == 2 && event.allocated_bytes == 32;
+    });
+    EXPECT_EQ(inner_events, 3);
+
+    profiler.reset_allocation_stats();
+    EXPECT_FALSE(profiler.allocation_stats("UnitProfiler::allocating_outer()"));
+}
+
+TEST(Unit, Profiler_gpu_events_get_their_own_track) {
+    auto& profiler = Profiler::instance();
+    static const Profiler::Zone gpu_zone { "UnitProfiler::gpu_zone() (GPU)", "unit" };
+    const int64_t now = Profiler::now_ticks();
+    const auto two_micros = static_cast<int64_t>(2000.0 / profiler.ns_per_tick());
+    // What GpuProfiler submits once the queries are read back.
+    profiler.submit_event({ .start_ticks = now, .end_ticks = now + two_micros, .zone_id = gpu_zone.id(), .process_id = 0, .thread_index = TraceFormat::GPU_THREAD_INDEX });
+
+    const std::string json = profiler.format_as_trace_event_json();
+    EXPECT_NE(json.find("\"name\":\"UnitProfiler::gpu_zone() (GPU)\", \"cat\":\"unit\", \"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"tid\":\"GPU\""), std::string::npos);
+
+    const std::string trace = profiler.format_as_binary_trace();
+    auto decoded = TraceFormat::decode({ reinterpret_cast<const uint8_t*>(trace.data()), trace.size() });
+    ASSERT_FALSE(decoded.has_error());
+    EXPECT_TRUE(std::ranges::any_of(decoded.value().events, [](const TraceFormat::Event& event) {
+        return event.zone_id == gpu_zone.id() && event.thread_index == TraceFormat::GPU_THREAD_INDEX;
+    }));
+}
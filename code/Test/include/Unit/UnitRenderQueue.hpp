@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Renderer/RenderQueue.hpp"
+#include "TestPch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+namespace UnitRenderQueue {
+    inline auto key(Renderer::RenderQueue::Pass pass, bool is_translucent, float depth) -> uint64_t {
+        return Renderer::RenderQueue::make_key(Renderer::RenderQueue::DrawPacket {
+            .pass = pass,
+            .is_translucent = is_translucent,
+            .depth = depth,
+        });
+    }
+
+    // Only the origin matters for depth.
+    inline auto at(float x, float y, float z) -> glm::mat4 {
+        glm::mat4 transform { 1.0f };
+        transform[3] = glm::vec4 { x, y, z, 1.0f };
+        return transform;
+    }
+}
+
+TEST(Unit, RenderQueue_keys_order_passes_then_opaque_then_translucent) {
+    using namespace UnitRenderQueue;
+    using Pass = Renderer::RenderQueue::Pass;
+
+    EXPECT_LT(key(Pass::world, true, 0.0f), key(Pass::overlay, false, 100.0f));
+    EXPECT_LT(key(Pass::world, false, 1000.0f), key(Pass::world, true, 1000.0f));
+
+    // Opaque front to back, translucent back to front.
+    EXPECT_LT(key(Pass::world, false, 0.5f), key(Pass::world, false, 2.0f));
+    EXPECT_LT(key(Pass::world, false, 2.0f), key(Pass::world, false, 300.0f));
+    EXPECT_GT(key(Pass::world, true, 0.5f), key(Pass::world, true, 2.0f));
+    EXPECT_GT(key(Pass::world, true, 2.0f), key(Pass::world, true, 300.0f));
+
+    // Behind the camera is as close as it gets.
+    EXPECT_EQ(key(Pass::world, false, -5.0f), key(Pass::world, false, 0.0f));
+}
+
+TEST(Unit, RenderQueue_radix_sort_matches_stable_sort) {
+    using SortItem = Renderer::RenderQueue::SortItem;
+
+    std::mt19937_64 rng { 42 };
+    std::vector<SortItem> items;
+    for (uint32_t i = 0; i < 10'000; ++i) {
+        // Few distinct values in the low and high bytes, as real keys have, so some passes are skipped.
+        const uint64_t key = (rng() & 0xF0FF'0000'00FF'0000) | (rng() % 4);
+        items.push_back(SortItem { .key = key, .index = i });
+    }
+    auto expected = items;
+    std::ranges::stable_sort(expected, {}, &SortItem::key);
+
+    std::vector<SortItem> scratch;
+    Renderer::RenderQueue::radix_sort(items, scratch);
+
+    ASSERT_EQ(items.size(), expected.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(items[i].key, expected[i].key);
+        EXPECT_EQ(items[i].index, expected[i].index);
+    }
+
+    // Nothing to sort, or nothing to move.
+    std::vector<SortItem> empty;
+    Renderer::RenderQueue::radix_sort(empty, scratch);
+    EXPECT_TRUE(empty.empty());
+
+    std::vector<SortItem> same(100, SortItem { .key = 7, .index = 0 });
+    for (uint32_t i = 0; i < same.size(); ++i) {
+        same[i].index = i;
+    }
+    Renderer::RenderQueue::radix_sort(same, scratch);
+    EXPECT_TRUE(std::ranges::is_sorted(same, {}, &SortItem::index));
+}
+
+TEST(Unit, RenderQueue_nearest_depth_is_from_the_view) {
+    using namespace UnitRenderQueue;
+    Renderer::RenderQueue render_queue;
+
+    // Identity until it's set, looking down -z.
+    EXPECT_FLOAT_EQ(render_queue.nearest_depth(std::array { at(0, 0, -3) }), 3.0f);
+
+    // Camera at z = 10.
+    glm::mat4 view { 1.0f };
+    view[3][2] = -10.0f;
+    render_queue.set_view(view);
+    EXPECT_FLOAT_EQ(render_queue.nearest_depth(std::array { at(0, 0, 0) }), 10.0f);
+    EXPECT_FLOAT_EQ(render_queue.nearest_depth(std::array { at(4, 2, 0), at(0, 0, 5), at(0, 0, -20) }), 5.0f);
+    EXPECT_LT(render_queue.nearest_depth(std::array { at(0, 0, 12) }), 0.0f);
+    EXPECT_EQ(render_queue.nearest_depth({}), 0.0f);
+}
+
+TEST(Unit, RenderQueue_sorts_pushed_packets) {
+    using namespace UnitRenderQueue;
+    using Pass = Renderer::RenderQueue::Pass;
+
+    Core::Shader shader;
+    Core::VertexArray vertex_array;
+    Renderer::RenderQueue render_queue;
+    glm::mat4 view { 1.0f };
+    view[3][2] = -10.0f;
+    render_queue.set_view(view);
+
+    auto push = [&](Pass pass, bool is_translucent, float z) {
+        render_queue.push(Renderer::RenderQueue::DrawPacket {
+            .pass = pass,
+            .is_translucent = is_translucent,
+            .depth = render_queue.nearest_depth(std::array { at(0, 0, z) }),
+            .shader = &shader,
+            .vertex_array = &vertex_array,
+        });
+    };
+    push(Pass::overlay, false, 0);
+    push(Pass::world, false, 0);
+    push(Pass::world, true, 5);
+    push(Pass::world, false, 5);
+    push(Pass::world, true, 0);
+    push(Pass::world, false, 5);
+
+    // World before overlay, opaque near to far (ties in push order), then translucent far to near.
+    std::vector<uint32_t> order;
+    for (const auto& item : render_queue.sort()) {
+        order.push_back(item.index);
+    }
+    EXPECT_EQ(order, (std::vector<uint32_t> { 3, 5, 1, 4, 2, 0 }));
+}
+
+TEST(Unit, RenderQueue_can_merge_only_contiguous_plain_draws) {
+    using DrawPacket = Renderer::RenderQueue::DrawPacket;
+
+    Core::Shader shader, other_shader;
+    Core::VertexArray vertex_array;
+    Core::Texture texture, other_texture;
+
+    auto packet = [&](size_t index_offset) {
+        return DrawPacket {
+            .shader = &shader,
+            .vertex_array = &vertex_array,
+            .texture = &texture,
+            .index_count = 6,
+            .index_offset = index_offset,
+        };
+    };
+    const DrawPacket last = packet(0);
+    const size_t next_offset = 6 * sizeof(uint32_t);
+
+    EXPECT_TRUE(Renderer::RenderQueue::can_merge(last, packet(next_offset)));
+    EXPECT_FALSE(Renderer::RenderQueue::can_merge(last, packet(next_offset + sizeof(uint32_t))));
+    EXPECT_FALSE(Renderer::RenderQueue::can_merge(last, packet(0)));
+
+    auto differs = [&](auto&& change) {
+        DrawPacket next = packet(next_offset);
+        change(next);
+        return !Renderer::RenderQueue::can_merge(last, next);
+    };
+    EXPECT_TRUE(differs([&](DrawPacket& p) { p.shader = &other_shader; }));
+    EXPECT_TRUE(differs([&](DrawPacket& p) { p.texture = &other_texture; }));
+    EXPECT_TRUE(differs([&](DrawPacket& p) { p.vertex_offset = 64; }));
+    EXPECT_TRUE(differs([&](DrawPacket& p) { p.is_depth_tested = false; }));
+    EXPECT_TRUE(differs([&](DrawPacket& p) { p.instance_count = 2; }));
+    EXPECT_TRUE(differs([&](DrawPacket& p) { p.set_uniforms = [] {}; }));
+    EXPECT_TRUE(differs([&](DrawPacket& p) { p.draw = [] {}; }));
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Core/Scheduler.hpp"
+#include "TestPch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <vector>
+
+TEST(Unit, Scheduler_runs_all_tasks) {
+    auto scheduler = std::move(Core::Scheduler::create(4).value());
+
+    std::vector<int> results(1000, 0);
+    for (size_t i = 0; i < results.size(); ++i) {
+        scheduler.add_task([&results, i]() { results[i] = static_cast<int>(i); });
+    }
+    scheduler.launch_threads();
+    scheduler.wait_for_threads();
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(results[i], static_cast<int>(i));
+    }
+}
+
+TEST(Unit, Scheduler_tasks_can_spawn_children) {
+    auto scheduler = std::move(Core::Scheduler::create(4).value());
+
+    std::atomic<int> leaves = 0;
+    for (int i = 0; i < 8; ++i) {
+        scheduler.add_task([&]() {
+            for (int j = 0; j < 100; ++j) {
+                scheduler.add_task([&]() {
+                    scheduler.add_task([&]() { leaves.fetch_add(1, std::memory_order_relaxed); });
+                });
+            }
+        });
+    }
+    scheduler.launch_threads();
+    scheduler.wait_for_threads();
+    EXPECT_EQ(leaves.load(), 800);
+
+    // reusable after waiting.
+    scheduler.add_task([&]() { leaves.fetch_add(1, std::memory_order_relaxed); });
+    scheduler.launch_threads();
+    scheduler.wait_for_threads();
+    EXPECT_EQ(leaves.load(), 801);
+}
+
+TEST(Unit, Scheduler_inline_task_owns_its_captures) {
+    auto counter = std::make_shared<int>(0);
+    {
+        Core::InlineTask task = [counter]() { ++(*counter); };
+        EXPECT_EQ(counter.use_count(), 2);
+
+        Core::InlineTask moved = std::move(task);
+        EXPECT_FALSE(task);
+        EXPECT_EQ(counter.use_count(), 2);
+
+        moved();
+        moved();
+        EXPECT_EQ(*counter, 2);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(Unit, Scheduler_parallel_for_visits_every_element_once) {
+    auto scheduler = std::move(Core::Scheduler::create(4).value());
+
+    std::vector<int> values(10'007, 0);
+    scheduler.parallel_for(values, 64, [](int& value) { ++value; });
+    EXPECT_TRUE(std::ranges::all_of(values, [](int value) { return value == 1; }));
+
+    // nested, from inside running tasks.
+    std::atomic<size_t> total = 0;
+    scheduler.parallel_for_chunks(16, 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            scheduler.parallel_for_chunks(1000, 100, [&](size_t a, size_t b) { total.fetch_add(b - a, std::memory_order_relaxed); });
+        }
+    });
+    EXPECT_EQ(total.load(), 16'000);
+}
+
+TEST(Unit, Scheduler_parallel_transform) {
+    auto scheduler = std::move(Core::Scheduler::create(4).value());
+
+    std::vector<int> input(5000);
+    std::iota(input.begin(), input.end(), 0);
+    std::vector<int> output(input.size(), -1);
+    scheduler.parallel_transform(input, output, 128, [](int value) { return value * 2; });
+
+    for (size_t i = 0; i < input.size(); ++i) {
+        EXPECT_EQ(output[i], input[i] * 2);
+    }
+}
+
+TEST(Unit, Scheduler_drains_higher_priorities_first) {
+    // Only the calling thread, so the order is deterministic.
+    auto scheduler = std::move(Core::Scheduler::create(0).value());
+
+    std::vector<Core::Scheduler::Priority> order;
+    for (auto priority : { Core::Scheduler::Priority::background, Core::Scheduler::Priority::normal, Core::Scheduler::Priority::critical }) {
+        for (int i = 0; i < 4; ++i) {
+            scheduler.add_task([&order, priority]() { order.push_back(priority); }, priority);
+        }
+    }
+    scheduler.launch_threads();
+    scheduler.wait_for_threads();
+
+    ASSERT_EQ(order.size(), 12);
+    EXPECT_TRUE(std::ranges::is_sorted(order));
+}
+
+TEST(Unit, Scheduler_background_waits_for_next_batch_past_deadline) {
+    auto scheduler = std::move(Core::Scheduler::create(2).value());
+
+    std::atomic<int> normal_runs = 0;
+    std::atomic<int> background_runs = 0;
+    scheduler.set_frame_deadline(std::chrono::steady_clock::now() - std::chrono::milliseconds(1));
+    for (int i = 0; i < 8; ++i) {
+        scheduler.add_task([&]() { background_runs.fetch_add(1); }, Core::Scheduler::Priority::background);
+        scheduler.add_task([&]() { normal_runs.fetch_add(1); });
+    }
+    scheduler.launch_threads();
+    scheduler.wait_for_threads();
+    EXPECT_EQ(normal_runs.load(), 8);
+    EXPECT_EQ(background_runs.load(), 0);
+
+    scheduler.clear_frame_deadline();
+    scheduler.launch_threads();
+    scheduler.wait_for_threads();
+    EXPECT_EQ(background_runs.load(), 8);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Core/Shader.hpp"
+#include "TestPch.hpp"
+
+#include <string>
+
+TEST(Unit, Shader_uniform_names_hash_the_same_at_compile_and_run_time) {
+    constexpr Core::UniformName name = "u_model_transfrom";
+    static_assert(name.hash == Core::uniform_name_hash("u_model_transfrom"));
+
+    // Built at run time, so the hash can't be folded.
+    std::string runtime_name = "u_model_";
+    runtime_name += "transfrom";
+    EXPECT_EQ(Core::uniform_name_hash(runtime_name), name.hash);
+    EXPECT_NE(Core::uniform_name_hash("u_colour"), name.hash);
+    EXPECT_EQ(name.name, "u_model_transfrom");
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Core/Std140.hpp"
+#include "TestPch.hpp"
+
+#include <array>
+#include <cstring>
+
+namespace UnitStd140 {
+    // Offsets worked out by hand from the std140 rules (GL 4.5 spec, 7.6.2.2), and the camera block FrameUniforms uses.
+    using Mixed = Core::Std140::Block<float, glm::vec2, glm::vec3, float, std::array<float, 2>, glm::mat3, int32_t>;
+    using Camera = Core::Std140::Block<glm::mat4, glm::mat4, glm::mat4, glm::vec3>;
+    using Nested = Core::Std140::Block<float, Core::Std140::Block<glm::vec2>, float>;
+
+    static_assert(Mixed::OFFSETS == std::array<size_t, 7> { 0, 8, 16, 28, 32, 64, 112 });
+    static_assert(Mixed::SIZE == 128);
+    static_assert(Camera::OFFSETS == std::array<size_t, 4> { 0, 64, 128, 192 });
+    static_assert(Camera::SIZE == 208);
+    static_assert(Nested::OFFSETS == std::array<size_t, 3> { 0, 16, 32 });
+    static_assert(Nested::SIZE == 48);
+
+    template <typename T>
+    inline auto read_at(std::span<const std::byte> bytes, size_t offset) -> T {
+        T value;
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        return value;
+    }
+}
+
+TEST(Unit, Std140_block_writes_members_at_their_offsets) {
+    using namespace UnitStd140;
+
+    Mixed block;
+    block.set<0>(1.0f);
+    block.set<2>(glm::vec3(2.0f, 3.0f, 4.0f));
+    block.set<3>(5.0f);
+    block.set<4>(std::array<float, 2> { 6.0f, 7.0f });
+    glm::mat3 m(1.0f);
+    m[2][1] = 8.0f;
+    block.set<5>(m);
+    block.set<6>(-9);
+
+    const auto bytes = block.bytes();
+    EXPECT_EQ(read_at<float>(bytes, 0), 1.0f);
+    EXPECT_EQ(read_at<float>(bytes, 16), 2.0f);
+    EXPECT_EQ(read_at<float>(bytes, 24), 4.0f);
+    // The scalar after a vec3 goes into its padding.
+    EXPECT_EQ(read_at<float>(bytes, 28), 5.0f);
+    // Array elements are padded out to 16 bytes.
+    EXPECT_EQ(read_at<float>(bytes, 32), 6.0f);
+    EXPECT_EQ(read_at<float>(bytes, 48), 7.0f);
+    // mat3 columns too.
+    EXPECT_EQ(read_at<float>(bytes, 64), 1.0f);
+    EXPECT_EQ(read_at<float>(bytes, 80 + 4), 1.0f);
+    EXPECT_EQ(read_at<float>(bytes, 96 + 4), 8.0f);
+    EXPECT_EQ(read_at<float>(bytes, 96 + 8), 1.0f);
+    EXPECT_EQ(read_at<float>(bytes, 76), 0.0f);
+    EXPECT_EQ(read_at<int32_t>(bytes, 112), -9);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Core/GlCommandQueue.hpp"
+#include "Core/Scheduler.hpp"
+#include "Core/Task.hpp"
+#include "TestPch.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace UnitTask {
+    inline auto square_later(Core::Scheduler& scheduler, int value) -> Core::Task<int> {
+        co_await Core::resume_on_workers(scheduler);
+        co_return value * value;
+    }
+
+    inline auto sum_of_squares(Core::Scheduler& scheduler, int count, std::atomic<int>& result) -> Core::Task<void> {
+        int sum = 0;
+        for (int i = 1; i <= count; ++i) {
+            sum += co_await square_later(scheduler, i);
+        }
+        result.store(sum);
+    }
+}
+
+TEST(Unit, Task_awaits_other_tasks) {
+    auto scheduler = std::move(Core::Scheduler::create(4).value());
+
+    std::atomic<int> result = 0;
+    Core::spawn(scheduler, UnitTask::sum_of_squares(scheduler, 10, result));
+    scheduler.launch_threads();
+    scheduler.wait_for_threads();
+    EXPECT_EQ(result.load(), 385);
+}
+
+TEST(Unit, Task_suspends_until_next_frame) {
+    auto scheduler = std::move(Core::Scheduler::create(2).value());
+
+    std::atomic<int> frames_seen = 0;
+    auto count_frames = [](Core::Scheduler& scheduler, std::atomic<int>& frames_seen) -> Core::Task<void> {
+        for (int i = 0; i < 3; ++i) {
+            frames_seen.fetch_add(1);
+            co_await Core::next_frame(scheduler);
+        }
+    };
+    Core::spawn(scheduler, count_frames(scheduler, frames_seen));
+
+    for (int frame = 1; frame <= 4; ++frame) {
+        scheduler.launch_threads();
+        scheduler.wait_for_threads();
+        EXPECT_EQ(frames_seen.load(), std::min(frame, 3));
+    }
+}
+
+TEST(Unit, Task_resumes_on_main_thread) {
+    auto scheduler = std::move(Core::Scheduler::create(2).value());
+
+    const auto main_thread_id = std::this_thread::get_id();
+    std::atomic<bool> ran_on_main_thread = false;
+    std::atomic<bool> finished = false;
+    auto upload = [&](Core::Scheduler& scheduler) -> Core::Task<void> {
+        co_await Core::resume_on_main_thread();
+        ran_on_main_thread.store(std::this_thread::get_id() == main_thread_id);
+        co_await Core::resume_on_workers(scheduler);
+        finished.store(true);
+    };
+    Core::spawn(scheduler, upload(scheduler));
+
+    scheduler.launch_threads();
+    scheduler.wait_for_threads();
+    EXPECT_FALSE(ran_on_main_thread.load());
+
+    Core::GlCommandQueue::instance().drain_all();
+    EXPECT_TRUE(ran_on_main_thread.load());
+
+    scheduler.launch_threads();
+    scheduler.wait_for_threads();
+    EXPECT_TRUE(finished.load());
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Core/TaskGraph.hpp"
+#include "TestPch.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+TEST(Unit, TaskGraph_respects_edges) {
+    auto scheduler = std::move(Core::Scheduler::create(4).value());
+
+    // input -> update -> { cull_a -> batch_a, cull_b -> batch_b } -> upload
+    std::mutex order_mutex;
+    std::vector<std::string_view> order;
+    auto record = [&](std::string_view name) {
+        std::scoped_lock lock(order_mutex);
+        order.push_back(name);
+    };
+    auto position_of = [&](std::string_view name) {
+        return std::distance(order.begin(), std::ranges::find(order, name));
+    };
+
+    Core::TaskGraph graph;
+    auto input = graph.add_node("input", [&]() { record("input"); });
+    auto update = graph.add_node("update", [&]() { record("update"); });
+    auto cull_a = graph.add_node("cull_a", [&]() { record("cull_a"); });
+    auto cull_b = graph.add_node("cull_b", [&]() { record("cull_b"); });
+    auto batch_a = graph.add_node("batch_a", [&]() { record("batch_a"); });
+    auto batch_b = graph.add_node("batch_b", [&]() { record("batch_b"); });
+    auto upload = graph.add_node("upload", [&]() { record("upload"); });
+
+    graph.add_edge(input, update);
+    graph.add_edge(update, cull_a);
+    graph.add_edge(update, cull_b);
+    graph.add_edge(cull_a, batch_a);
+    graph.add_edge(cull_b, batch_b);
+    graph.add_edge(batch_a, upload);
+    graph.add_edge(batch_b, upload);
+    EXPECT_FALSE(graph.compile().has_error());
+
+    for (int frame = 0; frame < 3; ++frame) {
+        order.clear();
+        EXPECT_FALSE(graph.execute(scheduler).has_error());
+
+        ASSERT_EQ(order.size(), graph.size());
+        EXPECT_LT(position_of("input"), position_of("update"));
+        EXPECT_LT(position_of("update"), position_of("cull_a"));
+        EXPECT_LT(position_of("update"), position_of("cull_b"));
+        EXPECT_LT(position_of("cull_a"), position_of("batch_a"));
+        EXPECT_LT(position_of("cull_b"), position_of("batch_b"));
+        EXPECT_LT(position_of("batch_a"), position_of("upload"));
+        EXPECT_LT(position_of("batch_b"), position_of("upload"));
+    }
+    EXPECT_EQ(graph.node_timings().size(), graph.size());
+}
+
+TEST(Unit, TaskGraph_detects_cycles) {
+    Core::TaskGraph graph;
+    auto a = graph.add_node("a", []() { });
+    auto b = graph.add_node("b", []() { });
+    auto c = graph.add_node("c", []() { });
+    graph.add_edge(a, b);
+    graph.add_edge(b, c);
+    graph.add_edge(c, b);
+    EXPECT_TRUE(graph.compile().has_error());
+}
+
+TEST(Unit, TaskGraph_execute_compiles_when_changed) {
+    auto scheduler = std::move(Core::Scheduler::create(2).value());
+
+    // Never compiled.
+    std::atomic<int> runs = 0;
+    Core::TaskGraph graph;
+    auto a = graph.add_node("a", [&]() { ++runs; });
+    auto b = graph.add_node("b", [&]() { ++runs; });
+    graph.add_edge(a, b);
+    EXPECT_FALSE(graph.execute(scheduler).has_error());
+    EXPECT_EQ(runs, 2);
+
+    // Changed since, and now has a cycle.
+    auto c = graph.add_node("c", [&]() { ++runs; });
+    graph.add_edge(b, c);
+    graph.add_edge(c, b);
+    EXPECT_TRUE(graph.execute(scheduler).has_error());
+    EXPECT_EQ(runs, 2);
+}
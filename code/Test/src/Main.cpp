@@ -1,9 +1,24 @@
 #include "TestPch.hpp"
 
 #include "Unit/UnitBenchDrawer.hpp"
+#include "Unit/UnitFrustumCuller.hpp"
+#include "Unit/UnitGlCommandQueue.hpp"
+#include "Unit/UnitGlState.hpp"
+#include "Unit/UnitGpuProfiler.hpp"
 #include "Unit/UnitModelStatic.hpp"
+#include "Unit/UnitProfiler.hpp"
+#include "Unit/UnitRenderQueue.hpp"
+#include "Unit/UnitScheduler.hpp"
+#include "Unit/UnitShader.hpp"
+#include "Unit/UnitStd140.hpp"
+#include "Unit/UnitTask.hpp"
+#include "Unit/UnitTaskGraph.hpp"
 #include "Integration/AssetLoading.hpp"
 #include "Integration/BasicApps.hpp"
+#include "Benchmark/BenchmarkScheduler.hpp"
+#include "Benchmark/BenchmarkParallelFor.hpp"
+#include "Benchmark/BenchmarkProfiler.hpp"
+#include "Benchmark/BenchmarkFrustumCuller.hpp"
 
 
 int main(int argc, char** argv) {
@@ -0,0 +1,268 @@
+#include "Profiler/TraceFormat.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Converts a binary trace from Profiler::save_as_binary_trace() or a binary stream.
+//  e.g.
+//      TraceConverter app_trace.gtrace app_trace.json
+//      TraceConverter app_trace.gtrace app_trace.perfetto-trace --perfetto
+namespace {
+    auto read_file(const std::filesystem::path& path) -> Utily::Result<std::vector<uint8_t>, Utily::Error> {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file) {
+            return Utily::Error("Unable to open \"" + path.string() + "\" for reading.");
+        }
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    auto to_chrome_json(const TraceFormat::Trace& trace) -> std::string {
+        std::string res { TraceFormat::CHROME_JSON_BEGIN };
+        for (const auto& event : trace.events) {
+            TraceFormat::append_chrome_json_event(res, event, trace.zones[event.zone_id], trace.processes[event.process_id]);
+        }
+        for (const auto& event : trace.counter_events) {
+            TraceFormat::append_chrome_json_counter(res, event, trace.counters[event.counter_id], trace.processes[event.process_id]);
+        }
+        if (res.ends_with(",\n")) {
+            res.resize(res.size() - 2);
+        }
+        res += TraceFormat::CHROME_JSON_END;
+        return res;
+    }
+
+    // Just enough of the protobuf wire format to write Perfetto's trace.proto, so the tool doesn't need libprotobuf.
+    namespace Proto {
+        enum class WireType : uint8_t {
+            varint = 0,
+            length_delimited = 2,
+        };
+
+        void write_key(std::string& out, uint32_t field, WireType type) {
+            TraceFormat::write_varint(out, (static_cast<uint64_t>(field) << 3) | static_cast<uint64_t>(type));
+        }
+        void write_uint(std::string& out, uint32_t field, uint64_t value) {
+            write_key(out, field, WireType::varint);
+            TraceFormat::write_varint(out, value);
+        }
+        void write_bytes(std::string& out, uint32_t field, std::string_view bytes) {
+            write_key(out, field, WireType::length_delimited);
+            TraceFormat::write_varint(out, bytes.size());
+            out.append(bytes);
+        }
+    }
+
+    // Field numbers from perfetto/protos/perfetto/trace/trace.proto and friends.
+    namespace Perfetto {
+        constexpr static uint32_t TRACE_PACKET = 1;
+
+        constexpr static uint32_t PACKET_TIMESTAMP = 8;
+        constexpr static uint32_t PACKET_TRUSTED_SEQUENCE_ID = 10;
+        constexpr static uint32_t PACKET_TRACK_EVENT = 11;
+        constexpr static uint32_t PACKET_TRACK_DESCRIPTOR = 60;
+
+        constexpr static uint32_t TRACK_UUID = 1;
+        constexpr static uint32_t TRACK_NAME = 2;
+        constexpr static uint32_t TRACK_PROCESS = 3;
+        constexpr static uint32_t TRACK_THREAD = 4;
+        constexpr static uint32_t TRACK_PARENT_UUID = 5;
+        constexpr static uint32_t TRACK_COUNTER = 8;
+
+        constexpr static uint32_t PROCESS_PID = 1;
+        constexpr static uint32_t PROCESS_NAME = 6;
+
+        constexpr static uint32_t THREAD_PID = 1;
+        constexpr static uint32_t THREAD_TID = 2;
+        constexpr static uint32_t THREAD_NAME = 5;
+
+        constexpr static uint32_t EVENT_DEBUG_ANNOTATIONS = 4;
+        constexpr static uint32_t EVENT_TYPE = 9;
+        constexpr static uint32_t EVENT_TRACK_UUID = 11;
+        constexpr static uint32_t EVENT_CATEGORIES = 22;
+        constexpr static uint32_t EVENT_NAME = 23;
+        constexpr static uint32_t EVENT_COUNTER_VALUE = 30;
+
+        constexpr static uint32_t ANNOTATION_UINT_VALUE = 3;
+        constexpr static uint32_t ANNOTATION_NAME = 10;
+
+        constexpr static uint64_t TYPE_SLICE_BEGIN = 1;
+        constexpr static uint64_t TYPE_SLICE_END = 2;
+        constexpr static uint64_t TYPE_COUNTER = 4;
+
+        constexpr static uint32_t SEQUENCE_ID = 1;
+    }
+
+    auto to_perfetto(const TraceFormat::Trace& trace) -> std::string {
+        auto pid_of = [](uint16_t process_id) -> uint64_t { return process_id + 1; };
+        // The GPU track wraps around to 0, which no thread uses.
+        auto tid_of = [](uint16_t process_id, uint16_t thread_index) -> uint64_t {
+            return (static_cast<uint64_t>(process_id + 1) << 16) | static_cast<uint16_t>(thread_index + 1u);
+        };
+        // Above any tid, counters get a track per process like Chrome's.
+        auto counter_uuid_of = [](uint16_t process_id, uint32_t counter_id) -> uint64_t {
+            return (uint64_t { 1 } << 48) | (static_cast<uint64_t>(process_id) << 32) | counter_id;
+        };
+
+        std::string res;
+        std::string packet;
+        std::string message;
+        std::string descriptor;
+        auto flush_packet = [&]() {
+            Proto::write_uint(packet, Perfetto::PACKET_TRUSTED_SEQUENCE_ID, Perfetto::SEQUENCE_ID);
+            Proto::write_bytes(res, Perfetto::TRACE_PACKET, packet);
+            packet.clear();
+        };
+
+        // Every process gets a track, with a child track per thread that recorded something in it.
+        for (uint16_t p = 0; p < trace.processes.size(); ++p) {
+            descriptor.clear();
+            Proto::write_uint(descriptor, Perfetto::PROCESS_PID, pid_of(p));
+            Proto::write_bytes(descriptor, Perfetto::PROCESS_NAME, trace.processes[p]);
+            message.clear();
+            Proto::write_uint(message, Perfetto::TRACK_UUID, pid_of(p));
+            Proto::write_bytes(message, Perfetto::TRACK_PROCESS, descriptor);
+            Proto::write_bytes(packet, Perfetto::PACKET_TRACK_DESCRIPTOR, message);
+            flush_packet();
+        }
+
+        // Slices on a track have to nest, so every event is split into a begin and an end and sorted by time.
+        // At equal times ends go before begins, the outer (longer) slice begins first and the inner one ends first.
+        struct Record {
+            int64_t timestamp;
+            int64_t other_timestamp;
+            uint64_t track_uuid;
+            const TraceFormat::Event* event;
+            bool is_begin;
+        };
+        std::vector<Record> records;
+        records.reserve(trace.events.size() * 2);
+        std::map<uint64_t, std::pair<uint16_t, uint16_t>> threads;
+        for (const auto& event : trace.events) {
+            const uint64_t track_uuid = tid_of(event.process_id, event.thread_index);
+            threads.emplace(track_uuid, std::pair { event.process_id, event.thread_index });
+            records.push_back({ event.start_ns, event.end_ns, track_uuid, &event, true });
+            records.push_back({ event.end_ns, event.start_ns, track_uuid, &event, false });
+        }
+        std::ranges::stable_sort(records, [](const Record& lhs, const Record& rhs) {
+            if (lhs.timestamp != rhs.timestamp) {
+                return lhs.timestamp < rhs.timestamp;
+            }
+            if (lhs.is_begin != rhs.is_begin) {
+                return !lhs.is_begin;
+            }
+            // begins: the later end is the outer slice. ends: the later start is the inner slice.
+            return lhs.other_timestamp > rhs.other_timestamp;
+        });
+
+        for (const auto& [track_uuid, ids] : threads) {
+            const auto [process_id, thread_index] = ids;
+            descriptor.clear();
+            Proto::write_uint(descriptor, Perfetto::THREAD_PID, pid_of(process_id));
+            Proto::write_uint(descriptor, Perfetto::THREAD_TID, track_uuid);
+            Proto::write_bytes(descriptor, Perfetto::THREAD_NAME, TraceFormat::thread_name(thread_index));
+            message.clear();
+            Proto::write_uint(message, Perfetto::TRACK_UUID, track_uuid);
+            Proto::write_bytes(message, Perfetto::TRACK_THREAD, descriptor);
+            Proto::write_bytes(packet, Perfetto::PACKET_TRACK_DESCRIPTOR, message);
+            flush_packet();
+        }
+
+        std::map<uint64_t, std::pair<uint16_t, uint32_t>> counter_tracks;
+        for (const auto& event : trace.counter_events) {
+            counter_tracks.emplace(counter_uuid_of(event.process_id, event.counter_id), std::pair { event.process_id, event.counter_id });
+        }
+        for (const auto& [track_uuid, ids] : counter_tracks) {
+            const auto [process_id, counter_id] = ids;
+            message.clear();
+            Proto::write_uint(message, Perfetto::TRACK_UUID, track_uuid);
+            Proto::write_bytes(message, Perfetto::TRACK_NAME, trace.counters[counter_id].name);
+            Proto::write_uint(message, Perfetto::TRACK_PARENT_UUID, pid_of(process_id));
+            Proto::write_bytes(message, Perfetto::TRACK_COUNTER, "");
+            Proto::write_bytes(packet, Perfetto::PACKET_TRACK_DESCRIPTOR, message);
+            flush_packet();
+        }
+        for (const auto& event : trace.counter_events) {
+            message.clear();
+            Proto::write_uint(message, Perfetto::EVENT_TYPE, Perfetto::TYPE_COUNTER);
+            Proto::write_uint(message, Perfetto::EVENT_TRACK_UUID, counter_uuid_of(event.process_id, event.counter_id));
+            Proto::write_uint(message, Perfetto::EVENT_COUNTER_VALUE, static_cast<uint64_t>(event.value));
+            Proto::write_uint(packet, Perfetto::PACKET_TIMESTAMP, static_cast<uint64_t>(std::max<int64_t>(event.time_ns, 0)));
+            Proto::write_bytes(packet, Perfetto::PACKET_TRACK_EVENT, message);
+            flush_packet();
+        }
+
+        std::string annotation;
+        auto write_annotation = [&](std::string_view name, uint64_t value) {
+            annotation.clear();
+            Proto::write_bytes(annotation, Perfetto::ANNOTATION_NAME, name);
+            Proto::write_uint(annotation, Perfetto::ANNOTATION_UINT_VALUE, value);
+            Proto::write_bytes(message, Perfetto::EVENT_DEBUG_ANNOTATIONS, annotation);
+        };
+        for (const auto& record : records) {
+            message.clear();
+            Proto::write_uint(message, Perfetto::EVENT_TRACK_UUID, record.track_uuid);
+            if (record.is_begin) {
+                const auto& zone = trace.zones[record.event->zone_id];
+                Proto::write_uint(message, Perfetto::EVENT_TYPE, Perfetto::TYPE_SLICE_BEGIN);
+                Proto::write_bytes(message, Perfetto::EVENT_NAME, zone.name);
+                if (zone.category.size()) {
+                    Proto::write_bytes(message, Perfetto::EVENT_CATEGORIES, zone.category);
+                }
+                if (record.event->allocations) {
+                    write_annotation("allocations", record.event->allocations);
+                    write_annotation("allocated_bytes", record.event->allocated_bytes);
+                }
+            } else {
+                Proto::write_uint(message, Perfetto::EVENT_TYPE, Perfetto::TYPE_SLICE_END);
+            }
+            Proto::write_uint(packet, Perfetto::PACKET_TIMESTAMP, static_cast<uint64_t>(std::max<int64_t>(record.timestamp, 0)));
+            Proto::write_bytes(packet, Perfetto::PACKET_TRACK_EVENT, message);
+            flush_packet();
+        }
+        return res;
+    }
+
+    auto convert(const std::filesystem::path& input, const std::filesystem::path& output, bool is_perfetto) -> Utily::Result<void, Utily::Error> {
+        auto bytes = read_file(input);
+        if (bytes.has_error()) {
+            return bytes.error();
+        }
+        auto trace = TraceFormat::decode(bytes.value());
+        if (trace.has_error()) {
+            return trace.error();
+        }
+
+        const auto contents = is_perfetto ? to_perfetto(trace.value()) : to_chrome_json(trace.value());
+        std::ofstream file(output, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file) {
+            return Utily::Error("Unable to open \"" + output.string() + "\" for writing.");
+        }
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        return {};
+    }
+}
+
+auto main(int argc, char** argv) -> int {
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    const bool is_perfetto = std::erase(args, "--perfetto") > 0;
+    if (args.size() != 2) {
+        std::cerr << "usage: TraceConverter <trace" << TraceFormat::FILE_EXTENSION << "> <output> [--perfetto]\n"
+                  << "  Writes Chrome trace-event JSON, or a Perfetto protobuf trace with --perfetto.\n";
+        return 1;
+    }
+
+    if (auto result = convert(args[0], args[1], is_perfetto); result.has_error()) {
+        std::cerr << result.error().what() << '\n';
+        return 1;
+    }
+    return 0;
+}